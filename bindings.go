@@ -41,7 +41,7 @@ func (db *Reindexer) modifyItem(namespace string, ns *reindexerNamespace, item i
 	defer out.Free()
 
 	rdSer := newSerializer(out.GetBuf())
-	rawQueryParams := rdSer.readRawQueryParams(func(nsid int) {
+	rawQueryParams := rdSer.readRawQueryParams(false, func(nsid int) {
 		ns.cjsonState.ReadPayloadType(&rdSer.Serializer)
 	})
 
@@ -191,10 +191,10 @@ func unpackItem(ns nsArrayEntry, params rawResultItemParams, allowUnsafe bool, n
 	return
 }
 
-func (db *Reindexer) rawResultToJson(rawResult []byte, jsonName string, totalName string, initJson []byte, initOffsets []int) (json []byte, offsets []int, err error) {
+func (db *Reindexer) rawResultToJson(rawResult []byte, withExplain bool, jsonName string, totalName string, initJson []byte, initOffsets []int) (json []byte, offsets []int, err error) {
 
 	ser := newSerializer(rawResult)
-	rawQueryParams := ser.readRawQueryParams()
+	rawQueryParams := ser.readRawQueryParams(withExplain)
 
 	jsonReserveLen := len(rawResult) + len(totalName) + len(jsonName) + 20
 	if cap(initJson) < jsonReserveLen {
@@ -282,7 +282,7 @@ func (db *Reindexer) prepareQuery(q *Query, asJson bool) (result bindings.RawBuf
 		// json iterator not support fetch queries
 		fetchCount = -1
 	}
-	result, err = db.binding.SelectQuery(ser.Bytes(), asJson, ptVersions, fetchCount)
+	result, err = db.binding.SelectQuery(ser.Bytes(), asJson, q.explain, ptVersions, fetchCount)
 
 	if err == nil && result.GetBuf() == nil {
 		panic(fmt.Errorf("result.Buffer is nil"))
@@ -306,7 +306,7 @@ func (db *Reindexer) execJSONQuery(q *Query, jsonRoot string) *JSONIterator {
 		return errJSONIterator(err)
 	}
 	defer result.Free()
-	q.json, q.jsonOffsets, err = db.rawResultToJson(result.GetBuf(), jsonRoot, q.totalName, q.json, q.jsonOffsets)
+	q.json, q.jsonOffsets, err = db.rawResultToJson(result.GetBuf(), q.explain, jsonRoot, q.totalName, q.json, q.jsonOffsets)
 	if err != nil {
 		return errJSONIterator(err)
 	}
@@ -328,7 +328,12 @@ func (db *Reindexer) prepareSQL(namespace, query string, asJson bool) (result bi
 		ptVersions = append(ptVersions, ns.localCjsonState.Version^ns.localCjsonState.CacheToken)
 	}
 
-	result, err = db.binding.Select(query, asJson, ptVersions, defaultFetchCount)
+	fetchCount := defaultFetchCount
+	if asJson {
+		// json iterator not support fetch queries
+		fetchCount = -1
+	}
+	result, err = db.binding.Select(query, asJson, ptVersions, fetchCount)
 	return
 }
 
@@ -347,7 +352,7 @@ func (db *Reindexer) execSQLAsJSON(namespace string, query string) *JSONIterator
 		return errJSONIterator(err)
 	}
 	defer result.Free()
-	json, jsonOffsets, err := db.rawResultToJson(result.GetBuf(), namespace, "total", nil, nil)
+	json, jsonOffsets, err := db.rawResultToJson(result.GetBuf(), true, namespace, "total", nil, nil)
 	if err != nil {
 		return errJSONIterator(err)
 	}
@@ -370,7 +375,7 @@ func (db *Reindexer) deleteQuery(q *Query) (int, error) {
 
 	ser := newSerializer(result.GetBuf())
 	// skip total count
-	rawQueryParams := ser.readRawQueryParams()
+	rawQueryParams := ser.readRawQueryParams(false)
 
 	ns.cacheLock.Lock()
 	for i := 0; i < rawQueryParams.count; i++ {
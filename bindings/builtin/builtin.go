@@ -51,6 +51,16 @@ func (buf *RawCBuffer) GetBuf() []byte {
 	return buf2go(buf.cbuf)
 }
 
+// Fetch serializes next chunk of query results to buffer. Query results are kept in C until buffer is freed
+func (buf *RawCBuffer) Fetch(offset, limit int, withItems bool) error {
+	ret := C.reindexer_fetch_results(buf.cbuf, C.int(offset), C.int(limit), bool2cint(withItems))
+	if err := err2go(ret.err); err != nil {
+		return err
+	}
+	buf.cbuf = ret.out
+	return nil
+}
+
 func newRawCBuffer() *RawCBuffer {
 	obj := bufPool.Get()
 	if obj != nil {
@@ -79,7 +89,7 @@ func err2go(ret C.reindexer_error) error {
 func ret2go(ret C.reindexer_ret) (*RawCBuffer, error) {
 	if ret.err.what != nil {
 		defer C.free(unsafe.Pointer(ret.err.what))
-		defer C.free(unsafe.Pointer(uintptr(ret.out.data)))
+		defer C.reindexer_free_buffer(ret.out)
 		return nil, errors.New("rq:" + C.GoString(ret.err.what))
 	}
 
@@ -202,13 +212,14 @@ func (binding *Builtin) GetMeta(namespace, key string) (bindings.RawBuffer, erro
 func (binding *Builtin) Select(query string, withItems bool, ptVersions []int32, fetchCount int) (bindings.RawBuffer, error) {
 	binding.cgoLimiter <- struct{}{}
 	defer func() { <-binding.cgoLimiter }()
-	return ret2go(C.reindexer_select(str2c(query), bool2cint(withItems), (*C.int32_t)(unsafe.Pointer(&ptVersions[0])), C.int(len(ptVersions))))
+	return ret2go(C.reindexer_select(str2c(query), bool2cint(withItems), (*C.int32_t)(unsafe.Pointer(&ptVersions[0])), C.int(len(ptVersions)), C.int(fetchCount)))
 }
 
-func (binding *Builtin) SelectQuery(data []byte, withItems bool, ptVersions []int32, fetchCount int) (bindings.RawBuffer, error) {
+// SelectQuery - explain is not passed to C, since plan is returned according to explain flag of deserialized query
+func (binding *Builtin) SelectQuery(data []byte, withItems bool, explain bool, ptVersions []int32, fetchCount int) (bindings.RawBuffer, error) {
 	binding.cgoLimiter <- struct{}{}
 	defer func() { <-binding.cgoLimiter }()
-	return ret2go(C.reindexer_select_query(buf2c(data), bool2cint(withItems), (*C.int32_t)(unsafe.Pointer(&ptVersions[0])), C.int(len(ptVersions))))
+	return ret2go(C.reindexer_select_query(buf2c(data), bool2cint(withItems), (*C.int32_t)(unsafe.Pointer(&ptVersions[0])), C.int(len(ptVersions)), C.int(fetchCount)))
 }
 
 func (binding *Builtin) DeleteQuery(nsHash int, data []byte) (bindings.RawBuffer, error) {
@@ -277,6 +288,7 @@ func (bf *bufFreeBatcher) loop() {
 
 		for _, buf := range bf.bufs2 {
 			buf.cbuf.data = 0
+			buf.cbuf.results_ptr = 0
 			bf.toPool(buf)
 		}
 		bf.cbufs = bf.cbufs[:0]
@@ -285,7 +297,7 @@ func (bf *bufFreeBatcher) loop() {
 }
 
 func (bf *bufFreeBatcher) add(buf *RawCBuffer) {
-	if buf.cbuf.data != 0 {
+	if buf.cbuf.results_ptr != 0 {
 		bf.toFree(buf)
 	} else {
 		bf.toPool(buf)
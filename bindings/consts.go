@@ -20,8 +20,12 @@ const (
 	INFO    = 3
 	TRACE   = 4
 
-	AggSum = 0
-	AggAvg = 1
+	AggSum           = 0
+	AggAvg           = 1
+	AggFacet         = 2
+	AggMin           = 3
+	AggMax           = 4
+	AggCountDistinct = 5
 
 	CollateNone    = 0
 	CollateASCII   = 1
@@ -42,18 +46,23 @@ const (
 	ValueDouble    = 3
 	ValueComposite = 6
 
-	QueryCondition      = 0
-	QueryDistinct       = 1
-	QuerySortIndex      = 2
-	QueryJoinOn         = 3
-	QueryLimit          = 4
-	QueryOffset         = 5
-	QueryReqTotal       = 6
-	QueryDebugLevel     = 7
-	QueryAggregation    = 8
-	QuerySelectFilter   = 9
-	QuerySelectFunction = 10
-	QueryEnd            = 11
+	QueryCondition        = 0
+	QueryDistinct         = 1
+	QuerySortIndex        = 2
+	QueryJoinOn           = 3
+	QueryLimit            = 4
+	QueryOffset           = 5
+	QueryReqTotal         = 6
+	QueryDebugLevel       = 7
+	QueryAggregation      = 8
+	QuerySelectFilter     = 9
+	QuerySelectFunction   = 10
+	QueryEnd              = 11
+	QueryJoinStrategy     = 12
+	QueryParallelism      = 13
+	QueryAggregationLimit = 14
+	QueryExplain          = 15
+	QueryUpdateField      = 16
 
 	LeftJoin    = 0
 	InnerJoin   = 1
@@ -81,6 +90,8 @@ const (
 	ResultsWithCJson        = 2
 	ResultsWithJson         = 3
 	ResultsWithPayloadTypes = 8
+	ResultsWithAggJson      = 16
+	ResultsWithExplain      = 32
 
 	IndexOptPK         = 1 << 7
 	IndexOptArray      = 1 << 6
@@ -10,6 +10,7 @@ import (
 	"sync/atomic"
 	"time"
 
+	"github.com/golang/snappy"
 	"github.com/restream/reindexer/cjson"
 )
 
@@ -22,6 +23,21 @@ const cprotoMagic = 0xEEDD1132
 const cprotoVersion = 0x100
 const cprotoHdrLen = 20
 
+// Payload of frame is compressed by snappy. Frames are compressed only after compression is negotiated at login
+const cprotoCompressedFlag = 0x1
+
+// Set by server in login reply, if client has requested compression and server supports it
+const cprotoCompressionSupportFlag = 0x2
+
+// Client requests compression by passing this value as extra login argument. Old servers ignore extra arguments
+const cprotoCompressionSnappy = "snappy"
+
+// Frames (and uncompressed payloads) larger than this are treated as corrupted
+const cprotoMaxFrameSize = 0x10000000
+
+// Payloads smaller than this are not worth to compress
+const cprotoMinCompressSize = 1024
+
 const (
 	cmdPing           = 0
 	cmdLogin          = 1
@@ -57,6 +73,10 @@ type connection struct {
 
 	rdBuf *bufio.Reader
 	repl  [queueSize]sig
+	// Buffer for compressed payloads, used by readLoop
+	zbuf []byte
+	// Nonzero, if server has confirmed compression support in login reply
+	compression int32
 
 	seqs chan int
 	lock sync.RWMutex
@@ -114,7 +134,12 @@ func (c *connection) login(owner *NetCProto) (err error) {
 		path = path[1:]
 	}
 
-	buf, err := c.rpcCall(cmdLogin, username, password, path)
+	var buf *NetBuffer
+	if owner.compression {
+		buf, err = c.rpcCall(cmdLogin, username, password, path, cprotoCompressionSnappy)
+	} else {
+		buf, err = c.rpcCall(cmdLogin, username, password, path)
+	}
 	if err != nil {
 		c.err = err
 		return
@@ -146,8 +171,10 @@ func (c *connection) readReply(hdr []byte) (err error) {
 	ser := cjson.NewSerializer(hdr)
 	magic := ser.GetUInt32()
 	version := ser.GetUInt32()
+	flags := version >> 16
+	version &= 0xFFFF
 	size := int(ser.GetUInt32())
-	_ = int(ser.GetUInt32())
+	rcmd := int(ser.GetUInt32())
 	rseq := int32(ser.GetUInt32())
 	if magic != cprotoMagic {
 		return fmt.Errorf("Invalid cproto magic '%08X'", magic)
@@ -157,12 +184,41 @@ func (c *connection) readReply(hdr []byte) (err error) {
 		return fmt.Errorf("Invalid version '%08X'", version)
 	}
 
+	if size > cprotoMaxFrameSize {
+		return fmt.Errorf("Too large cproto frame '%d'", size)
+	}
+
+	if rcmd == cmdLogin && c.owner.compression && flags&cprotoCompressionSupportFlag != 0 {
+		atomic.StoreInt32(&c.compression, 1)
+	}
+
 	repCh := c.repl[rseq]
 	answ := newNetBuffer()
-	answ.reset(size, c)
 
-	if _, err = io.ReadFull(c.rdBuf, answ.buf); err != nil {
-		return
+	if flags&cprotoCompressedFlag != 0 {
+		if cap(c.zbuf) < size {
+			c.zbuf = make([]byte, size)
+		}
+		c.zbuf = c.zbuf[:size]
+		if _, err = io.ReadFull(c.rdBuf, c.zbuf); err != nil {
+			return
+		}
+		var dsize int
+		if dsize, err = snappy.DecodedLen(c.zbuf); err != nil {
+			return
+		}
+		if dsize > cprotoMaxFrameSize {
+			return fmt.Errorf("Too large uncompressed cproto frame '%d'", dsize)
+		}
+		answ.reset(dsize, c)
+		if answ.buf, err = snappy.Decode(answ.buf, c.zbuf); err != nil {
+			return
+		}
+	} else {
+		answ.reset(size, c)
+		if _, err = io.ReadFull(c.rdBuf, answ.buf); err != nil {
+			return
+		}
 	}
 
 	if repCh != nil {
@@ -231,7 +287,11 @@ func (c *connection) rpcCall(cmd int, args ...interface{}) (buf *NetBuffer, err
 		}
 	}
 
-	c.write(in.ser.Bytes())
+	if atomic.LoadInt32(&c.compression) != 0 {
+		c.write(compressFrame(in.ser.Bytes()))
+	} else {
+		c.write(in.ser.Bytes())
+	}
 	in.ser.Close()
 
 	select {
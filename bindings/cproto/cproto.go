@@ -30,6 +30,7 @@ type NetCProto struct {
 	onChangeCallback func()
 	serverStartTime  int64
 	retryAttempts    bindings.OptionRetryAttempts
+	compression      bool
 }
 
 func (binding *NetCProto) Init(u *url.URL, options ...interface{}) (err error) {
@@ -53,6 +54,14 @@ func (binding *NetCProto) Init(u *url.URL, options ...interface{}) (err error) {
 		binding.retryAttempts.Write = 0
 	}
 
+	switch c := u.Query().Get("compression"); c {
+	case "snappy":
+		binding.compression = true
+	case "", "none":
+	default:
+		return fmt.Errorf("Unsupported cproto compression '%s'", c)
+	}
+
 	binding.url = *u
 	binding.pool = make(chan *connection, connPoolSize)
 	for i := 0; i < connPoolSize; i++ {
@@ -194,7 +203,8 @@ func (binding *NetCProto) GetMeta(namespace, key string) (bindings.RawBuffer, er
 }
 
 func (binding *NetCProto) Select(query string, withItems bool, ptVersions []int32, fetchCount int) (bindings.RawBuffer, error) {
-	flags := 0
+	// SQL query may be explained, so plan of query is always requested
+	flags := bindings.ResultsWithAggJson | bindings.ResultsWithExplain
 	if withItems {
 		flags |= bindings.ResultsWithJson
 	} else {
@@ -213,11 +223,15 @@ func (binding *NetCProto) Select(query string, withItems bool, ptVersions []int3
 	buf.result = buf.args[0].([]byte)
 	buf.reqID = buf.args[1].(int)
 	buf.needClose = buf.reqID != -1
+	buf.explain = flags&bindings.ResultsWithExplain != 0
 	return buf, nil
 }
 
-func (binding *NetCProto) SelectQuery(data []byte, withItems bool, ptVersions []int32, fetchCount int) (bindings.RawBuffer, error) {
-	flags := 0
+func (binding *NetCProto) SelectQuery(data []byte, withItems bool, explain bool, ptVersions []int32, fetchCount int) (bindings.RawBuffer, error) {
+	flags := bindings.ResultsWithAggJson
+	if explain {
+		flags |= bindings.ResultsWithExplain
+	}
 	if withItems {
 		flags |= bindings.ResultsWithJson
 	} else {
@@ -236,6 +250,7 @@ func (binding *NetCProto) SelectQuery(data []byte, withItems bool, ptVersions []
 	buf.result = buf.args[0].([]byte)
 	buf.reqID = buf.args[1].(int)
 	buf.needClose = buf.reqID != -1
+	buf.explain = flags&bindings.ResultsWithExplain != 0
 	return buf, nil
 }
 
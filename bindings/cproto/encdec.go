@@ -4,6 +4,7 @@ import (
 	"fmt"
 	"unsafe"
 
+	"github.com/golang/snappy"
 	"github.com/restream/reindexer/bindings"
 
 	"github.com/restream/reindexer/cjson"
@@ -25,6 +26,7 @@ func newRPCEncoder(cmd int, seq int) rpcEncoder {
 
 func (r *rpcEncoder) start(cmd int, seq int) {
 	r.ser.PutUInt32(cprotoMagic)
+	// version in low 16 bits, flags in high 16 bits
 	r.ser.PutUInt32(cprotoVersion)
 	r.ser.PutUInt32(1) // len
 	r.ser.PutUInt32(uint32(cmd))
@@ -74,6 +76,23 @@ func (r *rpcEncoder) update() {
 	*(*uint32)(unsafe.Pointer(&r.ser.Bytes()[8])) = uint32(len(r.ser.Bytes()) - cprotoHdrLen)
 }
 
+// compressFrame returns copy of frame with payload compressed by snappy, or frame itself, if compression is not worth
+func compressFrame(frame []byte) []byte {
+	payload := frame[cprotoHdrLen:]
+	if len(payload) < cprotoMinCompressSize {
+		return frame
+	}
+	zframe := make([]byte, cprotoHdrLen+snappy.MaxEncodedLen(len(payload)))
+	zpayload := snappy.Encode(zframe[cprotoHdrLen:], payload)
+	if len(zpayload) >= len(payload) {
+		return frame
+	}
+	copy(zframe, frame[:cprotoHdrLen])
+	*(*uint16)(unsafe.Pointer(&zframe[6])) = cprotoCompressedFlag
+	*(*uint32)(unsafe.Pointer(&zframe[8])) = uint32(len(zpayload))
+	return zframe[:cprotoHdrLen+len(zpayload)]
+}
+
 func newRPCDecoder(buf []byte) rpcDecoder {
 	return rpcDecoder{ser: cjson.NewSerializer(buf)}
 }
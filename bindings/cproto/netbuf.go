@@ -17,10 +17,15 @@ type NetBuffer struct {
 	args      []interface{}
 	closed    bool
 	needClose bool
+	// Plan of query is requested by select, so it's read with each chunk of results
+	explain bool
 }
 
 func (buf *NetBuffer) Fetch(offset, limit int, withItems bool) (err error) {
-	flags := 0
+	flags := bindings.ResultsWithAggJson
+	if buf.explain {
+		flags |= bindings.ResultsWithExplain
+	}
 	if withItems {
 		flags |= bindings.ResultsWithJson
 	} else {
@@ -67,6 +72,7 @@ func (buf *NetBuffer) reset(size int, conn *connection) {
 	buf.conn = conn
 	buf.closed = false
 	buf.needClose = false
+	buf.explain = false
 }
 
 func (buf *NetBuffer) parseArgs() (err error) {
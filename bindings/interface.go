@@ -99,7 +99,7 @@ type RawBuffer interface {
 	Free()
 }
 
-// FetchMore interface for partial loading results (used in cproto)
+// FetchMore interface for partial loading results (used in cproto and builtin)
 type FetchMore interface {
 	Fetch(offset, limit int, withItems bool) (err error)
 }
@@ -157,7 +157,7 @@ type RawBinding interface {
 	GetMeta(namespace, key string) (RawBuffer, error)
 	ModifyItem(nsHash int, data []byte, mode int) (RawBuffer, error)
 	Select(query string, withItems bool, ptVersions []int32, fetchCount int) (RawBuffer, error)
-	SelectQuery(rawQuery []byte, withItems bool, ptVersions []int32, fetchCount int) (RawBuffer, error)
+	SelectQuery(rawQuery []byte, withItems bool, explain bool, ptVersions []int32, fetchCount int) (RawBuffer, error)
 	DeleteQuery(nsHash int, rawQuery []byte) (RawBuffer, error)
 	Commit(namespace string) error
 	EnableLogger(logger Logger)
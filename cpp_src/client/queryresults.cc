@@ -19,15 +19,16 @@ QueryResults &QueryResults::operator=(QueryResults &&obj) noexcept {
 		queryParams_ = std::move(obj.queryParams_);
 		fetchOffset_ = std::move(obj.fetchOffset_);
 		queryID_ = std::move(obj.queryID_);
+		fetchFlags_ = std::move(obj.fetchFlags_);
 	}
 	return *this;
 }
 
-QueryResults::QueryResults(net::cproto::ClientConnection *conn, const NSArray &nsArray, string_view rawResult, int queryID)
-	: conn_(conn), nsArray_(nsArray), queryID_(queryID), fetchOffset_(0) {
+QueryResults::QueryResults(net::cproto::ClientConnection *conn, const NSArray &nsArray, string_view rawResult, int queryID, int fetchFlags)
+	: conn_(conn), nsArray_(nsArray), queryID_(queryID), fetchOffset_(0), fetchFlags_(fetchFlags & ~kResultsWithPayloadTypes) {
 	ResultSerializer ser(rawResult);
 
-	queryParams_ = ser.GetRawQueryParams([&](int nsIdx) {
+	queryParams_ = ser.GetRawQueryParams(fetchFlags, [&](int nsIdx) {
 		uint32_t cacheToken = ser.GetVarUint();
 		int version = ser.GetVarUint();
 
@@ -49,7 +50,7 @@ QueryResults::QueryResults(net::cproto::ClientConnection *conn, const NSArray &n
 }
 
 Error QueryResults::fetchNextResults() {
-	auto ret = conn_->Call(cproto::kCmdFetchResults, queryID_, kResultsWithCJson, queryParams_.count + fetchOffset_, 100, int64_t(-1));
+	auto ret = conn_->Call(cproto::kCmdFetchResults, queryID_, fetchFlags_, queryParams_.count + fetchOffset_, 100, int64_t(-1));
 	if (!ret.Status().ok()) {
 		return ret.Status();
 	}
@@ -62,7 +63,7 @@ Error QueryResults::fetchNextResults() {
 	string_view rawResult = p_string(ret.GetArgs()[0]);
 	ResultSerializer ser(rawResult);
 
-	queryParams_ = ser.GetRawQueryParams(nullptr);
+	queryParams_ = ser.GetRawQueryParams(fetchFlags_, nullptr);
 
 	rawResult = rawResult.substr(ser.Pos());
 	rawResult_ = string(rawResult.data(), rawResult.size());
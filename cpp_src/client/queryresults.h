@@ -47,7 +47,7 @@ public:
 
 private:
 	friend class RPCClient;
-	QueryResults(net::cproto::ClientConnection *conn, const NSArray &nsArray, string_view rawResult, int queryID);
+	QueryResults(net::cproto::ClientConnection *conn, const NSArray &nsArray, string_view rawResult, int queryID, int fetchFlags);
 	Error fetchNextResults();
 
 	net::cproto::ClientConnection *conn_;
@@ -56,6 +56,8 @@ private:
 	string rawResult_;
 	int queryID_;
 	int fetchOffset_;
+	// Flags of select, which are used to fetch and to read next results
+	int fetchFlags_;
 
 	ResultSerializer::QueryParams queryParams_;
 };
@@ -16,6 +16,7 @@ Error Reindexer::Insert(const string& nsName, Item& item) { return impl_->Insert
 Error Reindexer::Update(const string& nsName, Item& item) { return impl_->Update(nsName, item); }
 Error Reindexer::Upsert(const string& nsName, Item& item) { return impl_->Upsert(nsName, item); }
 Error Reindexer::Delete(const string& nsName, Item& item) { return impl_->Delete(nsName, item); }
+Error Reindexer::ModifyItems(const string& nsName, vector<Item>& items, int mode) { return impl_->ModifyItems(nsName, items, mode); }
 Item Reindexer::NewItem(const string& nsName) { return impl_->NewItem(nsName); }
 Error Reindexer::GetMeta(const string& nsName, const string& key, string& data) { return impl_->GetMeta(nsName, key, data); }
 Error Reindexer::PutMeta(const string& nsName, const string& key, const string_view& data) { return impl_->PutMeta(nsName, key, data); }
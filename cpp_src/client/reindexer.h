@@ -29,6 +29,7 @@ public:
 
 	/// Connect - connect to reindexer server
 	/// @param dsn - uri of server and database, like: `cproto://user@password:127.0.0.1:6534/dbname`
+	/// Optional `?compression=snappy` enables compression of frames, which is worth on slow links
 	Error Connect(const string &dsn);
 
 	/// Open or create namespace
@@ -82,6 +83,11 @@ public:
 	/// @param nsName - Name of namespace
 	/// @param item - Item, obtained by call to NewItem of the same namespace
 	Error Delete(const string &nsName, Item &item);
+	/// Insert, update, upsert or delete batch of items. Batch is sent to server by single call, and applied under single lock
+	/// @param nsName - Name of namespace
+	/// @param items - Items, obtained by call to NewItem of the same namespace
+	/// @param mode - One of ModeInsert, ModeUpdate, ModeUpsert or ModeDelete
+	Error ModifyItems(const string &nsName, vector<Item> &items, int mode);
 	/// Delete all items froms namespace, which matches provided Query
 	/// @param query - Query with conditions
 	/// @param result - QueryResults with IDs of deleted items
@@ -3,7 +3,7 @@
 namespace reindexer {
 namespace client {
 
-ResultSerializer::QueryParams ResultSerializer::GetRawQueryParams(std::function<void(int nsId)> updatePayloadFunc) {
+ResultSerializer::QueryParams ResultSerializer::GetRawQueryParams(int flags, std::function<void(int nsId)> updatePayloadFunc) {
 	(void)updatePayloadFunc;
 	QueryParams ret;
 
@@ -29,8 +29,9 @@ ResultSerializer::QueryParams ResultSerializer::GetRawQueryParams(std::function<
 	int aggResCount = GetVarUint();
 
 	for (int i = 0; i < aggResCount; i++) {
-		ret.aggResults.push_back(GetDouble());
+		ret.aggResults.push_back(GetSlice().ToString());
 	}
+	if (flags & kResultsWithExplain) ret.explainResults = GetSlice().ToString();
 
 	return ret;
 }
@@ -22,10 +22,12 @@ public:
 		bool haveProcent;
 		bool nonCacheableData;
 		bool nsCount;
-		h_vector<double, 4> aggResults;
+		// JSON of aggregation results and of explained query plan
+		h_vector<string, 4> aggResults;
+		string explainResults;
 	};
 
-	QueryParams GetRawQueryParams(std::function<void(int nsId)> updatePayloadFunc);
+	QueryParams GetRawQueryParams(int flags, std::function<void(int nsId)> updatePayloadFunc);
 	ItemParams GetItemParams();
 };
 }  // namespace client
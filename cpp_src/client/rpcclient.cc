@@ -4,6 +4,7 @@
 #include "core/namespacedef.h"
 #include "gason/gason.h"
 #include "tools/errors.h"
+#include "tools/stringstools.h"
 
 using std::string;
 using std::vector;
@@ -32,6 +33,16 @@ Error RPCClient::Connect(const string& dsn) {
 		return Error(errParams, "Scheme must be cproto");
 	}
 
+	enableCompression_ = false;
+	vector<string> params;
+	for (auto& param : split(uri_.query(), "&", true, params)) {
+		if (param == "compression=snappy") {
+			enableCompression_ = true;
+		} else if (param.compare(0, 12, "compression=") == 0 && param != "compression=none") {
+			return Error(errParams, "Unsupported compression '%s'", param.substr(12).c_str());
+		}
+	}
+
 	curConnIdx_ = -1;
 	worker_ = std::thread([&]() { this->run(); });
 
@@ -77,7 +88,7 @@ void RPCClient::checkConnections() {
 			string dbName = uri_.path();
 			if (dbName[0] == '/') dbName = dbName.substr(1);
 
-			c->Connect(uri_.hostname() + ":" + port, uri_.username(), uri_.password(), dbName);
+			c->Connect(uri_.hostname() + ":" + port, uri_.username(), uri_.password(), dbName, enableCompression_);
 		}
 	}
 }
@@ -127,7 +138,32 @@ Error RPCClient::modifyItem(const string& ns, Item& item, int mode) {
 			return Error(errParams, "Server returned %d args, but expected %d", int(ret.GetArgs().size()), 1);
 		}
 		NSArray nsArray{getNamespace(ns)};
-		QueryResults(conn, nsArray, p_string(ret.GetArgs()[0]), int(ret.GetArgs()[1]));
+		QueryResults(conn, nsArray, p_string(ret.GetArgs()[0]), int(ret.GetArgs()[1]), kResultsPure);
+	}
+	return ret.Status();
+}
+
+Error RPCClient::ModifyItems(const string& ns, vector<Item>& items, int mode) {
+	WrSerializer ser;
+	ser.PutVString(ns);
+	ser.PutVarUint(FormatCJson);
+	ser.PutVarUint(items.size());
+	for (auto& item : items) {
+		ser.PutSlice(item.GetCJSON());
+		ser.PutVarUint(item.impl_->GetPrecepts().size());
+		for (auto& p : item.impl_->GetPrecepts()) {
+			ser.PutVString(p);
+		}
+	}
+	auto conn = getConn();
+	auto ret = conn->Call(cproto::kCmdModifyItems, ser.Slice(), mode);
+
+	if (ret.Status().ok()) {
+		if (ret.GetArgs().size() < 2) {
+			return Error(errParams, "Server returned %d args, but expected %d", int(ret.GetArgs().size()), 1);
+		}
+		NSArray nsArray{getNamespace(ns)};
+		QueryResults(conn, nsArray, p_string(ret.GetArgs()[0]), int(ret.GetArgs()[1]), kResultsPure);
 	}
 	return ret.Status();
 }
@@ -176,7 +212,7 @@ Error RPCClient::Delete(const Query& query, QueryResults& result) {
 }
 
 Error RPCClient::Select(const string& query, QueryResults& result) {
-	int flags = kResultsWithPayloadTypes | kResultsWithCJson;
+	int flags = kResultsWithPayloadTypes | kResultsWithCJson | kResultsWithAggJson | kResultsWithExplain;
 	auto ret = getConn()->Call(cproto::kCmdSelectSQL, query, flags, INT_MAX, int64_t(-1));
 
 	(void)result;
@@ -193,7 +229,8 @@ void vec2pack(const h_vector<int32_t, 4>& vec, WrSerializer& ser) {
 
 Error RPCClient::Select(const Query& query, QueryResults& result) {
 	try {
-		int flags = kResultsWithPayloadTypes | kResultsWithCJson;
+		int flags = kResultsWithPayloadTypes | kResultsWithCJson | kResultsWithAggJson;
+		if (query.explain_) flags |= kResultsWithExplain;
 
 		WrSerializer qser, pser;
 		query.Serialize(qser);
@@ -210,7 +247,7 @@ Error RPCClient::Select(const Query& query, QueryResults& result) {
 			if (ret.GetArgs().size() < 2) {
 				return Error(errParams, "Server returned %d args, but expected %d", int(ret.GetArgs().size()), 1);
 			}
-			result = QueryResults(conn, nsArray, p_string(ret.GetArgs()[0]), int(ret.GetArgs()[1]));
+			result = QueryResults(conn, nsArray, p_string(ret.GetArgs()[0]), int(ret.GetArgs()[1]), flags);
 		}
 		return ret.Status();
 	} catch (const Error& err) {
@@ -43,6 +43,7 @@ public:
 	Error Update(const string &_namespace, client::Item &item);
 	Error Upsert(const string &_namespace, client::Item &item);
 	Error Delete(const string &_namespace, client::Item &item);
+	Error ModifyItems(const string &_namespace, vector<client::Item> &items, int mode);
 	Error Delete(const Query &query, QueryResults &result);
 	Error Select(const string &query, QueryResults &result);
 	Error Select(const Query &query, QueryResults &result);
@@ -66,6 +67,7 @@ private:
 
 	shared_timed_mutex nsMutex_;
 	httpparser::UrlParser uri_;
+	bool enableCompression_ = false;
 	ev::dynamic_loop loop_;
 	std::thread worker_;
 	ev::async stop_;
@@ -33,9 +33,11 @@ HTTPServer::~HTTPServer() {}
 
 enum { ModeUpdate, ModeInsert, ModeUpsert, ModeDelete };
 
+// Size of part of query results, which is encoded to JSON at once
+const size_t kQueryResultsPartSize = 0x4000;
+
 int HTTPServer::GetSQLQuery(http::Context &ctx) {
-	shared_ptr<Reindexer> db = getDB(ctx, kRoleDataRead);
-	reindexer::QueryResults res;
+	auto res = std::make_shared<reindexer::QueryResults>();
 	string sqlQuery = urldecode2(ctx.request->params.Get("q"));
 
 	string_view limitParam = ctx.request->params.Get("limit");
@@ -50,7 +52,7 @@ int HTTPServer::GetSQLQuery(http::Context &ctx) {
 		return jsonStatus(ctx, httpStatus);
 	}
 
-	auto ret = db->Select(sqlQuery, res);
+	auto ret = execSqlQuery(ctx, sqlQuery, *res);
 	if (!ret.ok()) {
 		http::HttpStatus httpStatus(http::StatusInternalServerError, ret.what());
 
@@ -61,8 +63,7 @@ int HTTPServer::GetSQLQuery(http::Context &ctx) {
 }
 
 int HTTPServer::PostSQLQuery(http::Context &ctx) {
-	shared_ptr<Reindexer> db = getDB(ctx, kRoleDataRead);
-	reindexer::QueryResults res;
+	auto res = std::make_shared<reindexer::QueryResults>();
 
 	string sqlQuery = ctx.body->Read();
 	if (!sqlQuery.length()) {
@@ -71,7 +72,7 @@ int HTTPServer::PostSQLQuery(http::Context &ctx) {
 		return jsonStatus(ctx, httpStatus);
 	}
 
-	auto ret = db->Select(sqlQuery, res);
+	auto ret = execSqlQuery(ctx, sqlQuery, *res);
 	if (!ret.ok()) {
 		http::HttpStatus httpStatus(http::StatusBadRequest, ret.what());
 
@@ -80,9 +81,21 @@ int HTTPServer::PostSQLQuery(http::Context &ctx) {
 	return queryResults(ctx, res, true);
 }
 
+Error HTTPServer::execSqlQuery(http::Context &ctx, const string &sqlQuery, reindexer::QueryResults &res) {
+	reindexer::Query q;
+	try {
+		q.Parse(sqlQuery);
+	} catch (const Error &err) {
+		return err;
+	}
+	// UPDATE statement modifies items, so it requires write role
+	if (q.updateFields_.size()) return getDB(ctx, kRoleDataWrite)->Update(q, res);
+	return getDB(ctx, kRoleDataRead)->Select(q, res);
+}
+
 int HTTPServer::PostQuery(http::Context &ctx) {
 	shared_ptr<Reindexer> db = getDB(ctx, kRoleDataRead);
-	reindexer::QueryResults res;
+	auto res = std::make_shared<reindexer::QueryResults>();
 	string dsl = ctx.body->Read();
 
 	reindexer::Query q;
@@ -93,7 +106,7 @@ int HTTPServer::PostQuery(http::Context &ctx) {
 		return jsonStatus(ctx, httpStatus);
 	}
 
-	status = db->Select(q, res);
+	status = db->Select(q, *res);
 	if (!status.ok()) {
 		http::HttpStatus httpStatus(status);
 
@@ -375,8 +388,8 @@ int HTTPServer::GetItems(http::Context &ctx) {
 	q.Parse(querySer.Slice().ToString());
 	q.ReqTotal();
 
-	reindexer::QueryResults res;
-	auto ret = db->Select(q, res);
+	auto res = std::make_shared<reindexer::QueryResults>();
+	auto ret = db->Select(q, *res);
 	if (!ret.ok()) {
 		http::HttpStatus httpStatus(http::StatusInternalServerError, ret.what());
 
@@ -701,38 +714,55 @@ int HTTPServer::modifyItem(http::Context &ctx, int mode) {
 	return jsonStatus(ctx);
 }
 
-int HTTPServer::queryResults(http::Context &ctx, reindexer::QueryResults &res, bool isQueryResults, unsigned limit, unsigned offset) {
-	ctx.writer->SetHeader(http::Header{"Content-Type"_sv, "application/json; charset=utf-8"_sv});
+// Items are encoded to JSON by parts, and each next part is written, when previous one was sent to client.
+// Query results are already selected, so namespaces are not locked while response is written.
+// With `format=ndjson` parameter items are written one per line, without aggregations and total count
+int HTTPServer::queryResults(http::Context &ctx, shared_ptr<reindexer::QueryResults> res, bool isQueryResults, unsigned limit,
+							 unsigned offset) {
+	bool ndjson = ctx.request->params.Get("format") == "ndjson"_sv;
+	ctx.writer->SetHeader(http::Header{"Content-Type"_sv, ndjson ? "application/x-ndjson"_sv : "application/json; charset=utf-8"_sv});
 	ctx.writer->SetRespCode(http::StatusOK);
-	reindexer::WrSerializer wrSer(true);
-	ctx.writer->Write('{');
-
-	if (!res.aggregationResults.empty()) {
-		ctx.writer->Write("\"aggregations\": ["_sv);
-		for (unsigned i = 0; i < res.aggregationResults.size(); i++) {
-			if (i) ctx.writer->Write(',');
-			string agg = to_string(res.aggregationResults[i]);
-			ctx.writer->Write(agg.c_str(), agg.length());
+	auto wrSer = std::make_shared<reindexer::WrSerializer>(true);
+
+	if (!ndjson) {
+		ctx.writer->Write('{');
+		if (!res->aggregationResults.empty()) {
+			ctx.writer->Write("\"aggregations\": ["_sv);
+			for (unsigned i = 0; i < res->aggregationResults.size(); i++) {
+				if (i) ctx.writer->Write(',');
+				wrSer->Reset();
+				res->aggregationResults[i].GetJSON(*wrSer);
+				ctx.writer->Write(wrSer->Buf(), wrSer->Len());
+			}
+			ctx.writer->Write("],"_sv);
 		}
-		ctx.writer->Write("],"_sv);
-	}
-
-	ctx.writer->Write("\"items\": ["_sv);
-	for (size_t i = offset; i < res.Count() && i < offset + limit; i++) {
-		wrSer.Reset();
-		if (i != offset) ctx.writer->Write(',');
-		res[i].GetJSON(wrSer, false);
-		ctx.writer->Write(wrSer.Buf(), wrSer.Len());
+		if (!res->explainResults.empty()) {
+			ctx.writer->Write("\"explain\": "_sv);
+			ctx.writer->Write(res->explainResults.data(), res->explainResults.size());
+			ctx.writer->Write(',');
+		}
+		ctx.writer->Write("\"items\": ["_sv);
 	}
-	ctx.writer->Write("],"_sv);
-
-	unsigned totalItems = isQueryResults ? res.Count() : static_cast<unsigned>(res.totalCount);
-	ctx.writer->Write("\"total_items\":"_sv);
-	string total = to_string(totalItems);
-	ctx.writer->Write(total.c_str(), total.length());
 
-	ctx.writer->Write('}');
+	size_t first = std::min(size_t(offset), res->Count());
+	size_t end = first + std::min(size_t(limit), res->Count() - first);
+	size_t pos = first;
+	unsigned totalItems = isQueryResults ? res->Count() : static_cast<unsigned>(res->totalCount);
 
+	ctx.writer->SetStream([res, wrSer, first, pos, end, totalItems, ndjson](http::Writer &writer) mutable {
+		wrSer->Reset();
+		for (; pos < end && wrSer->Len() < kQueryResultsPartSize; pos++) {
+			if (pos != first && !ndjson) wrSer->PutChar(',');
+			(*res)[pos].GetJSON(*wrSer, false);
+			if (ndjson) wrSer->PutChar('\n');
+		}
+		if (pos == end && !ndjson) {
+			wrSer->Printf("],\"total_items\":%u}", totalItems);
+		}
+		// Empty write is the end of response, which is written by connection
+		if (wrSer->Len()) writer.Write(wrSer->Buf(), wrSer->Len());
+		return pos < end;
+	});
 	return 0;
 }
 
@@ -51,13 +51,14 @@ public:
 
 protected:
 	int modifyItem(http::Context &ctx, int mode);
-	int queryResults(http::Context &ctx, reindexer::QueryResults &res, bool isQueryResults = false, unsigned limit = kDefaultLimit,
-					 unsigned offset = kDefaultOffset);
+	int queryResults(http::Context &ctx, shared_ptr<reindexer::QueryResults> res, bool isQueryResults = false,
+					 unsigned limit = kDefaultLimit, unsigned offset = kDefaultOffset);
 	int jsonStatus(http::Context &ctx, http::HttpStatus status = http::HttpStatus());
 	unsigned prepareLimit(const string_view &limitParam, int limitDefault = kDefaultLimit);
 	unsigned prepareOffset(const string_view &offsetParam, int offsetDefault = kDefaultOffset);
 
 	shared_ptr<Reindexer> getDB(http::Context &ctx, UserRole role);
+	Error execSqlQuery(http::Context &ctx, const string &sqlQuery, reindexer::QueryResults &res);
 	string getNameFromJson(string json);
 
 	DBManager &dbMgr_;
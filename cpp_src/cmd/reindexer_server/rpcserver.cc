@@ -111,6 +111,10 @@ void RPCServer::Logger(cproto::Context &ctx, const Error &err, const cproto::Arg
 
 		ser.Printf(" | elapsed: %dus, allocs: %d, allocated: %d byte(s)", int(statDiff.GetTimeElapsed()), int(statDiff.GetAllocsCnt()),
 				   int(statDiff.GetAllocsBytes()));
+		if (workers_) {
+			auto queueStat = workers_->GetStat();
+			ser.Printf(", waited: %dus, queue: %d", int(ctx.stat.GetWaitTime()), int(queueStat.queueDepth));
+		}
 	}
 
 	ser.PutChar(0);
@@ -250,6 +254,63 @@ Error RPCServer::ModifyItem(cproto::Context &ctx, p_string itemPack, int mode) {
 	return sendResults(ctx, qres, -1, opts);
 }
 
+Error RPCServer::ModifyItems(cproto::Context &ctx, p_string itemsPack, int mode) {
+	auto db = getDB(ctx, kRoleDataWrite);
+	Serializer ser(itemsPack.data(), itemsPack.size());
+	string ns = ser.GetVString().ToString();
+	int format = ser.GetVarUint();
+	unsigned count = ser.GetVarUint();
+	bool tmUpdated = false;
+
+	// All items of batch are sent in one frame, and are applied by single call
+	vector<Item> items;
+	items.reserve(count);
+	for (unsigned i = 0; i < count; i++) {
+		auto item = Item(db->NewItem(ns));
+		if (!item.Status().ok()) {
+			return item.Status();
+		}
+		Error err;
+		switch (format) {
+			case FormatJson:
+				err = item.Unsafe().FromJSON(ser.GetSlice(), nullptr, mode == ModeDelete);
+				break;
+			case FormatCJson:
+				err = item.Unsafe().FromCJSON(ser.GetSlice(), mode == ModeDelete);
+				break;
+			default:
+				err = Error(-1, "Invalid source item format %d", format);
+		}
+		if (!err.ok()) {
+			return err;
+		}
+		tmUpdated = tmUpdated || item.IsTagsUpdated();
+		unsigned preceptsCount = ser.GetVarUint();
+		vector<string> precepts;
+		for (unsigned prIndex = 0; prIndex < preceptsCount; prIndex++) {
+			precepts.push_back(ser.GetVString().ToString());
+		}
+		item.SetPrecepts(precepts);
+		items.push_back(std::move(item));
+	}
+
+	auto err = db->ModifyItems(ns, items, mode);
+	if (!err.ok()) {
+		return err;
+	}
+	QueryResults qres;
+	for (auto &item : items) qres.AddItem(item);
+	int32_t ptVers = -1;
+	ResultFetchOpts opts;
+	if (tmUpdated) {
+		opts = ResultFetchOpts{kResultsWithPayloadTypes, &ptVers, 1, 0, INT_MAX, 0};
+	} else {
+		opts = ResultFetchOpts{0, nullptr, 0, 0, INT_MAX, 0};
+	}
+
+	return sendResults(ctx, qres, -1, opts);
+}
+
 Error RPCServer::DeleteQuery(cproto::Context &ctx, p_string queryBin) {
 	Query query;
 	Serializer ser(queryBin.data(), queryBin.size());
@@ -294,6 +355,7 @@ Error RPCServer::sendResults(cproto::Context &ctx, QueryResults &qres, int reqId
 
 QueryResults &RPCServer::getQueryResults(cproto::Context &ctx, int &id) {
 	auto data = dynamic_cast<RPCClientData *>(ctx.GetClientData().get());
+	std::lock_guard<std::mutex> lck(data->resultsMtx);
 
 	if (id < 0) {
 		for (id = 0; id < int(data->results.size()); id++) {
@@ -316,6 +378,7 @@ QueryResults &RPCServer::getQueryResults(cproto::Context &ctx, int &id) {
 
 void RPCServer::freeQueryResults(cproto::Context &ctx, int id) {
 	auto data = dynamic_cast<RPCClientData *>(ctx.GetClientData().get());
+	std::lock_guard<std::mutex> lck(data->resultsMtx);
 	if (id >= int(data->results.size()) || id < 0) {
 		throw Error(errLogic, "Invalid query id");
 	}
@@ -351,9 +414,19 @@ Error RPCServer::Select(cproto::Context &ctx, p_string queryBin, int flags, int
 }
 
 Error RPCServer::SelectSQL(cproto::Context &ctx, p_string querySql, int flags, int limit, int64_t fetchDataMask, p_string ptVersionsPck) {
+	Query query;
+	try {
+		query.Parse(querySql.toString());
+	} catch (const Error &err) {
+		return err;
+	}
+	// UPDATE statement modifies items, so it requires write role
+	bool isUpdate = !query.updateFields_.empty();
+	auto db = getDB(ctx, isUpdate ? kRoleDataWrite : kRoleDataRead);
+
 	int id = -1;
 	QueryResults &qres = getQueryResults(ctx, id);
-	auto ret = getDB(ctx, kRoleDataRead)->Select(querySql.toString(), qres);
+	auto ret = isUpdate ? db->Update(query, qres) : db->Select(query, qres);
 	if (!ret.ok()) {
 		freeQueryResults(ctx, id);
 		return ret;
@@ -428,6 +501,7 @@ bool RPCServer::Start(const string &addr, ev::dynamic_loop &loop) {
 	dispatcher.Register(cproto::kCmdCommit, this, &RPCServer::Commit);
 
 	dispatcher.Register(cproto::kCmdModifyItem, this, &RPCServer::ModifyItem);
+	dispatcher.Register(cproto::kCmdModifyItems, this, &RPCServer::ModifyItems);
 	dispatcher.Register(cproto::kCmdDeleteQuery, this, &RPCServer::DeleteQuery);
 
 	dispatcher.Register(cproto::kCmdSelect, this, &RPCServer::Select);
@@ -438,6 +512,15 @@ bool RPCServer::Start(const string &addr, ev::dynamic_loop &loop) {
 	dispatcher.Register(cproto::kCmdGetMeta, this, &RPCServer::GetMeta);
 	dispatcher.Register(cproto::kCmdPutMeta, this, &RPCServer::PutMeta);
 	dispatcher.Register(cproto::kCmdEnumMeta, this, &RPCServer::EnumMeta);
+
+	// Read only commands of one connection could be executed in parallel.
+	// SelectSQL is executed in order, since it also executes UPDATE statements
+	dispatcher.Concurrent(cproto::kCmdPing);
+	dispatcher.Concurrent(cproto::kCmdSelect);
+	dispatcher.Concurrent(cproto::kCmdGetMeta);
+	dispatcher.Concurrent(cproto::kCmdEnumMeta);
+	dispatcher.Concurrent(cproto::kCmdEnumNamespaces);
+
 	dispatcher.Middleware(this, &RPCServer::CheckAuth);
 	dispatcher.OnClose(this, &RPCServer::OnClose);
 
@@ -445,7 +528,8 @@ bool RPCServer::Start(const string &addr, ev::dynamic_loop &loop) {
 		dispatcher.Logger(this, &RPCServer::Logger);
 	}
 
-	listener_.reset(new Listener(loop, cproto::ServerConnection::NewFactory(dispatcher)));
+	workers_.reset(new WorkerPool());
+	listener_.reset(new Listener(loop, cproto::ServerConnection::NewFactory(dispatcher, workers_.get())));
 	return listener_->Bind(addr);
 }
 
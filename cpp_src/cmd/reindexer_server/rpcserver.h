@@ -1,6 +1,8 @@
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include "core/cbinding/resultserializer.h"
 #include "core/keyvalue/keyref.h"
 #include "core/reindexer.h"
@@ -8,6 +10,7 @@
 #include "loggerwrapper.h"
 #include "net/cproto/dispatcher.h"
 #include "net/listener.h"
+#include "tools/workerpool.h"
 
 namespace reindexer_server {
 
@@ -17,7 +20,9 @@ using namespace reindexer::net;
 using namespace reindexer;
 
 struct RPCClientData : public cproto::ClientData {
-	h_vector<pair<QueryResults, bool>, 1> results;
+	// Concurrent selects of connection are allocating results in parallel, so references to results must be stable
+	std::deque<pair<QueryResults, bool>> results;
+	std::mutex resultsMtx;
 	AuthContext auth;
 	int connID;
 };
@@ -48,6 +53,7 @@ public:
 	Error Commit(cproto::Context &ctx, p_string ns);
 
 	Error ModifyItem(cproto::Context &ctx, p_string itemPack, int mode);
+	Error ModifyItems(cproto::Context &ctx, p_string itemsPack, int mode);
 	Error DeleteQuery(cproto::Context &ctx, p_string query);
 
 	Error Select(cproto::Context &ctx, p_string query, int flags, int limit, int64_t fetchDataMask, p_string ptVersions);
@@ -73,6 +79,7 @@ protected:
 
 	DBManager &dbMgr_;
 	cproto::Dispatcher dispatcher;
+	std::unique_ptr<WorkerPool> workers_;
 	std::unique_ptr<Listener> listener_;
 
 	LoggerWrapper logger_;
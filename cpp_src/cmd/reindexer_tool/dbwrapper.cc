@@ -22,6 +22,32 @@ const string kOutputModePretty = "pretty";
 const string kOutputModePrettyCollapsed = "collapsed";
 const string kOutputModeTable = "table";
 
+template <typename QueryResultsT>
+static Error dumpItems(const string& nsName, const QueryResultsT& results, WrSerializer& wrser, ostream& file) {
+	for (auto it : results) {
+		wrser.Reset();
+		if (!it.Status().ok()) return it.Status();
+
+		it.GetJSON(wrser, false);
+		file << "\\UPSERT " << escapeName(nsName) << " " << wrser.Slice() << "\n";
+	}
+	return errOK;
+}
+
+// Client receives items from server by pages
+template <typename _DB>
+static Error dumpNamespaceItems(_DB& db, const string& nsName, WrSerializer& wrser, ostream& file) {
+	typename _DB::QueryResultsT itemResults;
+	auto err = db.Select(reindexer::Query(nsName), itemResults);
+	if (!err.ok()) return err;
+	return dumpItems(nsName, itemResults, wrser, file);
+}
+
+// Builtin database streams items by batches, without collecting all items of namespace in memory
+static Error dumpNamespaceItems(reindexer::Reindexer& db, const string& nsName, WrSerializer& wrser, ostream& file) {
+	return db.Select(reindexer::Query(nsName), [&](reindexer::QueryResults& batch, bool) { return dumpItems(nsName, batch, wrser, file); });
+}
+
 template <typename _DB>
 DBWrapper<_DB>::DBWrapper(const string& outFileName, const string& inFileName, const string& command)
 	: output_(outFileName), fileName_(inFileName), command_(command) {
@@ -153,18 +179,8 @@ Error DBWrapper<_DB>::commandDump(const string& command) {
 			file << "\\META PUT " << escapeName(nsDef.name) << " " << escapeName(mkey) << " " << escapeName(mdata) << std::endl;
 		}
 
-		typename _DB::QueryResultsT itemResults;
-		err = db_.Select(reindexer::Query(nsDef.name), itemResults);
-
+		err = dumpNamespaceItems(db_, nsDef.name, wrser, file);
 		if (!err.ok()) return err;
-
-		for (auto it : itemResults) {
-			wrser.Reset();
-			if (!it.Status().ok()) return it.Status();
-
-			it.GetJSON(wrser, false);
-			file << "\\UPSERT " << escapeName(nsDef.name) << " " << wrser.Slice() << "\n";
-		}
 	}
 
 	return errOK;
@@ -1,17 +1,47 @@
 #include "core/aggregator.h"
+#include <algorithm>
+#include "core/index/index.h"
 #include "core/payload/payloadiface.h"
 
 namespace reindexer {
 
-Aggregator::Aggregator(KeyValueType type, bool isArray, void *rawData, AggType aggType)
-	: type_(type), isArray_(isArray), rawData_(static_cast<uint8_t *>(rawData)), aggType_(aggType) {}
+Aggregator::Aggregator(KeyValueType type, bool isArray, void *rawData, AggType aggType, const string &field, unsigned limit)
+	: type_(type), isArray_(isArray), rawData_(static_cast<uint8_t *>(rawData)), aggType_(aggType), field_(field), limit_(limit) {}
 
 void Aggregator::Bind(PayloadType type, int field) {
 	offset_ = type->Field(field).Offset();
 	sizeof_ = type->Field(field).ElemSizeof();
 }
 
+void Aggregator::BindJsonPath(PayloadType type, const TagsPath &tagsPath) {
+	payloadType_ = type;
+	tagsPath_ = tagsPath;
+}
+
+void Aggregator::BindIndex(Index *index, size_t itemsCount, bool allMatched) {
+	index_ = index;
+	allMatched_ = allMatched;
+	if (!allMatched) matched_ = std::make_shared<vector<uint8_t>>(itemsCount, 0);
+}
+
 void Aggregator::Aggregate(const PayloadValue &data, int idx) {
+	if (index_) {
+		if (!allMatched_) (*matched_)[idx] = 1;
+		return;
+	}
+	aggregatePayload(data, idx);
+}
+
+void Aggregator::aggregatePayload(const PayloadValue &data, int idx) {
+	if (!tagsPath_.empty()) {
+		KeyRefs krefs;
+		ConstPayload(payloadType_, data).GetByJsonPath(tagsPath_, krefs);
+		for (auto &key : krefs) {
+			if (key.Type() != KeyValueEmpty) aggregate(key);
+		}
+		return;
+	}
+
 	if (rawData_) {
 		aggregate(rawData_ + idx * sizeof_);
 		return;
@@ -28,4 +58,146 @@ void Aggregator::Aggregate(const PayloadValue &data, int idx) {
 	for (int i = 0; i < arr->len; i++, ptr += sizeof_) aggregate(ptr);
 }
 
+void Aggregator::aggregate(const uint8_t *ptr) {
+	if (aggType_ == AggFacet || aggType_ == AggCountDistinct) {
+		switch (type_) {
+			case KeyValueInt:
+				facets_[KeyRef(*reinterpret_cast<const int *>(ptr))]++;
+				break;
+			case KeyValueInt64:
+				facets_[KeyRef(*reinterpret_cast<const int64_t *>(ptr))]++;
+				break;
+			case KeyValueDouble:
+				facets_[KeyRef(*reinterpret_cast<const double *>(ptr))]++;
+				break;
+			case KeyValueString:
+				facets_[KeyRef(*reinterpret_cast<const p_string *>(ptr))]++;
+				break;
+			default:
+				abort();
+		}
+		return;
+	}
+
+	switch (type_) {
+		case KeyValueInt:
+			aggregate(double(*reinterpret_cast<const int *>(ptr)));
+			break;
+		case KeyValueInt64:
+			aggregate(double(*reinterpret_cast<const int64_t *>(ptr)));
+			break;
+		case KeyValueDouble:
+			aggregate(*reinterpret_cast<const double *>(ptr));
+			break;
+		default:
+			abort();
+	}
+}
+
+void Aggregator::aggregate(const KeyRef &key) {
+	if (aggType_ == AggFacet || aggType_ == AggCountDistinct) {
+		facets_[key]++;
+	} else {
+		aggregate(key.As<double>());
+	}
+}
+
+void Aggregator::Merge(const Aggregator &other) {
+	// Indexed aggregators share flags of matched items, so there is nothing to merge
+	if (index_) return;
+	switch (aggType_) {
+		case AggFacet:
+		case AggCountDistinct:
+			for (auto &f : other.facets_) facets_[f.first] += f.second;
+			break;
+		case AggMin:
+		case AggMax:
+			if (other.hitCount_ && (!hitCount_ || (aggType_ == AggMin ? other.result_ < result_ : other.result_ > result_))) {
+				result_ = other.result_;
+			}
+			hitCount_ += other.hitCount_;
+			break;
+		default:
+			result_ += other.result_;
+			hitCount_ += other.hitCount_;
+	}
+}
+
+void Aggregator::Finish(const vector<PayloadValue> &items) {
+	if (!index_) return;
+
+	auto countMatched = [this](const IdSetRef &ids, bool stopOnFirst) {
+		if (allMatched_) return int(ids.size());
+		int cnt = 0;
+		for (auto id : ids) {
+			if ((*matched_)[id]) {
+				cnt++;
+				if (stopOnFirst) break;
+			}
+		}
+		return cnt;
+	};
+	// Keys of ordered index are visited in order, so the first key, which has matched items, is min or max
+	bool ordered = index_->IsOrdered();
+
+	bool visited = index_->VisitKeys(
+		[&](const KeyRef &key, const IdSetRef &ids) {
+			switch (aggType_) {
+				case AggMin:
+				case AggMax:
+					if (!countMatched(ids, true)) return true;
+					aggregate(key.As<double>());
+					return !ordered;
+				case AggCountDistinct:
+					if (countMatched(ids, true)) facets_.emplace(key, 1);
+					return true;
+				default: {
+					int cnt = countMatched(ids, false);
+					if (cnt) facets_.emplace(key, cnt);
+					return true;
+				}
+			}
+		},
+		aggType_ == AggMax);
+
+	if (!visited) {
+		for (size_t id = 0; id < items.size(); id++) {
+			if (!items[id].IsFree() && isMatched(id)) aggregatePayload(items[id], id);
+		}
+	}
+}
+
+AggregationResult Aggregator::GetResult() const {
+	AggregationResult ret;
+	ret.field = field_;
+	ret.type = aggType_;
+	switch (aggType_) {
+		case AggAvg:
+			ret.value = hitCount_ == 0 ? 0 : (result_ / hitCount_);
+			break;
+		case AggSum:
+		case AggMin:
+		case AggMax:
+			ret.value = result_;
+			break;
+		case AggCountDistinct:
+			ret.value = facets_.size();
+			break;
+		case AggFacet: {
+			vector<std::pair<KeyRef, int>> facets(facets_.begin(), facets_.end());
+			auto cmp = [](const std::pair<KeyRef, int> &lhs, const std::pair<KeyRef, int> &rhs) {
+				return lhs.second == rhs.second ? lhs.first < rhs.first : lhs.second > rhs.second;
+			};
+			size_t count = std::min(facets.size(), size_t(limit_));
+			std::partial_sort(facets.begin(), facets.begin() + count, facets.end(), cmp);
+			ret.facets.reserve(count);
+			for (size_t i = 0; i < count; i++) ret.facets.push_back(FacetResult(facets[i].first.As<string>(), facets[i].second));
+			break;
+		}
+		default:
+			abort();
+	}
+	return ret;
+}
+
 }  // namespace reindexer
@@ -1,55 +1,84 @@
 #pragma once
 
+#include <limits.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "core/cjson/tagsmatcherimpl.h"
 #include "core/keyvalue/keyvalue.h"
 #include "core/payload/payloadiface.h"
+#include "core/query/aggregationresult.h"
 #include "core/type_consts.h"
 
 namespace reindexer {
 
+class Index;
+
 class Aggregator {
 public:
-	Aggregator(KeyValueType type, bool isArray, void *rawData, AggType aggType);
+	Aggregator(KeyValueType type, bool isArray, void *rawData, AggType aggType, const string &field = string(),
+			   unsigned limit = UINT_MAX);
 	Aggregator(){};
 	~Aggregator(){};
 	void Aggregate(const PayloadValue &lhs, int idx);
 	void Bind(PayloadType type, int field);
-	double GetResult() const {
-		switch (aggType_) {
-			case AggAvg:
-				return hitCount_ == 0 ? 0 : (result_ / hitCount_);
-			case AggSum:
-				return result_;
-			default:
-				abort();
-		}
-	}
+	// Bind to field of sparse index, which values are stored only in tuple
+	void BindJsonPath(PayloadType type, const TagsPath &tagsPath);
+	// Facet, min, max and count distinct are computed from keys of index: Aggregate only marks item as matched,
+	// and Finish visits keys of index, intersecting their ids with matched items. Payloads of items are not touched.
+	// Flags of matched items cost O(itemsCount), so index is bound only if query matches large share of items.
+	// If allMatched, then all items are aggregated, and flags are not allocated at all
+	void BindIndex(Index *index, size_t itemsCount, bool allMatched);
+	bool IsIndexed() const { return index_ != nullptr; }
+	// Merge partial result of other aggregator of the same field
+	void Merge(const Aggregator &other);
+	// Complete indexed aggregation. Payloads of matched items are aggregated, if index has no map of keys
+	void Finish(const vector<PayloadValue> &items);
+	AggregationResult GetResult() const;
 
 protected:
-	void aggregate(void *ptr) {
-		hitCount_++;
-		switch (type_) {
-			case KeyValueInt:
-				result_ += *static_cast<int *>(ptr);
-				break;
-			case KeyValueInt64:
-				result_ += *static_cast<int64_t *>(ptr);
+	struct hashKeyRef {
+		size_t operator()(const KeyRef &k) const { return k.Hash(); }
+	};
+	// Key references are valid while namespace is locked
+	typedef std::unordered_map<KeyRef, int, hashKeyRef> Facets;
+
+	void aggregatePayload(const PayloadValue &data, int idx);
+	void aggregate(const uint8_t *ptr);
+	void aggregate(const KeyRef &key);
+	void aggregate(double v) {
+		switch (aggType_) {
+			case AggMin:
+				if (!hitCount_ || v < result_) result_ = v;
 				break;
-			case KeyValueDouble:
-				result_ += *static_cast<double *>(ptr);
+			case AggMax:
+				if (!hitCount_ || v > result_) result_ = v;
 				break;
 			default:
-				abort();
+				result_ += v;
 		}
+		hitCount_++;
 	}
+	bool isMatched(IdType id) const { return allMatched_ || (*matched_)[id]; }
 
 	KeyValueType type_ = KeyValueUndefined;
 	size_t offset_ = 0;
 	size_t sizeof_ = 0;
+	PayloadType payloadType_;
+	TagsPath tagsPath_;
 	bool isArray_ = false;
 	uint8_t *rawData_ = nullptr;
 	double result_ = 0;
 	int hitCount_ = 0;
-	AggType aggType_;
+	AggType aggType_ = AggSum;
+	string field_;
+	unsigned limit_ = UINT_MAX;
+	Facets facets_;
+
+	Index *index_ = nullptr;
+	// Flags of matched items. Shared by copies of aggregator in workers, each worker marks own items
+	std::shared_ptr<vector<uint8_t>> matched_;
+	bool allMatched_ = false;
 };
 
-}  // namespace reindexer
\ No newline at end of file
+}  // namespace reindexer
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <locale>
+#include <mutex>
 #include "core/reindexer.h"
 #include "core/selectfunc/selectfuncparser.h"
 #include "debug/allocdebug.h"
@@ -13,6 +14,58 @@ using namespace reindexer;
 
 static Reindexer *db = nullptr;
 
+// Query results with buffer of serialized results, passed to Go. Results are kept pinned until buffer is freed by Go,
+// so items are read by pointers to payloads, and remaining items can be fetched later by chunks
+struct ResultsHolder {
+	QueryResults results;
+	WrResultSerializer ser{false};
+	// Plan of query is put to each chunk of results, since Go reads query params of each chunk the same way
+	bool withExplain = false;
+};
+
+// Pool of results holders. Holders are reused across calls, so buffers are not reallocated on each query
+class ResultsPool {
+public:
+	ResultsHolder *Get() {
+		std::unique_lock<std::mutex> lck(mtx_);
+		if (holders_.empty()) {
+			lck.unlock();
+			return new ResultsHolder;
+		}
+		ResultsHolder *holder = holders_.back();
+		holders_.pop_back();
+		return holder;
+	}
+	void Put(ResultsHolder *holder) {
+		holder->results = QueryResults();
+		holder->ser.Reset();
+		holder->withExplain = false;
+		// Large buffers are not kept in pool, to not hold memory after rare huge selects
+		if (holder->ser.Cap() <= kMaxBufSize) {
+			std::lock_guard<std::mutex> lck(mtx_);
+			if (holders_.size() < kMaxHolders) {
+				holders_.push_back(holder);
+				return;
+			}
+		}
+		delete holder;
+	}
+	void Clear() {
+		std::lock_guard<std::mutex> lck(mtx_);
+		for (auto holder : holders_) delete holder;
+		holders_.clear();
+	}
+
+protected:
+	static const size_t kMaxHolders = 1024;
+	static const size_t kMaxBufSize = 1 << 20;
+
+	std::mutex mtx_;
+	vector<ResultsHolder *> holders_;
+};
+
+static ResultsPool resultsPool;
+
 void init_reindexer() {
 	if (db) {
 		abort();
@@ -27,6 +80,7 @@ void init_reindexer() {
 void destroy_reindexer() {
 	delete db;
 	db = nullptr;
+	resultsPool.Clear();
 }
 
 static reindexer_error error2c(const Error &err_) {
@@ -45,25 +99,31 @@ static reindexer_ret ret2c(const Error &err_, const reindexer_resbuffer &out) {
 
 static string str2c(reindexer_string gs) { return string(reinterpret_cast<const char *>(gs.p), gs.n); }
 
-static void results2c(const QueryResults *result, struct reindexer_resbuffer *results, int with_items = 0, int32_t *pt_versions = nullptr,
-					  int pt_versions_count = 0) {
-	int flags = with_items ? kResultsWithJson : kResultsWithPtrs;
+static void buf2c(ResultsHolder *holder, struct reindexer_resbuffer *out) {
+	out->len = holder->ser.Len();
+	out->data = uintptr_t(holder->ser.Buf());
+	out->results_ptr = uintptr_t(holder);
+}
 
-	flags |= (pt_versions && with_items == 0) ? kResultsWithPayloadTypes : 0;
+// Serialize chunk of results of holder, starting from offset. Negative or zero limit means all the remaining results
+static void results2c(ResultsHolder *holder, struct reindexer_resbuffer *out, int with_items = 0, int32_t *pt_versions = nullptr,
+					  int pt_versions_count = 0, int offset = 0, int limit = -1) {
+	int flags = (with_items ? kResultsWithJson : kResultsWithPtrs) | kResultsWithAggJson;
+	flags |= holder->withExplain ? kResultsWithExplain : 0;
 
-	ResultFetchOpts opts{flags, pt_versions, pt_versions_count, 0, INT_MAX, -1};
-	WrResultSerializer ser(false, opts);
-	ser.PutResults(result);
+	flags |= (pt_versions && with_items == 0) ? kResultsWithPayloadTypes : 0;
 
-	results->len = ser.Len();
-	results->data = uintptr_t(ser.DetachBuffer());
-	results->results_flag = 1;
+	ResultFetchOpts opts{flags, pt_versions, pt_versions_count, unsigned(std::max(offset, 0)), limit > 0 ? unsigned(limit) : unsigned(INT_MAX), -1};
+	holder->ser.Reset();
+	holder->ser.SetOpts(opts);
+	holder->ser.PutResults(&holder->results);
+	buf2c(holder, out);
 }
 
 static Error err_not_init(-1, "Reindexer db has not initialized");
 
 reindexer_ret reindexer_modify_item(reindexer_buffer in, int mode) {
-	reindexer_resbuffer out = {0, 0, 0};
+	reindexer_resbuffer out{0, 0, 0};
 	Error err = err_not_init;
 	if (db) {
 		Serializer ser(in.data, in.len);
@@ -105,8 +165,8 @@ reindexer_ret reindexer_modify_item(reindexer_buffer in, int mode) {
 						err = db->Delete(ns, item);
 						break;
 				}
-				QueryResults *res = new QueryResults();
-				res->AddItem(item);
+				ResultsHolder *res = resultsPool.Get();
+				res->results.AddItem(item);
 				int32_t ptVers = -1;
 				bool tmUpdated = item.IsTagsUpdated();
 				results2c(res, &out, 0, tmUpdated ? &ptVers : nullptr, tmUpdated ? 1 : 0);
@@ -118,6 +178,56 @@ reindexer_ret reindexer_modify_item(reindexer_buffer in, int mode) {
 	return ret2c(err, out);
 }
 
+reindexer_ret reindexer_modify_items(reindexer_buffer in, int mode) {
+	reindexer_resbuffer out{0, 0, 0};
+	Error err = err_not_init;
+	if (db) {
+		Serializer ser(in.data, in.len);
+		string ns = ser.GetVString().ToString();
+		int format = ser.GetVarUint();
+		unsigned count = ser.GetVarUint();
+		bool tmUpdated = false;
+		vector<Item> items;
+		items.reserve(count);
+		err = errOK;
+		for (unsigned i = 0; i < count && err.ok(); i++) {
+			Item item = db->NewItem(ns);
+			if (!item.Status().ok()) {
+				err = item.Status();
+				break;
+			}
+			switch (format) {
+				case FormatJson:
+					err = item.Unsafe().FromJSON(ser.GetSlice(), 0, mode == ModeDelete);
+					break;
+				case FormatCJson:
+					err = item.Unsafe().FromCJSON(ser.GetSlice(), mode == ModeDelete);
+					break;
+				default:
+					err = Error(-1, "Invalid source item format %d", format);
+			}
+			if (err.ok()) {
+				tmUpdated = tmUpdated || item.IsTagsUpdated();
+				unsigned preceptsCount = ser.GetVarUint();
+				vector<string> precepts;
+				for (unsigned prIndex = 0; prIndex < preceptsCount; prIndex++) {
+					precepts.push_back(ser.GetVString().ToString());
+				}
+				item.SetPrecepts(precepts);
+				items.push_back(std::move(item));
+			}
+		}
+		if (err.ok()) {
+			err = db->ModifyItems(ns, items, mode);
+			ResultsHolder *res = resultsPool.Get();
+			for (auto &item : items) res->results.AddItem(item);
+			int32_t ptVers = -1;
+			results2c(res, &out, 0, tmUpdated ? &ptVers : nullptr, tmUpdated ? 1 : 0);
+		}
+	}
+	return ret2c(err, out);
+}
+
 reindexer_error reindexer_open_namespace(reindexer_string _namespace, StorageOpts opts, uint8_t cacheMode) {
 	return error2c(!db ? err_not_init : db->OpenNamespace(str2c(_namespace), opts, static_cast<CacheMode>(cacheMode)));
 }
@@ -149,20 +259,23 @@ reindexer_error reindexer_enable_storage(reindexer_string path) { return error2c
 
 reindexer_error reindexer_init_system_namespaces() { return error2c(!db ? err_not_init : db->InitSystemNamespaces()); }
 
-reindexer_ret reindexer_select(reindexer_string query, int with_items, int32_t *pt_versions, int pt_versions_count) {
-	reindexer_resbuffer out = {0, 0, 0};
+reindexer_ret reindexer_select(reindexer_string query, int with_items, int32_t *pt_versions, int pt_versions_count, int fetch_count) {
+	reindexer_resbuffer out{0, 0, 0};
 	Error res = err_not_init;
 	if (db) {
-		auto result = new QueryResults;
-		res = db->Select(str2c(query), *result);
-		results2c(result, &out, with_items, pt_versions, pt_versions_count);
+		ResultsHolder *result = resultsPool.Get();
+		// SQL query may be explained, so Go always reads plan of it
+		result->withExplain = true;
+		res = db->Select(str2c(query), result->results);
+		results2c(result, &out, with_items, pt_versions, pt_versions_count, 0, fetch_count);
 	}
 	return ret2c(res, out);
 }
 
-reindexer_ret reindexer_select_query(struct reindexer_buffer in, int with_items, int32_t *pt_versions, int pt_versions_count) {
+reindexer_ret reindexer_select_query(struct reindexer_buffer in, int with_items, int32_t *pt_versions, int pt_versions_count,
+								   int fetch_count) {
 	Error res = err_not_init;
-	reindexer_resbuffer out = {0, 0, 0};
+	reindexer_resbuffer out{0, 0, 0};
 	if (db) {
 		res = Error(errOK);
 		Serializer ser(in.data, in.len);
@@ -181,14 +294,23 @@ reindexer_ret reindexer_select_query(struct reindexer_buffer in, int with_items,
 			}
 		}
 
-		auto result = new QueryResults;
-		res = db->Select(q, *result);
+		ResultsHolder *result = resultsPool.Get();
+		result->withExplain = q.explain_;
+		res = db->Select(q, result->results);
 		if (q.debugLevel >= LogError && res.code() != errOK) logPrintf(LogError, "Query error %s", res.what().c_str());
-		results2c(result, &out, with_items, pt_versions, pt_versions_count);
+		results2c(result, &out, with_items, pt_versions, pt_versions_count, 0, fetch_count);
 	}
 	return ret2c(res, out);
 }
 
+reindexer_ret reindexer_fetch_results(reindexer_resbuffer in, int offset, int limit, int with_items) {
+	if (!in.results_ptr) return ret2c(Error(errParams, "Buffer doesn't contain query results"), in);
+
+	reindexer_resbuffer out{0, 0, 0};
+	results2c(reinterpret_cast<ResultsHolder *>(in.results_ptr), &out, with_items, nullptr, 0, offset, limit);
+	return ret2c(errOK, out);
+}
+
 reindexer_ret reindexer_delete_query(reindexer_buffer in) {
 	reindexer_resbuffer out{0, 0, 0};
 	Error res = err_not_init;
@@ -198,8 +320,8 @@ reindexer_ret reindexer_delete_query(reindexer_buffer in) {
 
 		Query q;
 		q.Deserialize(ser);
-		auto result = new QueryResults;
-		res = db->Delete(q, *result);
+		ResultsHolder *result = resultsPool.Get();
+		res = db->Delete(q, result->results);
 		if (q.debugLevel >= LogError && res.code() != errOK) logPrintf(LogError, "Query error %s", res.what().c_str());
 		results2c(result, &out);
 	}
@@ -218,12 +340,11 @@ reindexer_ret reindexer_get_meta(reindexer_string ns, reindexer_string key) {
 	reindexer_resbuffer out{0, 0, 0};
 	Error res = err_not_init;
 	if (db) {
-		WrSerializer wrSer(false);
+		ResultsHolder *holder = resultsPool.Get();
 		string data;
 		res = db->GetMeta(str2c(ns), str2c(key), data);
-		wrSer.PutVString(data);
-		out.len = wrSer.Len();
-		out.data = uintptr_t(wrSer.DetachBuffer());
+		holder->ser.PutVString(data);
+		buf2c(holder, &out);
 	}
 	return ret2c(res, out);
 }
@@ -235,12 +356,7 @@ void reindexer_enable_logger(void (*logWriter)(int, char *)) { logInstallWriter(
 void reindexer_disable_logger() { logInstallWriter(nullptr); }
 
 reindexer_error reindexer_free_buffer(reindexer_resbuffer in) {
-	if (in.results_flag) {
-		auto addr = *reinterpret_cast<uint64_t *>(in.data);
-		auto results = reinterpret_cast<QueryResults *>(addr);
-		delete results;
-	}
-	free(reinterpret_cast<void *>(in.data));
+	if (in.results_ptr) resultsPool.Put(reinterpret_cast<ResultsHolder *>(in.results_ptr));
 	return error2c(Error(errOK));
 }
 
@@ -28,11 +28,16 @@ reindexer_error reindexer_drop_index(reindexer_string _namespace, reindexer_stri
 reindexer_error reindexer_configure_index(reindexer_string _namespace, reindexer_string index, reindexer_string config);
 
 reindexer_ret reindexer_modify_item(reindexer_buffer in, int mode);
-reindexer_ret reindexer_select(reindexer_string query, int with_items, int32_t *pt_versions, int pt_versions_count);
+reindexer_ret reindexer_modify_items(reindexer_buffer in, int mode);
+reindexer_ret reindexer_select(reindexer_string query, int with_items, int32_t *pt_versions, int pt_versions_count, int fetch_count);
 
-reindexer_ret reindexer_select_query(reindexer_buffer in, int with_items, int32_t *pt_versions, int pt_versions_count);
+reindexer_ret reindexer_select_query(reindexer_buffer in, int with_items, int32_t *pt_versions, int pt_versions_count, int fetch_count);
 reindexer_ret reindexer_delete_query(reindexer_buffer in);
 
+// Serialize next chunk of query results, which are owned by buffer. Previous data of buffer becomes invalid
+reindexer_ret reindexer_fetch_results(reindexer_resbuffer in, int offset, int limit, int with_items);
+
+// Return buffer and query results to pool
 reindexer_error reindexer_free_buffer(reindexer_resbuffer in);
 reindexer_error reindexer_free_buffers(reindexer_resbuffer *in, int count);
 
@@ -14,8 +14,9 @@ typedef struct reindexer_buffer {
 
 typedef struct reindexer_resbuffer {
 	int len;
-	int results_flag;
 	uintptr_t data;
+	// Handle of pooled query results, which own the buffer
+	uintptr_t results_ptr;
 } reindexer_resbuffer;
 
 typedef struct reindexer_error {
@@ -1,5 +1,6 @@
 #include "resultserializer.h"
 #include "core/cjson/tagsmatcher.h"
+#include "core/cjson/tupledictionary.h"
 #include "core/query/queryresults.h"
 #include "tools/logger.h"
 
@@ -56,7 +57,17 @@ void WrResultSerializer::putQueryParams(const QueryResults* results) {
 
 void WrResultSerializer::putAggregationParams(const QueryResults* results) {
 	PutVarUint(results->aggregationResults.size());
-	for (auto ar : results->aggregationResults) PutDouble(ar);
+	if (!(opts_.flags & kResultsWithAggJson)) {
+		for (auto &ar : results->aggregationResults) PutDouble(ar.value);
+	} else {
+		WrSerializer wrser;
+		for (auto &ar : results->aggregationResults) {
+			wrser.Reset();
+			ar.GetJSON(wrser);
+			PutSlice(wrser.Slice());
+		}
+	}
+	if (opts_.flags & kResultsWithExplain) PutSlice(results->explainResults);
 }
 
 void WrResultSerializer::putItemParams(const QueryResults* result, int idx, bool useOffset) {
@@ -74,6 +85,11 @@ void WrResultSerializer::putItemParams(const QueryResults* result, int idx, bool
 	if (idx < 63 && !(opts_.fetchDataMask & (1ULL << idx))) {
 		format = kResultsPure;
 	}
+	// Compressed tuples contain references to dictionary of namespace, which can't be read by pointer, so item is passed as CJSON
+	if (format == kResultsWithPtrs) {
+		auto dict = result->getPayloadType(itemRef.nsid)->TupleDict();
+		if (dict && dict->Size()) format = kResultsWithCJson;
+	}
 
 	PutVarUint(format);
 
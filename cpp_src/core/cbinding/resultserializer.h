@@ -18,6 +18,7 @@ public:
 	WrResultSerializer(bool allowInBuf, const ResultFetchOpts& opts = {0, nullptr, 0, 0, 0, 0});
 
 	bool PutResults(const QueryResults* results);
+	void SetOpts(const ResultFetchOpts& opts) { opts_ = opts; }
 
 private:
 	void putQueryParams(const QueryResults* query);
@@ -1,5 +1,6 @@
 #include "cjsondecoder.h"
 #include "tagsmatcher.h"
+#include "tupledictionary.h"
 #include "tools/serializer.h"
 
 namespace reindexer {
@@ -21,7 +22,8 @@ Error CJsonDecoder::Decode(Payload *pl, Serializer &rdser, WrSerializer &wrser)
 	return lastErr_;
 }
 
-void skipCjsonTag(ctag tag, Serializer &rdser) {
+template <typename Ser>
+void skipCjsonTag(ctag tag, Ser &rdser) {
 	const bool embeddedField = (tag.Field() < 0);
 	switch (tag.Type()) {
 		case TAG_ARRAY: {
@@ -65,7 +67,8 @@ void skipCjsonTag(ctag tag, Serializer &rdser) {
 	}
 }
 
-KeyRef cjsonValueToKeyRef(int tag, Serializer &rdser, const PayloadFieldType &pt, Error &err) {
+template <typename Ser>
+KeyRef cjsonValueToKeyRef(int tag, Ser &rdser, const PayloadFieldType &pt, Error &err) {
 	auto t = pt.Type();
 	switch (tag) {
 		case TAG_VARINT: {
@@ -219,4 +222,9 @@ bool CJsonDecoder::decodeCJson(Payload *pl, Serializer &rdser, WrSerializer &wrs
 	return true;
 }
 
+template void skipCjsonTag<Serializer>(ctag, Serializer &);
+template void skipCjsonTag<TupleSerializer>(ctag, TupleSerializer &);
+template KeyRef cjsonValueToKeyRef<Serializer>(int, Serializer &, const PayloadFieldType &, Error &);
+template KeyRef cjsonValueToKeyRef<TupleSerializer>(int, TupleSerializer &, const PayloadFieldType &, Error &);
+
 }  // namespace reindexer
@@ -26,8 +26,12 @@ protected:
 	Error lastErr_;
 };
 
-void skipCjsonTag(ctag tag, Serializer &rdser);
-void copyCJsonValue(int tagType, Serializer &rdser, WrSerializer &wrser);
-KeyRef cjsonValueToKeyRef(int tag, Serializer &rdser, const PayloadFieldType &pt, Error &err);
+// Helpers are instantiated for Serializer of incoming cjson, and for TupleSerializer of tuples, compressed by dictionary
+template <typename Ser>
+void skipCjsonTag(ctag tag, Ser &rdser);
+template <typename Ser>
+void copyCJsonValue(int tagType, Ser &rdser, WrSerializer &wrser);
+template <typename Ser>
+KeyRef cjsonValueToKeyRef(int tag, Ser &rdser, const PayloadFieldType &pt, Error &err);
 
 }  // namespace reindexer
@@ -1,6 +1,7 @@
 #include "cjsonencoder.h"
 #include "cjsondecoder.h"
 #include "tagsmatcher.h"
+#include "tupledictionary.h"
 #include "tools/serializer.h"
 
 #include "core/payload/payloadtuple.h"
@@ -22,7 +23,7 @@ void CJsonEncoder::Encode(ConstPayload *pl, WrSerializer &wrser) {
 		pseudo_tuple = BuildPayloadTuple(*pl, tagsMatcher_).get();
 		tuple = p_string(pseudo_tuple.get());
 	}
-	Serializer rdser(tuple.data(), tuple.size());
+	TupleSerializer rdser(string_view(tuple.data(), tuple.size()), pl->Type().TupleDict());
 
 	depthLevel = depthLevelInitial;
 
@@ -44,7 +45,8 @@ static inline int kvType2TagType(int kvType) {
 	}
 }
 
-void copyCJsonValue(int tagType, Serializer &rdser, WrSerializer &wrser) {
+template <typename Ser>
+void copyCJsonValue(int tagType, Ser &rdser, WrSerializer &wrser) {
 	switch (tagType) {
 		case TAG_DOUBLE:
 			wrser.PutDouble(rdser.GetDouble());
@@ -64,7 +66,7 @@ void copyCJsonValue(int tagType, Serializer &rdser, WrSerializer &wrser) {
 			throw Error(errParseJson, "Unexpected cjson typeTag '%s' while parsing value", ctag(tagType).TypeName());
 	}
 }
-void skipCJsonValue(int tagType, Serializer &rdser) {
+static void skipCJsonValue(int tagType, TupleSerializer &rdser) {
 	switch (tagType) {
 		case TAG_DOUBLE:
 			rdser.GetDouble();
@@ -148,7 +150,7 @@ KeyRefs CJsonEncoder::ExtractFieldValue(const Payload *pl, const string &jsonPat
 	string_view tuple(tupleData[0]);
 
 	TagsPath fieldTags = tagsMatcher_.path2tag(jsonPath);
-	Serializer rdser(tuple.data(), tuple.size());
+	TupleSerializer rdser(tuple, pl->Type().TupleDict());
 	getValueFromTuple(rdser, fieldTags, pl, result);
 
 	return result;
@@ -162,7 +164,7 @@ KeyRefs CJsonEncoder::ExtractFieldValue(const Payload *pl, const TagsPath &field
 	pl->Get(0, tupleData);
 	string_view tuple(tupleData[0]);
 
-	Serializer rdser(tuple.data(), tuple.size());
+	TupleSerializer rdser(tuple, pl->Type().TupleDict());
 	getValueFromTuple(rdser, fieldTags, pl, result);
 
 	return result;
@@ -190,7 +192,8 @@ PayloadFieldType tagTypeToFieldType(int tagType) {
 	return PayloadFieldType(type, std::string(), std::string(), false);
 }
 
-bool CJsonEncoder::getValueFromTuple(Serializer &rdser, const TagsPath &fieldTags, const Payload *pl, KeyRefs &res, bool arrayElements) {
+bool CJsonEncoder::getValueFromTuple(TupleSerializer &rdser, const TagsPath &fieldTags, const Payload *pl, KeyRefs &res,
+									 bool arrayElements) {
 	if (fieldTags.empty()) return false;
 
 	ctag tag = rdser.GetVarUint();
@@ -244,7 +247,7 @@ bool CJsonEncoder::getValueFromTuple(Serializer &rdser, const TagsPath &fieldTag
 	return true;
 }
 
-bool CJsonEncoder::encodeCJson(ConstPayload *pl, Serializer &rdser, WrSerializer &wrser, bool match) {
+bool CJsonEncoder::encodeCJson(ConstPayload *pl, TupleSerializer &rdser, WrSerializer &wrser, bool match) {
 	ctag tag = rdser.GetVarUint();
 	int tagType = tag.Type();
 	int tagField = tag.Field();
@@ -322,4 +325,7 @@ bool CJsonEncoder::encodeCJson(ConstPayload *pl, Serializer &rdser, WrSerializer
 	return true;
 }
 
+template void copyCJsonValue<Serializer>(int, Serializer &, WrSerializer &);
+template void copyCJsonValue<TupleSerializer>(int, TupleSerializer &, WrSerializer &);
+
 }  // namespace reindexer
@@ -7,7 +7,7 @@ namespace reindexer {
 
 class TagsMatcher;
 class WrSerializer;
-class Serializer;
+class TupleSerializer;
 
 class CJsonEncoder {
 public:
@@ -18,8 +18,8 @@ public:
 	KeyRefs ExtractFieldValue(const Payload *pl, const TagsPath &fieldTags);
 
 protected:
-	bool encodeCJson(ConstPayload *pl, Serializer &rdser, WrSerializer &wrser, bool match = true);
-	bool getValueFromTuple(Serializer &rdser, const TagsPath &fieldTags, const Payload *pl, KeyRefs &res, bool arrayElements = false);
+	bool encodeCJson(ConstPayload *pl, TupleSerializer &rdser, WrSerializer &wrser, bool match = true);
+	bool getValueFromTuple(TupleSerializer &rdser, const TagsPath &fieldTags, const Payload *pl, KeyRefs &res, bool arrayElements = false);
 
 	int fieldsoutcnt_[maxIndexes];
 	const TagsMatcher &tagsMatcher_;
@@ -27,6 +27,4 @@ protected:
 	int depthLevel;
 };
 
-void copyCJsonValue(int tagType, Serializer &rdser, WrSerializer &wrser);
-
 }  // namespace reindexer
@@ -2,7 +2,7 @@
 #include <cstdlib>
 #include "core/payload/payloadtuple.h"
 #include "tagsmatcher.h"
-#include "tools/serializer.h"
+#include "tupledictionary.h"
 
 namespace reindexer {
 
@@ -10,7 +10,7 @@ JsonEncoder::JsonEncoder(const TagsMatcher& tagsMatcher, const JsonPrintFilter&
 
 void JsonEncoder::Encode(ConstPayload* pl, WrSerializer& wrSer) {
 	string_view tuple = getPlTuple(pl);
-	Serializer rdser(tuple);
+	TupleSerializer rdser(tuple, pl->Type().TupleDict());
 
 	for (int i = 0; i < pl->NumFields(); ++i) fieldsoutcnt_[i] = 0;
 	bool first = true;
@@ -18,7 +18,7 @@ void JsonEncoder::Encode(ConstPayload* pl, WrSerializer& wrSer) {
 }
 
 void JsonEncoder::Encode(string_view tuple, WrSerializer& wrSer) {
-	Serializer rdser(tuple);
+	TupleSerializer rdser(tuple, nullptr);
 
 	bool first = true;
 	encodeJson(nullptr, rdser, wrSer, first, true);
@@ -42,7 +42,7 @@ void JsonEncoder::Encode(ConstPayload* pl, WrSerializer& wrSer, IJsonEncoderData
 	wrSer.PutChar('}');
 }
 
-static inline void encodeValue(int tagType, Serializer& rdser, WrSerializer& wrser, bool visible) {
+static inline void encodeValue(int tagType, TupleSerializer& rdser, WrSerializer& wrser, bool visible) {
 	switch (tagType) {
 		case TAG_DOUBLE:
 			if (visible)
@@ -105,7 +105,7 @@ static void encodeKeyRef(WrSerializer& wrser, KeyRef kr, int tagType) {
 
 bool JsonEncoder::encodeJoinedItem(WrSerializer& wrSer, ConstPayload& pl) {
 	string_view tuple = getPlTuple(&pl);
-	Serializer rdser(tuple.data(), tuple.length());
+	TupleSerializer rdser(tuple, pl.Type().TupleDict());
 
 	bool first = true;
 	for (int i = 0; i < pl.NumFields(); ++i) fieldsoutcnt_[i] = 0;
@@ -138,7 +138,7 @@ void JsonEncoder::encodeJoinedItems(WrSerializer& wrSer, IJsonEncoderDatasourceW
 	wrSer.PutChar(']');
 }
 
-bool JsonEncoder::encodeJson(ConstPayload* pl, Serializer& rdser, WrSerializer& wrser, bool& first, bool visible) {
+bool JsonEncoder::encodeJson(ConstPayload* pl, TupleSerializer& rdser, WrSerializer& wrser, bool& first, bool visible) {
 	ctag tag = rdser.GetVarUint();
 	int tagType = tag.Type();
 
@@ -7,7 +7,7 @@ namespace reindexer {
 
 class TagsMatcher;
 class WrSerializer;
-class Serializer;
+class TupleSerializer;
 
 class IJsonEncoderDatasourceWithJoins {
 public:
@@ -30,7 +30,7 @@ public:
 	void Encode(string_view tuple, WrSerializer &wrSer);
 
 protected:
-	bool encodeJson(ConstPayload *pl, Serializer &rdser, WrSerializer &wrser, bool &first, bool visible);
+	bool encodeJson(ConstPayload *pl, TupleSerializer &rdser, WrSerializer &wrser, bool &first, bool visible);
 	bool encodeJoinedItem(WrSerializer &wrSer, ConstPayload &pl);
 	void encodeJoinedItems(WrSerializer &wrSer, IJsonEncoderDatasourceWithJoins &ds, size_t joinedIdx, bool &first);
 
@@ -0,0 +1,144 @@
+#include "tupledictionary.h"
+#include "cjsondecoder.h"
+#include "ctag.h"
+#include "tools/customhash.h"
+#include "tools/errors.h"
+#include "tools/varint.h"
+
+namespace reindexer {
+
+// Visit string values of non indexed fields of tuple. Visitor gets range of value in tuple and resolved string
+template <typename Visitor>
+static void walkTag(ctag tag, TupleSerializer &rdser, Visitor &visit) {
+	if (tag.Field() >= 0) {
+		// Value is stored in payload field
+		if (tag.Type() == TAG_ARRAY) rdser.GetVarUint();
+		return;
+	}
+	switch (tag.Type()) {
+		case TAG_ARRAY: {
+			carraytag atag = rdser.GetUInt32();
+			for (int i = 0; i < atag.Count(); i++) {
+				ctag t = atag.Tag() != TAG_OBJECT ? atag.Tag() : rdser.GetVarUint();
+				walkTag(t, rdser, visit);
+			}
+			break;
+		}
+		case TAG_OBJECT:
+			for (ctag otag = rdser.GetVarUint(); otag.Type() != TAG_END; otag = rdser.GetVarUint()) walkTag(otag, rdser, visit);
+			break;
+		case TAG_STRING: {
+			size_t start = rdser.Pos();
+			string_view str = rdser.GetVString();
+			visit(start, str, rdser.Pos());
+			break;
+		}
+		default:
+			skipCjsonTag(tag, rdser);
+	}
+}
+
+template <typename Visitor>
+static void walkTuple(string_view tuple, const TupleDictionary *dict, Visitor visit) {
+	if (!tuple.size()) return;
+	TupleSerializer rdser(tuple, dict);
+	walkTag(rdser.GetVarUint(), rdser, visit);
+}
+
+static unsigned chunkOf(size_t idx, unsigned firstChunkBits) {
+	unsigned chunk = 0;
+	for (size_t n = (idx >> firstChunkBits) + 1; n > 1; n >>= 1) chunk++;
+	return chunk;
+}
+
+size_t TupleDictionary::hash_str::operator()(string_view str) const { return _Hash_bytes(str.data(), str.size()); }
+
+void TupleDictionary::Train(string_view tuple) {
+	walkTuple(tuple, this, [this](size_t, string_view str, size_t) {
+		if (str.size() < kMinStringLen || str.size() > kMaxStringLen || Size() >= kMaxStrings) return;
+		if (lookup_.find(str) != lookup_.end()) return;
+
+		size_t hash = hash_str()(str);
+		if (candidates_.size() >= kMaxCandidates) candidates_.clear();
+		if (++candidates_[hash] < kMinOccurences) return;
+		candidates_.erase(hash);
+		add(str);
+	});
+}
+
+string_view TupleDictionary::Compress(string_view tuple, WrSerializer &wrser) const {
+	if (!Size()) return tuple;
+
+	static const uint8_t refPrefix[kRefPrefixLen] = {0x80, 0x00};
+	size_t copied = 0;
+	wrser.Reset();
+	walkTuple(tuple, this, [&](size_t start, string_view str, size_t end) {
+		auto it = lookup_.find(str);
+		if (it == lookup_.end()) return;
+		wrser.Write(tuple.substr(copied, start - copied));
+		wrser.Write(string_view(reinterpret_cast<const char *>(refPrefix), kRefPrefixLen));
+		wrser.PutVarUint(it->second);
+		copied = end;
+	});
+	if (!copied) return tuple;
+
+	wrser.Write(tuple.substr(copied));
+	return wrser.Slice();
+}
+
+size_t TupleDictionary::UncompressedSize(string_view tuple) const {
+	size_t ret = tuple.size();
+	if (!Size()) return ret;
+
+	uint8_t lenBuf[16];
+	walkTuple(tuple, this, [&](size_t start, string_view str, size_t end) {
+		ret += uint32_pack(str.size(), lenBuf) + str.size();
+		ret -= end - start;
+	});
+	return ret;
+}
+
+const string &TupleDictionary::Get(uint32_t idx) const {
+	if (idx >= Size()) {
+		throw Error(errParseBin, "Reference to string %d is out of tuples dictionary of %d strings", int(idx), int(Size()));
+	}
+	unsigned chunk = chunkOf(idx, kFirstChunkBits);
+	return chunks_[chunk][idx - ((kFirstChunkSize << chunk) - kFirstChunkSize)];
+}
+
+void TupleDictionary::add(string_view str) {
+	uint32_t idx = size_.load(std::memory_order_relaxed);
+	unsigned chunk = chunkOf(idx, kFirstChunkBits);
+	size_t offset = idx - ((kFirstChunkSize << chunk) - kFirstChunkSize);
+	if (!offset) chunks_[chunk].reset(new string[kFirstChunkSize << chunk]);
+
+	string &s = chunks_[chunk][offset];
+	s.assign(str.data(), str.size());
+	dataSize_ += str.size();
+	lookup_.emplace(string_view(s), idx);
+	// String is published to readers after it's completely written
+	size_.store(idx + 1, std::memory_order_release);
+}
+
+size_t TupleDictionary::MemSize() const {
+	size_t ret = sizeof(*this) + dataSize_ + lookup_.heap_size() + candidates_.heap_size();
+	for (unsigned chunk = 0; chunk < kMaxChunks && chunks_[chunk]; chunk++) ret += (kFirstChunkSize << chunk) * sizeof(string);
+	return ret;
+}
+
+const string &TupleSerializer::getDictString() {
+	pos += TupleDictionary::kRefPrefixLen;
+	return dict_->Get(GetVarUint());
+}
+
+string_view TupleSerializer::GetVString() {
+	if (dict_ && TupleDictionary::IsRef(buf + pos, len - pos)) return getDictString();
+	return Serializer::GetVString();
+}
+
+p_string TupleSerializer::GetPVString() {
+	if (dict_ && TupleDictionary::IsRef(buf + pos, len - pos)) return p_string(&getDictString());
+	return Serializer::GetPVString();
+}
+
+}  // namespace reindexer
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "estl/flat_hash_map.h"
+#include "estl/string_view.h"
+#include "tools/serializer.h"
+
+namespace reindexer {
+
+using std::string;
+
+// Dictionary of frequent string values of non indexed fields of namespace. Tuples of compressed namespace contain references
+// to dictionary instead of repeated strings. Reference is encoded in place of varint length of string as non canonical
+// varint 0x80 0x00, followed by varuint index of string in dictionary, so it never clashes with plain string.
+// Strings are only appended to dictionary and are never moved, so KeyRefs to them are valid while dictionary exists.
+// Dictionary is modified under write lock of namespace, and is read concurrently by encoders of query results.
+class TupleDictionary {
+public:
+	typedef std::shared_ptr<TupleDictionary> Ptr;
+
+	TupleDictionary() = default;
+	TupleDictionary(const TupleDictionary &) = delete;
+	TupleDictionary &operator=(const TupleDictionary &) = delete;
+
+	// Count occurences of strings of tuple. Strings, which occur in several tuples, are added to dictionary
+	void Train(string_view tuple);
+	// Replace strings of tuple, which are contained in dictionary, by references. Returns tuple itself, if there are nothing to replace
+	string_view Compress(string_view tuple, WrSerializer &wrser) const;
+	// Size of tuple with references replaced by strings
+	size_t UncompressedSize(string_view tuple) const;
+
+	// Get string by index of reference
+	const string &Get(uint32_t idx) const;
+	size_t Size() const { return size_.load(std::memory_order_acquire); }
+	// Size of memory, used by dictionary
+	size_t MemSize() const;
+
+	static bool IsRef(const uint8_t *p, size_t len) { return len >= 2 && p[0] == 0x80 && p[1] == 0x00; }
+	static const size_t kRefPrefixLen = 2;
+
+	// Strings shorter than reference, and long texts are not interned
+	static const size_t kMinStringLen = 4;
+	static const size_t kMaxStringLen = 1024;
+	// Count of occurences of string, after which it is added to dictionary
+	static const uint32_t kMinOccurences = 3;
+	// Count of tracked candidates. Counters are reset, when this limit is reached
+	static const size_t kMaxCandidates = 1 << 16;
+	static const size_t kMaxStrings = 1 << 20;
+
+protected:
+	void add(string_view str);
+
+	// Strings are stored in chunks of growing size: chunk i contains kFirstChunkSize << i strings
+	static const unsigned kFirstChunkBits = 6;
+	static const size_t kFirstChunkSize = size_t(1) << kFirstChunkBits;
+	static const unsigned kMaxChunks = 15;
+
+	struct hash_str {
+		size_t operator()(string_view str) const;
+	};
+
+	std::unique_ptr<string[]> chunks_[kMaxChunks];
+	std::atomic<uint32_t> size_{0};
+	size_t dataSize_ = 0;
+	flat_hash_map<string_view, uint32_t, hash_str> lookup_;
+	// Counts of occurences of strings, which are not interned yet, by hash of string
+	flat_hash_map<size_t, uint32_t> candidates_;
+};
+
+// Reader of tuple, which resolves references to dictionary by GetVString and GetPVString. Dictionary could be null
+class TupleSerializer : public Serializer {
+public:
+	TupleSerializer(string_view tuple, const TupleDictionary *dict) : Serializer(tuple), dict_(dict) {}
+	string_view GetVString();
+	p_string GetPVString();
+
+protected:
+	const string &getDictString();
+
+	const TupleDictionary *dict_;
+};
+
+}  // namespace reindexer
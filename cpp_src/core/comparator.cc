@@ -1,4 +1,6 @@
 #include "core/comparator.h"
+#include <algorithm>
+#include "core/comparatorkernels.h"
 #include "core/payload/payloadiface.h"
 #include "query/querywhere.h"
 
@@ -8,11 +10,12 @@ Comparator::Comparator() : fields_(), cmpComposite(payloadType_, fields_) {}
 Comparator::~Comparator() {}
 
 Comparator::Comparator(CondType cond, KeyValueType type, const KeyValues &values, bool isArray, PayloadType payloadType,
-					   const FieldsSet &fields, void *rawData, const CollateOpts &collateOpts)
+					   const FieldsSet &fields, void *rawData, const CollateOpts &collateOpts, size_t rawDataSize)
 	: cond_(cond),
 	  type_(type),
 	  isArray_(isArray),
 	  rawData_(reinterpret_cast<uint8_t *>(rawData)),
+	  rawDataSize_(rawDataSize),
 	  collateOpts_(collateOpts),
 	  payloadType_(payloadType),
 	  fields_(fields),
@@ -58,6 +61,69 @@ void Comparator::Bind(PayloadType type, int field) {
 	}
 }
 
+// Size of block of column rows, compared at once
+const int kBatchSize = 64;
+// Column is compared by blocks, if at least 1 of kBatchDensity rows is expected to be compared
+const int kBatchDensity = 16;
+
+void Comparator::SetExpectMaxIterations(int expectedIterations, bool orderedRows) {
+	batch_ = false;
+	batchFirst_ = -1;
+	if (!rawData_ || !orderedRows || fields_.getTagsPathsLength() > 0) return;
+	if (size_t(expectedIterations) * kBatchDensity < rawDataSize_) return;
+
+	switch (cond_) {
+		case CondEq:
+		case CondLt:
+		case CondLe:
+		case CondGt:
+		case CondGe:
+		case CondRange:
+			break;
+		default:
+			return;
+	}
+	size_t valuesCount = (cond_ == CondRange) ? 2 : 1;
+	switch (type_) {
+		case KeyValueInt:
+			batch_ = cmpInt.values_.size() >= valuesCount;
+			break;
+		case KeyValueInt64:
+			batch_ = cmpInt64.values_.size() >= valuesCount;
+			break;
+		case KeyValueDouble:
+			batch_ = cmpDouble.values_.size() >= valuesCount;
+			break;
+		default:
+			break;
+	}
+}
+
+bool Comparator::compareBatch(int rowId) {
+	int first = rowId & ~(kBatchSize - 1);
+	if (first != batchFirst_) {
+		int count = std::min(kBatchSize, int(rawDataSize_) - first);
+		switch (type_) {
+			case KeyValueInt:
+				batchMask_ = CompareColumn(reinterpret_cast<const int *>(rawData_) + first, count, cond_, cmpInt.values_[0],
+										   cmpInt.values_[cmpInt.values_.size() - 1]);
+				break;
+			case KeyValueInt64:
+				batchMask_ = CompareColumn(reinterpret_cast<const int64_t *>(rawData_) + first, count, cond_, cmpInt64.values_[0],
+										   cmpInt64.values_[cmpInt64.values_.size() - 1]);
+				break;
+			case KeyValueDouble:
+				batchMask_ = CompareColumn(reinterpret_cast<const double *>(rawData_) + first, count, cond_, cmpDouble.values_[0],
+										   cmpDouble.values_[cmpDouble.values_.size() - 1]);
+				break;
+			default:
+				abort();
+		}
+		batchFirst_ = first;
+	}
+	return (batchMask_ >> (rowId - first)) & 1;
+}
+
 bool Comparator::Compare(const PayloadValue &data, int rowId) {
 	if (fields_.getTagsPathsLength() > 0) {
 		KeyRefs rhs;
@@ -71,7 +137,10 @@ bool Comparator::Compare(const PayloadValue &data, int rowId) {
 			if (compare(kr)) return true;
 		}
 	} else {
-		if (rawData_) return compare(rawData_ + rowId * sizeof_);
+		if (rawData_) {
+			if (batch_ && size_t(rowId) < rawDataSize_) return compareBatch(rowId);
+			return compare(rawData_ + rowId * sizeof_);
+		}
 
 		if (type_ == KeyValueComposite) {
 			return compare(&const_cast<PayloadValue &>(data));
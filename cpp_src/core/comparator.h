@@ -201,11 +201,15 @@ class Comparator {
 public:
 	Comparator();
 	Comparator(CondType cond, KeyValueType type, const KeyValues &values, bool isArray, PayloadType payloadType, const FieldsSet &fields,
-			   void *rawData = nullptr, const CollateOpts &collateOpts = CollateOpts());
+			   void *rawData = nullptr, const CollateOpts &collateOpts = CollateOpts(), size_t rawDataSize = 0);
 	~Comparator();
 
 	bool Compare(const PayloadValue &lhs, int rowId);
 	void Bind(PayloadType type, int field);
+	// Let comparator of column choose algorithm: compare rows one by one, or compare blocks of column by vectorized kernels
+	// @param expectedIterations - expected number of compared rows
+	// @param orderedRows - rows are compared in order of their ids
+	void SetExpectMaxIterations(int expectedIterations, bool orderedRows);
 
 protected:
 	bool compare(const KeyRef &kr) {
@@ -244,6 +248,7 @@ protected:
 		}
 	}
 
+	bool compareBatch(int rowId);
 	void setValues(const KeyValues &values);
 
 	ComparatorImpl<int> cmpInt;
@@ -257,8 +262,14 @@ protected:
 	size_t sizeof_ = 0;
 	bool isArray_ = false;
 	uint8_t *rawData_ = nullptr;
+	size_t rawDataSize_ = 0;
 	CollateOpts collateOpts_;
 
+	// Result of comparison of last block of column rows, starting from batchFirst_
+	bool batch_ = false;
+	int batchFirst_ = -1;
+	uint64_t batchMask_ = 0;
+
 	PayloadType payloadType_;
 	FieldsSet fields_;
 	ComparatorImpl<PayloadValue> cmpComposite;
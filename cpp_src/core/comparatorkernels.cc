@@ -0,0 +1,173 @@
+#include "core/comparatorkernels.h"
+#include <stdlib.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define REINDEX_WITH_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace reindexer {
+
+template <typename T>
+static uint64_t compareColumnScalar(const T *values, int count, CondType cond, T rhs1, T rhs2) {
+	uint64_t mask = 0;
+	switch (cond) {
+		case CondEq:
+			for (int i = 0; i < count; i++) mask |= uint64_t(values[i] == rhs1) << i;
+			break;
+		case CondLt:
+			for (int i = 0; i < count; i++) mask |= uint64_t(values[i] < rhs1) << i;
+			break;
+		case CondLe:
+			for (int i = 0; i < count; i++) mask |= uint64_t(values[i] <= rhs1) << i;
+			break;
+		case CondGt:
+			for (int i = 0; i < count; i++) mask |= uint64_t(values[i] > rhs1) << i;
+			break;
+		case CondGe:
+			for (int i = 0; i < count; i++) mask |= uint64_t(values[i] >= rhs1) << i;
+			break;
+		case CondRange:
+			for (int i = 0; i < count; i++) mask |= uint64_t(values[i] >= rhs1 && values[i] <= rhs2) << i;
+			break;
+		default:
+			abort();
+	}
+	return mask;
+}
+
+#ifdef REINDEX_WITH_AVX2_KERNELS
+
+static bool haveAVX2() {
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	return avx2;
+}
+
+// Integer kernels are built on top of 'greater than' and 'equal' comparisons: a >= b is !(b > a)
+__attribute__((target("avx2"))) static uint64_t compareColumnAVX2(const int *values, int count, CondType cond, int rhs1, int rhs2) {
+	const __m256i r1 = _mm256_set1_epi32(rhs1), r2 = _mm256_set1_epi32(rhs2);
+	uint64_t mask = 0;
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+		__m256i res;
+		switch (cond) {
+			case CondEq:
+				res = _mm256_cmpeq_epi32(v, r1);
+				break;
+			case CondLt:
+				res = _mm256_cmpgt_epi32(r1, v);
+				break;
+			case CondLe:
+				res = _mm256_andnot_si256(_mm256_cmpgt_epi32(v, r1), _mm256_set1_epi32(-1));
+				break;
+			case CondGt:
+				res = _mm256_cmpgt_epi32(v, r1);
+				break;
+			case CondGe:
+				res = _mm256_andnot_si256(_mm256_cmpgt_epi32(r1, v), _mm256_set1_epi32(-1));
+				break;
+			case CondRange:
+				res = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi32(r1, v), _mm256_cmpgt_epi32(v, r2)), _mm256_set1_epi32(-1));
+				break;
+			default:
+				abort();
+		}
+		mask |= uint64_t(unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(res)))) << i;
+	}
+	if (i < count) mask |= compareColumnScalar(values + i, count - i, cond, rhs1, rhs2) << i;
+	return mask;
+}
+
+__attribute__((target("avx2"))) static uint64_t compareColumnAVX2(const int64_t *values, int count, CondType cond, int64_t rhs1,
+																   int64_t rhs2) {
+	const __m256i r1 = _mm256_set1_epi64x(rhs1), r2 = _mm256_set1_epi64x(rhs2);
+	uint64_t mask = 0;
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+		__m256i res;
+		switch (cond) {
+			case CondEq:
+				res = _mm256_cmpeq_epi64(v, r1);
+				break;
+			case CondLt:
+				res = _mm256_cmpgt_epi64(r1, v);
+				break;
+			case CondLe:
+				res = _mm256_andnot_si256(_mm256_cmpgt_epi64(v, r1), _mm256_set1_epi64x(-1));
+				break;
+			case CondGt:
+				res = _mm256_cmpgt_epi64(v, r1);
+				break;
+			case CondGe:
+				res = _mm256_andnot_si256(_mm256_cmpgt_epi64(r1, v), _mm256_set1_epi64x(-1));
+				break;
+			case CondRange:
+				res = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi64(r1, v), _mm256_cmpgt_epi64(v, r2)), _mm256_set1_epi64x(-1));
+				break;
+			default:
+				abort();
+		}
+		mask |= uint64_t(unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(res)))) << i;
+	}
+	if (i < count) mask |= compareColumnScalar(values + i, count - i, cond, rhs1, rhs2) << i;
+	return mask;
+}
+
+// Ordered non signaling predicates: comparison with NaN is false, as in scalar code
+__attribute__((target("avx2"))) static uint64_t compareColumnAVX2(const double *values, int count, CondType cond, double rhs1,
+																   double rhs2) {
+	const __m256d r1 = _mm256_set1_pd(rhs1), r2 = _mm256_set1_pd(rhs2);
+	uint64_t mask = 0;
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m256d v = _mm256_loadu_pd(values + i);
+		__m256d res;
+		switch (cond) {
+			case CondEq:
+				res = _mm256_cmp_pd(v, r1, _CMP_EQ_OQ);
+				break;
+			case CondLt:
+				res = _mm256_cmp_pd(v, r1, _CMP_LT_OQ);
+				break;
+			case CondLe:
+				res = _mm256_cmp_pd(v, r1, _CMP_LE_OQ);
+				break;
+			case CondGt:
+				res = _mm256_cmp_pd(v, r1, _CMP_GT_OQ);
+				break;
+			case CondGe:
+				res = _mm256_cmp_pd(v, r1, _CMP_GE_OQ);
+				break;
+			case CondRange:
+				res = _mm256_and_pd(_mm256_cmp_pd(v, r1, _CMP_GE_OQ), _mm256_cmp_pd(v, r2, _CMP_LE_OQ));
+				break;
+			default:
+				abort();
+		}
+		mask |= uint64_t(unsigned(_mm256_movemask_pd(res))) << i;
+	}
+	if (i < count) mask |= compareColumnScalar(values + i, count - i, cond, rhs1, rhs2) << i;
+	return mask;
+}
+
+#define COMPARE_COLUMN(values, count, cond, rhs1, rhs2) \
+	(haveAVX2() ? compareColumnAVX2(values, count, cond, rhs1, rhs2) : compareColumnScalar(values, count, cond, rhs1, rhs2))
+#else
+#define COMPARE_COLUMN(values, count, cond, rhs1, rhs2) compareColumnScalar(values, count, cond, rhs1, rhs2)
+#endif
+
+uint64_t CompareColumn(const int *values, int count, CondType cond, int rhs1, int rhs2) {
+	return COMPARE_COLUMN(values, count, cond, rhs1, rhs2);
+}
+
+uint64_t CompareColumn(const int64_t *values, int count, CondType cond, int64_t rhs1, int64_t rhs2) {
+	return COMPARE_COLUMN(values, count, cond, rhs1, rhs2);
+}
+
+uint64_t CompareColumn(const double *values, int count, CondType cond, double rhs1, double rhs2) {
+	return COMPARE_COLUMN(values, count, cond, rhs1, rhs2);
+}
+
+}  // namespace reindexer
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include "core/type_consts.h"
+
+namespace reindexer {
+
+// Vectorized kernels for comparison of column of scalar values with condition.
+// Bit i of result mask is set, if values[i] matches condition. count must be not greater than 64
+// Only CondEq, CondLt, CondLe, CondGt, CondGe and CondRange are supported. rhs2 is used only by CondRange
+uint64_t CompareColumn(const int *values, int count, CondType cond, int rhs1, int rhs2);
+uint64_t CompareColumn(const int64_t *values, int count, CondType cond, int64_t rhs1, int64_t rhs2);
+uint64_t CompareColumn(const double *values, int count, CondType cond, double rhs1, double rhs2);
+
+}  // namespace reindexer
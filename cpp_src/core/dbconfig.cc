@@ -23,6 +23,21 @@ Error DBProfilingConfig::FromJSON(JsonValue &jvalue) {
 	return errOK;
 }
 
+Error DBSelectConfig::FromJSON(JsonValue &jvalue) {
+	try {
+		if (jvalue.getTag() == JSON_NULL) return errOK;
+		if (jvalue.getTag() != JSON_OBJECT) return Error(errParseJson, "Expected object in 'select' key");
+
+		for (auto elem : jvalue) {
+			parseJsonField("parallelism", parallelism, elem, 0, 1024);
+			parseJsonField("parallel_scan_threshold", parallelScanThreshold, elem, 0, INT_MAX);
+		}
+	} catch (const Error &err) {
+		return err;
+	}
+	return errOK;
+}
+
 Error DBLoggingConfig::FromJSON(JsonValue &jvalue) {
 	try {
 		if (jvalue.getTag() == JSON_NULL) return errOK;
@@ -47,4 +62,29 @@ Error DBLoggingConfig::FromJSON(JsonValue &jvalue) {
 	return errOK;
 }
 
+Error DBNamespacesConfig::FromJSON(JsonValue &jvalue) {
+	try {
+		if (jvalue.getTag() == JSON_NULL) return errOK;
+		if (jvalue.getTag() != JSON_ARRAY) return Error(errParseJson, "Expected array in 'namespaces' key");
+
+		for (auto elem : jvalue) {
+			auto &subv = elem->value;
+			if (subv.getTag() != JSON_OBJECT) {
+				return Error(errParseJson, "Expected object in 'namespaces' array element");
+			}
+
+			string name;
+			bool compress = false;
+			for (auto subelem : subv) {
+				parseJsonField("namespace", name, subelem);
+				parseJsonField("compress_tuples", compress, subelem);
+			}
+			compressTuples.insert({name, compress});
+		}
+	} catch (const Error &err) {
+		return err;
+	}
+	return errOK;
+}
+
 }  // namespace reindexer
\ No newline at end of file
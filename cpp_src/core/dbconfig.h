@@ -16,9 +16,23 @@ struct DBProfilingConfig {
 	bool memStats = false;
 };
 
+struct DBSelectConfig {
+	Error FromJSON(JsonValue &v);
+	// Max number of threads to execute one query. 0 - number of CPU cores
+	int parallelism = 1;
+	// Min number of items to scan, to execute query in parallel
+	size_t parallelScanThreshold = 100000;
+};
+
 struct DBLoggingConfig {
 	Error FromJSON(JsonValue &v);
 	std::unordered_map<std::string, int> logQueries;
 };
 
+struct DBNamespacesConfig {
+	Error FromJSON(JsonValue &v);
+	// Compress tuples of non indexed fields by dictionary of frequent strings. Namespace "*" sets default for all namespaces
+	std::unordered_map<std::string, bool> compressTuples;
+};
+
 }  // namespace reindexer
\ No newline at end of file
@@ -44,14 +44,16 @@ public:
 	using base_idset::shrink_to_fit;
 	using base_idset::back;
 	using base_idset::heap_size;
+	using base_idset::is_hdata;
 
 	iterator begin() { return base_idset::begin(); }
 	iterator end() { return base_idset::end(); }
 
 	enum EditMode {
-		Ordered,   // Keep idset ordered, and ready to select (insert is slow O(logN)+O(N))
-		Auto,	  // Prepare idset for fast ordering by commit (insert is fast O(logN))
-		Unordered  // Just add id, commit and erase is impossible
+		Ordered,    // Keep idset ordered, and ready to select (insert is slow O(logN)+O(N))
+		Auto,       // Prepare idset for fast ordering by commit (insert is fast O(logN))
+		Unordered,  // Just add id, commit and erase is impossible
+		Ascending   // Ids are added in ascending order (bulk load): append them to plain idset without building btree
 	};
 
 	void Add(IdType id, EditMode editMode) {
@@ -85,9 +87,11 @@ public:
 	typedef shared_ptr<IdSet> Ptr;
 	IdSet() {}
 	IdSet(const IdSet &other) : IdSetPlain(other), set_(!other.set_ ? nullptr : new base_idsetset(*other.set_)) {}
+	// Move keeps heap buffer with sorted ids, which are stored after size() of idset
+	IdSet(IdSet &&other) noexcept : IdSetPlain(std::move(other)), set_(std::move(other.set_)) {}
 	IdSet &operator=(IdSet &&other) noexcept {
 		if (&other != this) {
-			IdSetPlain::operator=(other);
+			IdSetPlain::operator=(std::move(other));
 			set_ = std::move(other.set_);
 		}
 		return *this;
@@ -99,6 +103,13 @@ public:
 			return;
 		}
 
+		// Ids, which are added in ascending order on load from storage, are just appended to sorted plain idset:
+		// there is no need to build btree, and to convert it back to plain idset on commit
+		if (editMode == Ascending && !set_ && (!size() || back() < id)) {
+			push_back(id);
+			return;
+		}
+
 		if (int(size()) >= kMaxPlainIdsetSize && !set_ && editMode == Auto) {
 			set_.reset(new base_idsetset);
 			set_->insert(begin(), end());
@@ -133,6 +144,12 @@ public:
 	}
 
 	int Erase(IdType id) {
+		// Large plain idset, built by appends, is converted to btree, so deletes will not move tail of idset
+		if (int(size()) >= kMaxPlainIdsetSize && !set_) {
+			set_.reset(new base_idsetset);
+			set_->insert(begin(), end());
+		}
+
 		if (!set_) {
 			auto d = std::equal_range(begin(), end(), id);
 			base_idset::erase(d.first, d.second);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "core/idset.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace reindexer {
+
+// Dense bitmap of ids in range [minId, maxId]. Union of many sorted idsets through bitmap
+// takes O(N + range/64) steps, instead of O(N*K) steps of K-way merge
+// It is only a temporary structure for merge of idsets: keys of indexes are still storing ids in IdSet,
+// and intersections are still done id by id by SelectIterator
+class IdSetBitmap {
+public:
+	IdSetBitmap(IdType minId, IdType maxId) : base_(minId), words_((size_t(maxId) - size_t(minId)) / 64 + 1, 0) {}
+
+	// Bitmap is worth to build, if it's size is not bigger than size of idsets
+	static bool IsDense(IdType minId, IdType maxId, size_t idsCount) {
+		return minId <= maxId && (size_t(maxId) - size_t(minId)) / 64 + 1 <= idsCount;
+	}
+
+	void Add(IdType id) {
+		size_t pos = size_t(id - base_);
+		words_[pos / 64] |= uint64_t(1) << (pos % 64);
+	}
+	template <typename InputIt>
+	void Add(InputIt first, InputIt last) {
+		for (; first != last; ++first) Add(*first);
+	}
+
+	size_t Count() const {
+		size_t cnt = 0;
+		for (auto w : words_) cnt += popcount(w);
+		return cnt;
+	}
+
+	// Append ids of bitmap to idset in ascending order
+	void CopyTo(IdSet &ids) const {
+		ids.reserve(ids.size() + Count());
+		for (size_t i = 0; i < words_.size(); i++) {
+			for (uint64_t w = words_[i]; w; w &= w - 1) {
+				ids.Add(base_ + IdType(i * 64 + ctz(w)), IdSet::Unordered);
+			}
+		}
+	}
+
+protected:
+	static int popcount(uint64_t w) {
+#ifdef _MSC_VER
+		return int(__popcnt64(w));
+#else
+		return __builtin_popcountll(w);
+#endif
+	}
+	static int ctz(uint64_t w) {
+#ifdef _MSC_VER
+		unsigned long idx;
+		_BitScanForward64(&idx, w);
+		return int(idx);
+#else
+		return __builtin_ctzll(w);
+#endif
+	}
+
+	IdType base_;
+	std::vector<uint64_t> words_;
+};
+
+}  // namespace reindexer
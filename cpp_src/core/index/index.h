@@ -1,7 +1,10 @@
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include "core/idset.h"
+#include "core/index/indexstats.h"
 #include "core/index/keyentry.h"
 #include "core/indexopts.h"
 #include "core/keyvalue/keyvalue.h"
@@ -24,6 +27,8 @@ public:
 	};
 	using KeyEntry = reindexer::KeyEntry<IdSet>;
 	using KeyEntryPlain = reindexer::KeyEntry<IdSetPlain>;
+	// Visitor of index keys. Returns false to stop visiting
+	using KeyVisitor = std::function<bool(const KeyRef& key, const IdSetRef& ids)>;
 
 	Index(IndexType type, const string& name, const IndexOpts& opts = IndexOpts(), const PayloadType payloadType = PayloadType(),
 		  const FieldsSet& fields = FieldsSet());
@@ -44,6 +49,11 @@ public:
 	virtual Index* Clone() = 0;
 	virtual void Configure(const string&) {}
 	virtual bool IsOrdered() const { return false; }
+	// Visit keys of index with ids of items, which have them. Ordered index visits keys in ascending order, or descending if reverse
+	// Returns false, if index has no map of keys to ids
+	virtual bool VisitKeys(const KeyVisitor&, bool /*reverse*/) { return false; }
+	// Statistics of keys, which are collected on commit of index. Could be outdated or null
+	IndexStats::Ptr Stats() const { return std::atomic_load(&stats_); }
 	virtual IndexMemStat GetMemStat() = 0;
 	void UpdatePayloadType(const PayloadType payloadType) { payloadType_ = payloadType; }
 
@@ -58,6 +68,8 @@ public:
 	void SetOpts(const IndexOpts& opts) { opts_ = opts; }
 	void SetFields(const FieldsSet& fields) { fields_ = fields; }
 	SortType SortId() const { return sortId_; }
+	// Ids are upserted in ascending order by bulk load from storage
+	void SetBulkLoad(bool bulkLoad) { bulkLoad_ = bulkLoad; }
 
 protected:
 	// Index type. Can be one of enum IndexType
@@ -74,6 +86,10 @@ protected:
 	mutable PayloadType payloadType_;
 	// Fields in index. Valid only for composite indexes
 	FieldsSet fields_;
+	// Statistics of keys. Replaced atomically, since selects are reading it without lock of commit
+	IndexStats::Ptr stats_;
+	// Mode of upserting ids to idsets of keys
+	bool bulkLoad_ = false;
 };
 
 }  // namespace reindexer
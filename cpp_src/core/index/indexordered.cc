@@ -1,5 +1,6 @@
 
 #include "indexordered.h"
+#include "core/indexdef.h"
 #include "tools/errors.h"
 #include "tools/logger.h"
 
@@ -8,7 +9,8 @@ namespace reindexer {
 template <typename T>
 KeyRef IndexOrdered<T>::Upsert(const KeyRef &key, IdType id) {
 	if (key.Type() == KeyValueEmpty) {
-		this->empty_ids_.Unsorted().Add(id, IdSet::Auto);
+		this->empty_ids_.Unsorted().Add(id, this->bulkLoad_ ? IdSet::Ascending : IdSet::Auto);
+		this->tracker_.markEmptyUpdated();
 		// Return invalid ref
 		return KeyRef();
 	}
@@ -18,7 +20,7 @@ KeyRef IndexOrdered<T>::Upsert(const KeyRef &key, IdType id) {
 
 	if (keyIt == this->idx_map.end() || !found)
 		keyIt = this->idx_map.insert(keyIt, {static_cast<typename T::key_type>(key), typename T::mapped_type()});
-	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
+	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : this->bulkLoad_ ? IdSet::Ascending : IdSet::Auto);
 	this->tracker_.markUpdated(this->idx_map, &*keyIt);
 
 	if (this->KeyType() == KeyValueString && this->opts_.GetCollateMode() != CollateNone) {
@@ -153,6 +155,11 @@ void IndexOrdered<T>::MakeSortOrders(UpdateSortedContext &ctx) {
 	for (auto it : ids2Sorts)
 		if (it != SortIdUnexists) totalIds++;
 
+	// Keep previous sort orders to translate Sorted idsets of not updated keys
+	vector<IdType> prevSortOrders;
+	bool remap = ctx.prevSortsValid() && this->sortId_ == ctx.getCurSortId();
+	if (remap) prevSortOrders.swap(this->sortOrders_);
+
 	this->sortId_ = ctx.getCurSortId();
 	this->sortOrders_.resize(totalIds);
 	size_t idx = 0;
@@ -187,6 +194,15 @@ void IndexOrdered<T>::MakeSortOrders(UpdateSortedContext &ctx) {
 		this->DumpKeys();
 		assert(0);
 	}
+
+	if (remap) {
+		auto &prev2Sorts = ctx.prevSorts2Sorts();
+		prev2Sorts.resize(prevSortOrders.size());
+		for (size_t i = 0; i < prevSortOrders.size(); i++) {
+			IdType id = prevSortOrders[i];
+			prev2Sorts[i] = id < int(ids2Sorts.size()) ? ids2Sorts[id] : SortIdUnexists;
+		}
+	}
 }
 
 template <typename T>
@@ -199,6 +215,16 @@ bool IndexOrdered<T>::IsOrdered() const {
 	return true;
 }
 
+template <typename T>
+bool IndexOrdered<T>::VisitKeys(const Index::KeyVisitor &visitor, bool reverse) {
+	if (!reverse) return IndexUnordered<T>::VisitKeys(visitor, reverse);
+	if (isComposite(this->Type())) return false;
+	for (auto it = this->idx_map.rbegin(); it != this->idx_map.rend(); ++it) {
+		if (!visitor(KeyRef(it->first), it->second.Sorted(0))) break;
+	}
+	return true;
+}
+
 template <typename KeyEntryT>
 static Index *IndexOrdered_New(IndexType type, const string &name, const IndexOpts &opts, const PayloadType payloadType,
 							   const FieldsSet &fields) {
@@ -20,6 +20,7 @@ public:
 	void MakeSortOrders(UpdateSortedContext &ctx) override;
 	Index *Clone() override;
 	bool IsOrdered() const override;
+	bool VisitKeys(const Index::KeyVisitor &visitor, bool reverse) override;
 
 protected:
 	template <typename U = T, typename std::enable_if<is_string_map_key<U>::value>::type * = nullptr>
@@ -0,0 +1,146 @@
+#include "core/index/indexstats.h"
+#include <algorithm>
+
+namespace reindexer {
+
+IndexStats::Builder::Builder(bool ordered, size_t keysCount, size_t idsCount, size_t emptyIdsCount, const CollateOpts &collateOpts)
+	: stats_(std::make_shared<IndexStats>()) {
+	stats_->ordered_ = ordered;
+	stats_->keysCount_ = keysCount;
+	stats_->idsCount_ = idsCount;
+	stats_->emptyIdsCount_ = emptyIdsCount;
+	stats_->collateOpts_ = collateOpts;
+	bucketIds_ = std::max(size_t(1), (idsCount + kHistogramBuckets - 1) / kHistogramBuckets);
+	if (ordered) stats_->histogram_.reserve(kHistogramBuckets + 1);
+}
+
+void IndexStats::Builder::Add(const KeyRef &key, size_t ids) {
+	if (!ids) return;
+	if (stats_->ordered_) {
+		if (stats_->histogram_.empty() && !curKeys_) stats_->min_ = KeyValue(key);
+		curIds_ += ids;
+		curKeys_++;
+		last_ = key;
+		// Bucket is closed on boundary of keys, so key with many ids forms own bucket
+		if (curIds_ >= bucketIds_) {
+			stats_->histogram_.push_back({KeyValue(key), curIds_, curKeys_});
+			curIds_ = curKeys_ = 0;
+		}
+		return;
+	}
+
+	auto cmp = [](const std::pair<size_t, KeyValue> &lhs, const std::pair<size_t, KeyValue> &rhs) { return lhs.first > rhs.first; };
+	if (mcv_.size() < kMostCommonValues) {
+		mcv_.push_back({ids, KeyValue(key)});
+		std::push_heap(mcv_.begin(), mcv_.end(), cmp);
+	} else if (ids > mcv_.front().first) {
+		std::pop_heap(mcv_.begin(), mcv_.end(), cmp);
+		mcv_.back() = {ids, KeyValue(key)};
+		std::push_heap(mcv_.begin(), mcv_.end(), cmp);
+	}
+}
+
+IndexStats::Ptr IndexStats::Builder::Build() {
+	if (curKeys_) {
+		stats_->histogram_.push_back({KeyValue(last_), curIds_, curKeys_});
+		curIds_ = curKeys_ = 0;
+	}
+
+	// Values are common, only if they have more ids than average key
+	size_t avgIds = stats_->keysCount_ ? stats_->idsCount_ / stats_->keysCount_ : 0;
+	for (auto &v : mcv_) {
+		if (v.first <= avgIds) continue;
+		stats_->mcv_.push_back({v.second, v.first});
+		stats_->mcvIdsCount_ += v.first;
+	}
+	return stats_;
+}
+
+double IndexStats::Estimate(const KeyValues &keys, CondType cond) const {
+	double total = double(idsCount_);
+	switch (cond) {
+		case CondEq:
+		case CondSet: {
+			double ret = 0;
+			for (auto &key : keys) ret += estimateKey(key);
+			return std::min(ret, total);
+		}
+		case CondAllSet: {
+			double ret = total;
+			for (auto &key : keys) ret = std::min(ret, estimateKey(key));
+			return ret;
+		}
+		case CondAny:
+			return total;
+		case CondEmpty:
+			return double(emptyIdsCount_);
+		case CondLt:
+		case CondLe:
+		case CondGt:
+		case CondGe:
+		case CondRange:
+			break;
+		default:
+			return total;
+	}
+
+	// Selectivity of range by unordered index is unknown, so it's taken as a third of keys
+	if (keys.empty() || histogram_.empty()) return total / 3;
+
+	switch (cond) {
+		case CondLt:
+			return idsBefore(keys[0], false);
+		case CondLe:
+			return idsBefore(keys[0], true);
+		case CondGt:
+			return total - idsBefore(keys[0], true);
+		case CondGe:
+			return total - idsBefore(keys[0], false);
+		default:
+			if (keys.size() != 2) return total / 3;
+			return std::max(0.0, idsBefore(keys[1], true) - idsBefore(keys[0], false));
+	}
+}
+
+double IndexStats::estimateKey(const KeyValue &key) const {
+	for (auto &v : mcv_) {
+		if (v.first.Compare(key, collateOpts_) == 0) return double(v.second);
+	}
+
+	if (!histogram_.empty()) {
+		if (key.Compare(min_, collateOpts_) < 0) return 0;
+		for (auto &b : histogram_) {
+			if (key.Compare(b.upper, collateOpts_) <= 0) return double(b.ids) / b.keys;
+		}
+		return 0;
+	}
+
+	size_t keys = keysCount_ > mcv_.size() ? keysCount_ - mcv_.size() : 1;
+	return double(idsCount_ - mcvIdsCount_) / keys;
+}
+
+double IndexStats::idsBefore(const KeyValue &key, bool inclusive) const {
+	if (key.Compare(min_, collateOpts_) < 0 || (!inclusive && key.Compare(min_, collateOpts_) == 0)) return 0;
+
+	bool numeric = key.Type() == KeyValueInt || key.Type() == KeyValueInt64 || key.Type() == KeyValueDouble;
+	double ret = 0;
+	const KeyValue *lower = &min_;
+	for (auto &b : histogram_) {
+		int res = key.Compare(b.upper, collateOpts_);
+		if (res > 0 || (res == 0 && inclusive)) {
+			ret += b.ids;
+			lower = &b.upper;
+			continue;
+		}
+		// Key is inside of bucket: interpolate numeric keys linearly, and take half of bucket for others
+		double part = 0.5;
+		if (numeric) {
+			double lo = lower->As<double>(), hi = b.upper.As<double>(), k = key.As<double>();
+			part = hi > lo ? std::min(1.0, std::max(0.0, (k - lo) / (hi - lo))) : 0.5;
+		}
+		return ret + b.ids * part;
+	}
+	return ret;
+}
+
+}  // namespace reindexer
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "core/indexopts.h"
+#include "core/keyvalue/keyvalue.h"
+#include "core/type_consts.h"
+
+namespace reindexer {
+
+// Statistics of distribution of ids by keys of index. Query planner estimates count of items, which are matched by conditions,
+// before selecting of idsets. Statistics are immutable and shared by selects, they are rebuilt after significant changes of index
+class IndexStats {
+public:
+	typedef std::shared_ptr<const IndexStats> Ptr;
+
+	// Builder of statistics. Keys of ordered index must be added in ascending order
+	class Builder {
+	public:
+		Builder(bool ordered, size_t keysCount, size_t idsCount, size_t emptyIdsCount, const CollateOpts &collateOpts);
+		void Add(const KeyRef &key, size_t ids);
+		Ptr Build();
+
+	protected:
+		std::shared_ptr<IndexStats> stats_;
+		// Target count of ids in bucket of histogram
+		size_t bucketIds_ = 0;
+		size_t curIds_ = 0, curKeys_ = 0;
+		// Last added key. It's valid during build, since keys are owned by index
+		KeyRef last_;
+		// Min-heap of most common values by count of ids
+		std::vector<std::pair<size_t, KeyValue>> mcv_;
+	};
+
+	// Estimated count of ids, which are matched by condition
+	double Estimate(const KeyValues &keys, CondType cond) const;
+
+	// Count of different keys
+	size_t KeysCount() const { return keysCount_; }
+	// Total count of ids in all keys. Array index can contain the same id in several keys
+	size_t IdsCount() const { return idsCount_; }
+	bool IsOrdered() const { return ordered_; }
+
+	static const size_t kHistogramBuckets = 64;
+	static const size_t kMostCommonValues = 16;
+
+protected:
+	struct Bucket {
+		// Max key of bucket. Bucket contains keys in range (upper key of previous bucket, upper]
+		KeyValue upper;
+		size_t ids;
+		size_t keys;
+	};
+
+	double estimateKey(const KeyValue &key) const;
+	// Estimated count of ids of keys less than key (or equal, if inclusive)
+	double idsBefore(const KeyValue &key, bool inclusive) const;
+
+	bool ordered_ = false;
+	size_t keysCount_ = 0;
+	size_t idsCount_ = 0;
+	size_t emptyIdsCount_ = 0;
+	CollateOpts collateOpts_;
+	// Equi-depth histogram of ordered index: each bucket contains approximately the same count of ids
+	KeyValue min_;
+	std::vector<Bucket> histogram_;
+	// Most common values of unordered index with counts of ids
+	std::vector<std::pair<KeyValue, size_t>> mcv_;
+	size_t mcvIdsCount_ = 0;
+};
+
+}  // namespace reindexer
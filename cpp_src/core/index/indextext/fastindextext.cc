@@ -24,41 +24,36 @@ const int kStemProcDecrease = 15;
 
 const int kDigitUtfSizeof = 1;
 
+// Minimal count of documents in delta segment to merge it into main segment
+const int kMinDeltaVDocsToMerge = 1000;
+// Delta segment is merged into main segment by full build, when it contains more than 1/kDeltaVDocsMergeRatio of all documents
+const int kDeltaVDocsMergeRatio = 16;
+
 using std::thread;
 using std::chrono::duration_cast;
 using std::chrono::milliseconds;
 using std::chrono::high_resolution_clock;
 
 template <typename T>
-void FastIndexText<T>::buildTyposMap() {
+void FastIndexText<T>::buildTyposMap(Segment &seg) {
 	if (!GetConfig()->maxTyposInWord) {
 		return;
 	}
 
 	typos_context tctx[kMaxTyposInWord];
-	auto &typos = typos_;
-	typos_.clear();
-	typos_.reserve(words_.size() * (10 >> (GetConfig()->maxTyposInWord - 1)) / 2,
-				   words_.size() * 5 * (10 >> (GetConfig()->maxTyposInWord - 1)));
-	for (size_t wordId = 0; wordId < words_.size(); wordId++) {
-		mktypos(tctx, suffixes_.word_at(wordId), GetConfig()->maxTyposInWord, GetConfig()->maxTypoLen,
+	auto &typos = seg.typos_;
+	typos.clear();
+	typos.reserve(seg.words_.size() * (10 >> (GetConfig()->maxTyposInWord - 1)) / 2,
+				  seg.words_.size() * 5 * (10 >> (GetConfig()->maxTyposInWord - 1)));
+	for (size_t wordId = 0; wordId < seg.words_.size(); wordId++) {
+		mktypos(tctx, seg.suffixes_.word_at(wordId), GetConfig()->maxTyposInWord, GetConfig()->maxTypoLen,
 				[&typos, wordId](const string &typo, int) { typos.emplace(typo, wordId); });
 	}
-	typos_.shrink_to_fit();
+	typos.shrink_to_fit();
 }
 
 template <typename T>
 void FastIndexText<T>::buildWordsMap(fast_hash_map<string, WordEntry> &words_um) {
-	int maxIndexWorkers = !this->opts_.IsDense() ? std::thread::hardware_concurrency() : 0;
-	if (!maxIndexWorkers) maxIndexWorkers = 1;
-	if (maxIndexWorkers > 8) maxIndexWorkers = 8;
-
-	struct context {
-		fast_hash_map<string, WordEntry> words_um;
-		std::thread thread;
-	};
-	unique_ptr<context[]> ctxs(new context[maxIndexWorkers]);
-
 	// buffer strings, for printing non text fields
 	vector<unique_ptr<string>> bufStrs;
 	// array with pointers to docs fields text
@@ -67,6 +62,7 @@ void FastIndexText<T>::buildWordsMap(fast_hash_map<string, WordEntry> &words_um)
 	this->vdocs_.reserve(this->idx_map.size());
 	vdocsTexts.reserve(this->idx_map.size());
 	for (auto &doc : this->idx_map) {
+		docsVDocs_.emplace(&doc.second, this->vdocs_.size());
 #ifdef REINDEX_FT_EXTRA_DEBUG
 		this->vdocs_.push_back({&doc.first, &doc.second, {}, {}});
 #else
@@ -75,26 +71,56 @@ void FastIndexText<T>::buildWordsMap(fast_hash_map<string, WordEntry> &words_um)
 		vdocsTexts.emplace_back(this->getDocFields(doc.first, bufStrs));
 	}
 
+	buildVDocsWords(words_um, 0, vdocsTexts);
+	calcAvgWordsCount();
+
+	// Check and print potential stop words
+	if (GetConfig()->logLevel >= LogInfo) {
+		string str;
+		for (auto &w : words_um) {
+			if (w.second.vids_.size() > this->vdocs_.size() / 5) str += w.first + " ";
+		}
+		logPrintf(LogInfo, "Potential stop words: %s", str.c_str());
+	}
+}
+
+// Parse texts of vdocs, starting from firstVDoc, and add their words to words_um
+template <typename T>
+void FastIndexText<T>::buildVDocsWords(fast_hash_map<string, WordEntry> &words_um, VDocIdType firstVDoc,
+									   vector<h_vector<pair<string_view, int>, 8>> &vdocsTexts) {
+	int maxIndexWorkers = !this->opts_.IsDense() ? std::thread::hardware_concurrency() : 0;
+	if (!maxIndexWorkers) maxIndexWorkers = 1;
+	if (maxIndexWorkers > 8) maxIndexWorkers = 8;
+	if (maxIndexWorkers > int(vdocsTexts.size())) maxIndexWorkers = std::max(int(vdocsTexts.size()), 1);
+
+	struct context {
+		fast_hash_map<string, WordEntry> words_um;
+		std::thread thread;
+	};
+	unique_ptr<context[]> ctxs(new context[maxIndexWorkers]);
+
 	int fieldscount = std::max(1, int(this->fields_.size()));
 	auto *cfg = GetConfig();
 	// build words map parallel in maxIndexWorkers threads
 	for (int t = 0; t < maxIndexWorkers; t++)
 		ctxs[t].thread = thread(
-			[this, &ctxs, &vdocsTexts, maxIndexWorkers, fieldscount, &cfg](int i) {
+			[this, &ctxs, &vdocsTexts, firstVDoc, maxIndexWorkers, fieldscount, &cfg](int i) {
 				auto ctx = &ctxs[i];
 				string word, str;
 				vector<pair<const char *, int>> wrds;
 				std::vector<string> virtualWords;
 				for (VDocIdType j = i; j < VDocIdType(vdocsTexts.size()); j += maxIndexWorkers) {
-					this->vdocs_[j].wordsCount.insert(this->vdocs_[j].wordsCount.begin(), fieldscount, 0.0);
-					this->vdocs_[j].mostFreqWordCount.insert(this->vdocs_[j].mostFreqWordCount.begin(), fieldscount, 0.0);
+					VDocIdType vid = firstVDoc + j;
+					auto &vdoc = this->vdocs_[vid];
+					vdoc.wordsCount.insert(vdoc.wordsCount.begin(), fieldscount, 0.0);
+					vdoc.mostFreqWordCount.insert(vdoc.mostFreqWordCount.begin(), fieldscount, 0.0);
 
 					for (size_t field = 0; field < vdocsTexts[j].size(); ++field) {
 						splitWithPos(vdocsTexts[j][field].first, str, wrds,this->cfg_->extraWordSymbols);
 						int rfield = vdocsTexts[j][field].second;
 						assert(rfield < fieldscount);
 
-						this->vdocs_[j].wordsCount[rfield] = wrds.size();
+						vdoc.wordsCount[rfield] = wrds.size();
 
 						for (auto w : wrds) {
 							word.assign(w.first);
@@ -107,13 +133,13 @@ void FastIndexText<T>::buildWordsMap(fast_hash_map<string, WordEntry> &words_um)
 								// idxIt->second.vids_.reserve(16);
 							}
 
-							int mfcnt = idxIt->second.vids_.Add(j, insertPos, rfield);
-							if (mfcnt > this->vdocs_[j].mostFreqWordCount[rfield]) {
-								this->vdocs_[j].mostFreqWordCount[rfield] = mfcnt;
+							int mfcnt = idxIt->second.vids_.Add(vid, insertPos, rfield);
+							if (mfcnt > vdoc.mostFreqWordCount[rfield]) {
+								vdoc.mostFreqWordCount[rfield] = mfcnt;
 							}
 
 							if (cfg->enableNumbersSearch && is_number(word)) {
-								buildVirtualWord(word, ctx->words_um, j, field, insertPos, virtualWords);
+								buildVirtualWord(word, ctx->words_um, vid, field, insertPos, virtualWords);
 							}
 						}
 					}
@@ -121,8 +147,8 @@ void FastIndexText<T>::buildWordsMap(fast_hash_map<string, WordEntry> &words_um)
 			},
 			t);
 
-	// If there was only 1 build thread. Just return it's build results
-	if (maxIndexWorkers == 1) {
+	// If there was only 1 build thread and no words yet. Just return it's build results
+	if (maxIndexWorkers == 1 && words_um.empty()) {
 		ctxs[0].thread.join();
 		words_um.swap(ctxs[0].words_um);
 	} else {
@@ -142,27 +168,24 @@ void FastIndexText<T>::buildWordsMap(fast_hash_map<string, WordEntry> &words_um)
 			ctxs[i].words_um = std::move(fast_hash_map<string, WordEntry>());
 		}
 	}
+}
 
-	// Calculate avg words count per document for bm25 calculation
-	if (this->vdocs_.size()) {
-		avgWordsCount_.resize(fieldscount);
-		for (int i = 0; i < fieldscount; i++) avgWordsCount_[i] = 0;
+// Calculate avg words count per document for bm25 calculation
+template <typename T>
+void FastIndexText<T>::calcAvgWordsCount() {
+	int fieldscount = std::max(1, int(this->fields_.size()));
+	size_t vdocsCount = 0;
+	avgWordsCount_.assign(fieldscount, 0);
 
-		for (auto &vdoc : this->vdocs_) {
-			for (int i = 0; i < fieldscount; i++) avgWordsCount_[i] += vdoc.wordsCount[i];
-		}
-		for (int i = 0; i < fieldscount; i++) avgWordsCount_[i] /= this->vdocs_.size();
+	for (auto &vdoc : this->vdocs_) {
+		if (!vdoc.keyEntry) continue;
+		for (int i = 0; i < fieldscount; i++) avgWordsCount_[i] += vdoc.wordsCount[i];
+		vdocsCount++;
 	}
-
-	// Check and print potential stop words
-	if (GetConfig()->logLevel >= LogInfo) {
-		string str;
-		for (auto &w : words_um) {
-			if (w.second.vids_.size() > this->vdocs_.size() / 5) str += w.first + " ";
-		}
-		logPrintf(LogInfo, "Potential stop words: %s", str.c_str());
+	if (vdocsCount) {
+		for (int i = 0; i < fieldscount; i++) avgWordsCount_[i] /= vdocsCount;
 	}
-}  // namespace reindexer
+}
 
 template <typename T>
 void FastIndexText<T>::buildVirtualWord(const string &word, fast_hash_map<string, WordEntry> &words_um, VDocIdType docType, int rfield,
@@ -227,55 +250,65 @@ void FastIndexText<T>::prepareVariants(FtSelectContext &ctx, FtDSLEntry &term, s
 template <typename T>
 void FastIndexText<T>::processVariants(FtSelectContext &ctx) {
 	TextSearchResults &res = ctx.rawResults.back();
+	Segment *segments[] = {&main_, &delta_};
 
 	for (const FtVariantEntry &variant : ctx.variants) {
 		if (variant.opts.op == OpAnd) {
 			ctx.foundWords.clear();
 		}
 		auto &tmpstr = variant.pattern;
-		//  Lookup current variant in suffixes array
-		auto keyIt = suffixes_.lower_bound(tmpstr);
 
 		int matched = 0, skipped = 0, vids = 0;
 		bool withPrefixes = (variant.opts.pref || variant.opts.suff);
 		bool withSuffixes = variant.opts.suff;
 
-		// Walk current variant in suffixes array and fill results
-		do {
-			if (keyIt == suffixes_.end()) break;
-
-			auto wordId = keyIt->second;
-			assert(wordId < WordIdType(words_.size()));
-			const string::value_type *word = suffixes_.word_at(wordId);
-
-			int16_t wordLength = suffixes_.word_len_at(wordId);
-
-			ptrdiff_t suffixLen = keyIt->first - word;
-			int matchLen = tmpstr.length();
-
-			if (!withSuffixes && suffixLen) continue;
-			if (!withPrefixes && wordLength != matchLen) break;
-
-			int matchDif = std::abs(long(wordLength - matchLen + suffixLen));
-			int proc = std::max(variant.proc - matchDif * kPrefixStepProc / std::max(matchLen / 3, 1),
-								suffixLen ? kSuffixMinProc : kPrefixMinProc);
-
-			auto it = ctx.foundWords.find(wordId);
-			if (it == ctx.foundWords.end() || it->second.first != ctx.rawResults.size() - 1) {
-				res.push_back({&words_[wordId].vids_, keyIt->first, proc, suffixes_.virtual_word_len(wordId)});
-				res.idsCnt_ += words_[wordId].vids_.size();
-				ctx.foundWords[wordId] = std::make_pair(ctx.rawResults.size() - 1, res.size() - 1);
-				if (GetConfig()->logLevel >= LogTrace)
-					logPrintf(LogTrace, " matched %s '%s' of word '%s', %d vids, %d%%", suffixLen ? "suffix" : "prefix", keyIt->first, word,
-							  int(words_[wordId].vids_.size()), proc);
-				matched++;
-				vids += words_[wordId].vids_.size();
-			} else {
-				if (ctx.rawResults[it->second.first][it->second.second].proc_ < proc)
-					ctx.rawResults[it->second.first][it->second.second].proc_ = proc;
-				skipped++;
-			}
-		} while ((keyIt++).lcp() >= int(tmpstr.length()));
+		// Word ids of delta segment are placed after word ids of main segment in foundWords
+		WordIdType wordIdOffset = 0;
+		for (Segment *seg : segments) {
+			if (!seg->words_.size()) continue;
+			auto &suffixes = seg->suffixes_;
+			auto &words = seg->words_;
+			//  Lookup current variant in suffixes array
+			auto keyIt = suffixes.lower_bound(tmpstr);
+
+			// Walk current variant in suffixes array and fill results
+			do {
+				if (keyIt == suffixes.end()) break;
+
+				auto wordId = keyIt->second;
+				assert(wordId < WordIdType(words.size()));
+				const string::value_type *word = suffixes.word_at(wordId);
+
+				int16_t wordLength = suffixes.word_len_at(wordId);
+
+				ptrdiff_t suffixLen = keyIt->first - word;
+				int matchLen = tmpstr.length();
+
+				if (!withSuffixes && suffixLen) continue;
+				if (!withPrefixes && wordLength != matchLen) break;
+
+				int matchDif = std::abs(long(wordLength - matchLen + suffixLen));
+				int proc = std::max(variant.proc - matchDif * kPrefixStepProc / std::max(matchLen / 3, 1),
+									suffixLen ? kSuffixMinProc : kPrefixMinProc);
+
+				auto it = ctx.foundWords.find(wordIdOffset + wordId);
+				if (it == ctx.foundWords.end() || it->second.first != ctx.rawResults.size() - 1) {
+					res.push_back({&words[wordId].vids_, keyIt->first, proc, suffixes.virtual_word_len(wordId)});
+					res.idsCnt_ += words[wordId].vids_.size();
+					ctx.foundWords[wordIdOffset + wordId] = std::make_pair(ctx.rawResults.size() - 1, res.size() - 1);
+					if (GetConfig()->logLevel >= LogTrace)
+						logPrintf(LogTrace, " matched %s '%s' of word '%s', %d vids, %d%%", suffixLen ? "suffix" : "prefix", keyIt->first,
+								  word, int(words[wordId].vids_.size()), proc);
+					matched++;
+					vids += words[wordId].vids_.size();
+				} else {
+					if (ctx.rawResults[it->second.first][it->second.second].proc_ < proc)
+						ctx.rawResults[it->second.first][it->second.second].proc_ = proc;
+					skipped++;
+				}
+			} while ((keyIt++).lcp() >= int(tmpstr.length()));
+			wordIdOffset += words.size();
+		}
 		if (GetConfig()->logLevel >= LogInfo)
 			logPrintf(LogInfo, "Lookup variant '%s' (%d%%), matched %d suffixes, with %d vids, skiped %d", tmpstr.c_str(), variant.proc,
 					  matched, vids, skipped);
@@ -285,32 +318,36 @@ void FastIndexText<T>::processVariants(FtSelectContext &ctx) {
 template <typename T>
 void FastIndexText<T>::processTypos(FtSelectContext &ctx, FtDSLEntry &term) {
 	TextSearchResults &res = ctx.rawResults.back();
+	Segment *segments[] = {&main_, &delta_};
 
 	typos_context tctx[kMaxTyposInWord];
-	auto &typos = typos_;
 	int matched = 0, skiped = 0, vids = 0;
 	mktypos(tctx, term.pattern, GetConfig()->maxTyposInWord, GetConfig()->maxTypoLen, [&](const string &typo, int tcount) {
-		auto typoRng = typos.equal_range(typo);
 		tcount = GetConfig()->maxTyposInWord - tcount;
-		for (auto typoIt = typoRng.first; typoIt != typoRng.second; typoIt++) {
-			auto wordId = typoIt->second;
-			assert(wordId < WordIdType(words_.size()));
-			// bool virtualWord = suffixes_.is_word_virtual(wordId);
-			uint8_t wordLength = suffixes_.word_len_at(wordId);
-			int proc = kTypoProc - tcount * kTypoStepProc / std::max((wordLength - tcount) / 3, 1);
-			auto it = ctx.foundWords.find(wordId);
-			if (it == ctx.foundWords.end()) {
-				res.push_back({&words_[wordId].vids_, typoIt->first, proc, suffixes_.virtual_word_len(wordId)});
-				res.idsCnt_ += words_[wordId].vids_.size();
-				ctx.foundWords.emplace(wordId, std::make_pair(ctx.rawResults.size() - 1, res.size() - 1));
-
-				if (GetConfig()->logLevel >= LogTrace)
-					logPrintf(LogTrace, " matched typo '%s' of word '%s', %d ids, %d%%", typoIt->first, suffixes_.word_at(wordId),
-							  int(words_[wordId].vids_.size()), proc);
-				++matched;
-				vids += words_[wordId].vids_.size();
-			} else
-				++skiped;
+		WordIdType wordIdOffset = 0;
+		for (Segment *seg : segments) {
+			auto typoRng = seg->typos_.equal_range(typo);
+			for (auto typoIt = typoRng.first; typoIt != typoRng.second; typoIt++) {
+				auto wordId = typoIt->second;
+				assert(wordId < WordIdType(seg->words_.size()));
+				// bool virtualWord = suffixes_.is_word_virtual(wordId);
+				uint8_t wordLength = seg->suffixes_.word_len_at(wordId);
+				int proc = kTypoProc - tcount * kTypoStepProc / std::max((wordLength - tcount) / 3, 1);
+				auto it = ctx.foundWords.find(wordIdOffset + wordId);
+				if (it == ctx.foundWords.end()) {
+					res.push_back({&seg->words_[wordId].vids_, typoIt->first, proc, seg->suffixes_.virtual_word_len(wordId)});
+					res.idsCnt_ += seg->words_[wordId].vids_.size();
+					ctx.foundWords.emplace(wordIdOffset + wordId, std::make_pair(ctx.rawResults.size() - 1, res.size() - 1));
+
+					if (GetConfig()->logLevel >= LogTrace)
+						logPrintf(LogTrace, " matched typo '%s' of word '%s', %d ids, %d%%", typoIt->first, seg->suffixes_.word_at(wordId),
+								  int(seg->words_[wordId].vids_.size()), proc);
+					++matched;
+					vids += seg->words_[wordId].vids_.size();
+				} else
+					++skiped;
+			}
+			wordIdOffset += seg->words_.size();
 		}
 	});
 	if (GetConfig()->logLevel >= LogInfo)
@@ -372,6 +409,9 @@ void FastIndexText<T>::mergeItaration(TextSearchResults &rawRes, vector<bool> &e
 				continue;
 			}
 
+			// Document was removed after build of segment
+			if (!this->vdocs_[vid].keyEntry) continue;
+
 			assert(vid < int(exists.size()));
 
 			int field = relid.pos[0].field();
@@ -559,10 +599,13 @@ Index *FastIndexText<T>::Clone() {
 template <typename T>
 IndexMemStat FastIndexText<T>::GetMemStat() {
 	auto ret = IndexUnordered<T>::GetMemStat();
-	ret.fulltextSize = typos_.heap_size() + suffixes_.heap_size();
+	ret.fulltextSize = 0;
 
-	for (auto &w : words_) {
-		ret.fulltextSize += sizeof(w) + w.vids_.heap_size();
+	for (Segment *seg : {&main_, &delta_}) {
+		ret.fulltextSize += seg->typos_.heap_size() + seg->suffixes_.heap_size();
+		for (auto &w : seg->words_) {
+			ret.fulltextSize += sizeof(w) + w.vids_.heap_size();
+		}
 	}
 	ret.fulltextSize += this->vdocs_.capacity() * sizeof(typename IndexText<T>::VDocEntry);
 	if (this->cache_ft_) ret.idsetCache = this->cache_ft_->GetMemStat();
@@ -572,9 +615,23 @@ IndexMemStat FastIndexText<T>::GetMemStat() {
 
 template <typename T>
 void FastIndexText<T>::Commit() {
-	words_.clear();
-	suffixes_.clear();
-	typos_.clear();
+	if (!needFullBuild_) {
+		// Small changes are indexed to delta segment. Large delta and removed documents are merged to main segment by full build
+		int maxDeltaVDocs = std::max(kMinDeltaVDocsToMerge, int(this->vdocs_.size()) / kDeltaVDocsMergeRatio);
+		int deltaVDocs = int(this->vdocs_.size()) - deltaFirstVDoc_ + int(newDocs_.size());
+		if (deltaVDocs <= maxDeltaVDocs && removedVDocs_ <= maxDeltaVDocs) {
+			commitDelta();
+			return;
+		}
+	}
+
+	this->vdocs_.clear();
+	main_.clear();
+	delta_.clear();
+	deltaWords_.clear();
+	docsVDocs_.clear();
+	newDocs_.clear();
+	removedVDocs_ = 0;
 	auto tm0 = high_resolution_clock::now();
 
 	// Step 1: parse all documents and build hash map of all unique words
@@ -588,65 +645,147 @@ void FastIndexText<T>::Commit() {
 		for (auto f : this->getDocFields(doc.first, bufStrs)) szCnt += f.first.length();
 	}
 
-	auto tm2 = high_resolution_clock::now();
+	auto tm1 = high_resolution_clock::now();
+
+	// Step 3: Build words, suffixes and typos of main segment
+	buildSegment(main_, words_um, true);
 
-	// Step 3: Build words array
-	suffixes_.reserve(words_um.size() * 20, words_um.size());
+	deltaFirstVDoc_ = this->vdocs_.size();
+	needFullBuild_ = false;
+
+	logPrintf(LogInfo, "FastIndexText::Commit elapsed %d ms total [ build words %d ms ], %dKB text size",
+			  int(duration_cast<milliseconds>(high_resolution_clock::now() - tm0).count()),
+			  int(duration_cast<milliseconds>(tm1 - tm0).count()), int(szCnt / 1024));
+}
+
+// Index new documents to delta segment, without rebuild of main segment
+template <typename T>
+void FastIndexText<T>::commitDelta() {
+	if (!newDocs_.size()) return;
+	auto tm0 = high_resolution_clock::now();
+
+	// Step 1: Add vdocs of new documents and parse them to words of delta segment
+	vector<unique_ptr<string>> bufStrs;
+	vector<h_vector<pair<string_view, int>, 8>> vdocsTexts;
+	VDocIdType firstVDoc = this->vdocs_.size();
+	vdocsTexts.reserve(newDocs_.size());
+	for (auto doc : newDocs_) {
+		docsVDocs_.emplace(&doc->second, this->vdocs_.size());
+#ifdef REINDEX_FT_EXTRA_DEBUG
+		this->vdocs_.push_back({&doc->first, &doc->second, {}, {}});
+#else
+		this->vdocs_.push_back({&doc->second, {}, {}});
+#endif
+		vdocsTexts.emplace_back(this->getDocFields(doc->first, bufStrs));
+	}
+	newDocs_.clear();
+
+	buildVDocsWords(deltaWords_, firstVDoc, vdocsTexts);
+	calcAvgWordsCount();
+
+	// Step 2: Rebuild delta segment. Words of delta are kept to add documents of next commits
+	buildSegment(delta_, deltaWords_, false);
+
+	logPrintf(LogInfo, "FastIndexText::commitDelta elapsed %d ms, [%d new docs, %d docs in delta, %d removed docs]",
+			  int(duration_cast<milliseconds>(high_resolution_clock::now() - tm0).count()), int(vdocsTexts.size()),
+			  int(this->vdocs_.size()) - deltaFirstVDoc_, removedVDocs_);
+}
+
+template <typename T>
+void FastIndexText<T>::buildSegment(Segment &seg, fast_hash_map<string, WordEntry> &words_um, bool releaseWords) {
+	seg.clear();
+	auto tm0 = high_resolution_clock::now();
+
+	// Step 1: Build words array
+	seg.suffixes_.reserve(words_um.size() * 20, words_um.size());
 	for (auto keyIt = words_um.begin(); keyIt != words_um.end(); keyIt++) {
-		WordIdType idx = words_.size();
+		WordIdType idx = seg.words_.size();
 		if (GetConfig()->enableNumbersSearch && keyIt->second.virtualWord) {
-			suffixes_.insert(keyIt->first, idx, kDigitUtfSizeof);
+			seg.suffixes_.insert(keyIt->first, idx, kDigitUtfSizeof);
 		} else {
-			suffixes_.insert(keyIt->first, idx);
+			seg.suffixes_.insert(keyIt->first, idx);
 		}
 		keyIt->second.vids_.Commit();
-		words_.emplace_back(PackedWordEntry());
+		seg.words_.emplace_back(PackedWordEntry());
 	}
 
-	// Step 4: Build suffixes array. It runs in parallel with next step
-	auto &suffixes = suffixes_;
-	auto tm3 = high_resolution_clock::now(), tm4 = high_resolution_clock::now();
-	thread sufBuildThread([&suffixes, &tm3]() {
+	// Step 2: Build suffixes array. It runs in parallel with next step
+	auto &suffixes = seg.suffixes_;
+	auto tm1 = high_resolution_clock::now(), tm2 = high_resolution_clock::now();
+	thread sufBuildThread([&suffixes, &tm1]() {
 		suffixes.build();
-		tm3 = high_resolution_clock::now();
+		tm1 = high_resolution_clock::now();
 	});
 
-	// Step 5: Normalize and sort idrelsets. It runs in parallel with next step
-	auto &words = words_;
+	// Step 3: Normalize and sort idrelsets. It runs in parallel with next step
+	auto &words = seg.words_;
 	size_t idsetcnt = 0;
-	thread idrelsetCommitThread([&words, &tm4, &idsetcnt, &words_um]() {
+	thread idrelsetCommitThread([&words, &tm2, &idsetcnt, &words_um, releaseWords]() {
 		auto wIt = words.begin();
 		for (auto keyIt = words_um.begin(); keyIt != words_um.end(); keyIt++, wIt++) {
 			// Pack idrelset
 			wIt->vids_.insert(wIt->vids_.end(), keyIt->second.vids_.begin(), keyIt->second.vids_.end());
-			keyIt->second.vids_.clear();
+			if (releaseWords) keyIt->second.vids_.clear();
 			wIt->vids_.shrink_to_fit();
 			idsetcnt += sizeof(*wIt) + wIt->vids_.heap_size();
 		}
-		tm4 = high_resolution_clock::now();
+		tm2 = high_resolution_clock::now();
 	});
 
 	// Wait for suf array build. It is neccessary for typos
 	sufBuildThread.join();
 
-	// Step 6: Build typos hash map
-	buildTyposMap();
+	// Step 4: Build typos hash map
+	buildTyposMap(seg);
 
-	auto tm5 = high_resolution_clock::now();
+	auto tm3 = high_resolution_clock::now();
 
 	idrelsetCommitThread.join();
 
-	auto tm6 = high_resolution_clock::now();
+	auto tm4 = high_resolution_clock::now();
 
-	logPrintf(LogInfo, "FastIndexText built with [%d uniq words, %d typos, %dKB text size, %dKB suffixarray size, %dKB idrelsets size]",
-			  int(words_um.size()), int(typos_.size()), int(szCnt / 1024), int(suffixes_.heap_size() / 1024), int(idsetcnt / 1024));
+	logPrintf(LogInfo, "FastIndexText %s segment built with [%d uniq words, %d typos, %dKB suffixarray size, %dKB idrelsets size]",
+			  &seg == &main_ ? "main" : "delta", int(words_um.size()), int(seg.typos_.size()), int(seg.suffixes_.heap_size() / 1024),
+			  int(idsetcnt / 1024));
 
 	logPrintf(LogInfo,
-			  "FastIndexText::Commit elapsed %d ms total [ build words %d ms, build typos %d ms | build suffixarry %d ms | sort "
-			  "idrelsets %d ms]",
-			  int(duration_cast<milliseconds>(tm6 - tm0).count()), int(duration_cast<milliseconds>(tm2 - tm0).count()),
-			  int(duration_cast<milliseconds>(tm5 - tm3).count()), int(duration_cast<milliseconds>(tm3 - tm2).count()),
-			  int(duration_cast<milliseconds>(tm4 - tm2).count()));
+			  "FastIndexText::buildSegment elapsed %d ms total [ build typos %d ms | build suffixarry %d ms | sort idrelsets %d ms]",
+			  int(duration_cast<milliseconds>(tm4 - tm0).count()), int(duration_cast<milliseconds>(tm3 - tm1).count()),
+			  int(duration_cast<milliseconds>(tm1 - tm0).count()), int(duration_cast<milliseconds>(tm2 - tm0).count()));
+}
+
+// Collect new and removed documents. Keys without ids will be erased from index map by commit of idsets
+template <typename T>
+void FastIndexText<T>::markUpdatedDocs() {
+	if (needFullBuild_) return;
+	if (this->tracker_.completeUpdated_) {
+		needFullBuild_ = true;
+		newDocs_.clear();
+		return;
+	}
+
+	for (auto keyIt : this->tracker_.updated_) {
+		bool removed = !keyIt->second.Unsorted().size();
+		auto docIt = docsVDocs_.find(&keyIt->second);
+		if (docIt != docsVDocs_.end()) {
+			if (removed) {
+				this->vdocs_[docIt->second].keyEntry = nullptr;
+				docsVDocs_.erase(docIt);
+				removedVDocs_++;
+			}
+		} else if (removed) {
+			newDocs_.erase(keyIt);
+		} else {
+			newDocs_.emplace(keyIt);
+		}
+	}
+}
+
+template <typename T>
+void FastIndexText<T>::Configure(const string &config) {
+	IndexText<T>::Configure(config);
+	// Words of built segments depend on config
+	needFullBuild_ = true;
 }
 
 template <typename T>
@@ -3,6 +3,7 @@
 #include "core/ft/config/ftfastconfig.h"
 #include "core/ft/typos.h"
 #include "core/selectfunc/ctx/ftctx.h"
+#include "estl/fast_hash_set.h"
 #include "indextext.h"
 
 namespace reindexer {
@@ -24,6 +25,7 @@ public:
 	Index* Clone() override;
 	IdSet::Ptr Select(FtCtx::Ptr fctx, FtDSLQuery& dsl) override final;
 	void Commit() override final;
+	void Configure(const string& config) override;
 	IndexMemStat GetMemStat() override;
 
 protected:
@@ -38,6 +40,23 @@ protected:
 
 	typedef int WordIdType;
 
+	// Words of documents set. Main segment contains all documents of last full build,
+	// delta segment - documents, which were added after it
+	struct Segment {
+		void clear() {
+			words_.clear();
+			typos_.clear();
+			suffixes_.clear();
+		}
+
+		// Key Entries corresponding to words. Addresable by WordIdType
+		vector<PackedWordEntry> words_;
+		// Typos map. typo string <-> original word id
+		flat_str_multimap<string, WordIdType> typos_;
+		// Suffix map. suffix <-> original word id
+		suffix_map<string, WordIdType> suffixes_;
+	};
+
 	struct TextSearchResult {
 		const PackedIdRelSet* vids_;
 		const char* pattern;
@@ -80,18 +99,32 @@ protected:
 	void processTypos(FtSelectContext&, FtDSLEntry&);
 
 	void buildWordsMap(fast_hash_map<string, WordEntry>& m);
+	void buildVDocsWords(fast_hash_map<string, WordEntry>& m, VDocIdType firstVDoc, vector<h_vector<pair<string_view, int>, 8>>& vdocsTexts);
 	void buildVirtualWord(const string& word, fast_hash_map<string, WordEntry>& words_um, VDocIdType docType, int rfield, size_t insertPos,
 						  std::vector<string>& output);
+	void buildSegment(Segment& seg, fast_hash_map<string, WordEntry>& words_um, bool releaseWords);
+	void calcAvgWordsCount();
 
-	void buildTyposMap();
+	void buildTyposMap(Segment& seg);
 	void initSearchers();
 
-	// Key Entries corresponding to words. Addresable by WordIdType
-	vector<PackedWordEntry> words_;
-	// Typos map. typo string <-> original word id
-	flat_str_multimap<string, WordIdType> typos_;
-	// Suffix map. suffix <-> original word id
-	suffix_map<string, WordIdType> suffixes_;
+	void markUpdatedDocs() override;
+	void commitDelta();
+
+	Segment main_;
+	Segment delta_;
+	// Words of delta segment. Delta segment is rebuilt from them on each commit
+	fast_hash_map<string, WordEntry> deltaWords_;
+	// Key entries of documents, which are indexed by main or delta segment <-> VDocIdType
+	fast_hash_map<const typename T::mapped_type*, VDocIdType> docsVDocs_;
+	// Keys of new documents, which will be indexed to delta segment on next commit
+	fast_hash_set<typename T::value_type*> newDocs_;
+	// First vdoc of delta segment
+	VDocIdType deltaFirstVDoc_ = 0;
+	// Count of removed vdocs. They are skipped by select till next full build
+	int removedVDocs_ = 0;
+	bool needFullBuild_ = true;
+
 	// Virtual documents, merged. Addresable by VDocIdType
 	vector<double> avgWordsCount_;
 };
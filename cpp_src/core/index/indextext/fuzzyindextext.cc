@@ -43,6 +43,7 @@ IdSet::Ptr FuzzyIndexText<T>::Select(FtCtx::Ptr fctx, FtDSLQuery& dsl) {
 template <typename T>
 void FuzzyIndexText<T>::Commit() {
 	vector<unique_ptr<string>> bufStrs;
+	this->vdocs_.clear();
 
 	for (auto& doc : this->idx_map) {
 		auto res = this->getDocFields(doc.first, bufStrs);
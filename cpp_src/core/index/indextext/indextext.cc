@@ -58,11 +58,11 @@ template <typename T>
 void IndexText<T>::Commit(const CommitContext &ctx) {
 	cache_ft_.reset(new FtIdSetCache());
 
+	if (ctx.phases() & CommitContext::MakeIdsets) markUpdatedDocs();
 	IndexUnordered<T>::Commit(ctx);
 
 	if (!(ctx.phases() & CommitContext::PrepareForSelect)) return;
 
-	vdocs_.clear();
 	Commit();
 }
 
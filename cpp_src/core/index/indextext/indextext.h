@@ -62,6 +62,9 @@ protected:
 
 	h_vector<pair<string_view, int>, 8> getDocFields(const typename T::key_type&, vector<unique_ptr<string>>& bufStrs);
 
+	// Called on commit of idsets, before keys without ids are erased from index map
+	virtual void markUpdatedDocs() {}
+
 	void initSearchers();
 
 	// Virtual documents, merged. Addresable by VDocIdType
@@ -8,7 +8,8 @@ namespace reindexer {
 template <typename T>
 KeyRef IndexUnordered<T>::Upsert(const KeyRef &key, IdType id) {
 	if (key.Type() == KeyValueEmpty) {
-		this->empty_ids_.Unsorted().Add(id, IdSet::Auto);
+		this->empty_ids_.Unsorted().Add(id, this->bulkLoad_ ? IdSet::Ascending : IdSet::Auto);
+		tracker_.markEmptyUpdated();
 		// Return invalid ref
 		return KeyRef();
 	}
@@ -16,8 +17,9 @@ KeyRef IndexUnordered<T>::Upsert(const KeyRef &key, IdType id) {
 	auto keyIt = find(key);
 	if (keyIt == this->idx_map.end())
 		keyIt = this->idx_map.insert({static_cast<typename T::key_type>(key), typename T::mapped_type()}).first;
-	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
+	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : this->bulkLoad_ ? IdSet::Ascending : IdSet::Auto);
 	tracker_.markUpdated(idx_map, &*keyIt);
+	updatesSinceStats_++;
 
 	if (this->KeyType() == KeyValueString && this->opts_.GetCollateMode() != CollateNone) {
 		return IndexStore<typename T::key_type>::Upsert(key, id);
@@ -32,6 +34,7 @@ void IndexUnordered<T>::Delete(const KeyRef &key, IdType id) {
 	if (key.Type() == KeyValueEmpty) {
 		delcnt = this->empty_ids_.Unsorted().Erase(id);
 		assert(delcnt);
+		tracker_.markEmptyUpdated();
 		return;
 	}
 
@@ -44,6 +47,7 @@ void IndexUnordered<T>::Delete(const KeyRef &key, IdType id) {
 			this->name_.c_str(), id, KeyRef(key).As<string>().c_str());
 
 	tracker_.markUpdated(idx_map, &*keyIt);
+	updatesSinceStats_++;
 
 	if (this->KeyType() == KeyValueString && this->opts_.GetCollateMode() != CollateNone) {
 		IndexStore<typename T::key_type>::Delete(key, id);
@@ -72,6 +76,15 @@ IdSetRef IndexUnordered<T>::Find(const KeyRef &key) {
 	return (res != idx_map.end()) ? res->second.Sorted(0) : IdSetRef();
 }
 
+template <typename T>
+bool IndexUnordered<T>::VisitKeys(const Index::KeyVisitor &visitor, bool /*reverse*/) {
+	if (isComposite(this->Type()) || isFullText(this->Type())) return false;
+	for (auto &k : idx_map) {
+		if (!visitor(KeyRef(k.first), k.second.Sorted(0))) break;
+	}
+	return true;
+}
+
 template <typename T>
 void IndexUnordered<T>::tryIdsetCache(const KeyValues &keys, CondType condition, SortType sortId,
 									  std::function<void(SelectKeyResult &)> selector, SelectKeyResult &res) {
@@ -208,19 +221,47 @@ void IndexUnordered<T>::Commit(const CommitContext &ctx) {
 		}
 		tracker_.completeUpdated_ = false;
 		tracker_.updated_.clear();
+		updateStats();
 	}
 }
 
+template <typename T>
+void IndexUnordered<T>::updateStats() {
+	// Statistics are rebuilt, after count of updates exceeds 1/kStatsRebuildFactor of ids
+	const size_t kStatsRebuildFactor = 8;
+	if (isComposite(this->Type()) || isFullText(this->Type())) return;
+	if (this->stats_ && updatesSinceStats_ * kStatsRebuildFactor <= this->stats_->IdsCount()) return;
+
+	size_t idsCount = 0;
+	for (auto &keyIt : idx_map) idsCount += keyIt.second.Unsorted().size();
+	IndexStats::Builder builder(this->IsOrdered(), idx_map.size(), idsCount, this->empty_ids_.Unsorted().size(), this->opts_.collateOpts_);
+	for (auto &keyIt : idx_map) builder.Add(KeyRef(keyIt.first), keyIt.second.Unsorted().size());
+	std::atomic_store(&this->stats_, builder.Build());
+	updatesSinceStats_ = 0;
+}
+
 template <typename T>
 void IndexUnordered<T>::UpdateSortedIds(const UpdateSortedContext &ctx) {
 	logPrintf(LogTrace, "IndexUnordered::UpdateSortedIds (%s) %d uniq keys, %d empty", this->name_.c_str(), int(this->idx_map.size()),
 			  this->empty_ids_.Unsorted().size());
+	// Sorted ids of keys, which were not updated since previous build, can be remapped to new sort orders
+	bool remap = !ctx.prevSorts2Sorts().empty();
+
 	// For all keys in index
 	for (auto &keyIt : this->idx_map) {
-		keyIt.second.UpdateSortedIds(ctx);
+		if (remap && !tracker_.isSortUpdated(&keyIt))
+			keyIt.second.RemapSortedIds(ctx);
+		else
+			keyIt.second.UpdateSortedIds(ctx);
 	}
 
-	this->empty_ids_.UpdateSortedIds(ctx);
+	if (remap && !tracker_.isSortEmptyUpdated())
+		this->empty_ids_.RemapSortedIds(ctx);
+	else
+		this->empty_ids_.UpdateSortedIds(ctx);
+
+	// Sort orders are built in ascending order of sort ids, so after the last one all Sorted idsets are valid
+	if (int(ctx.getCurSortId()) == ctx.getSortedIdxCount()) tracker_.commitSortUpdated();
 }
 
 template <typename T>
@@ -260,11 +301,11 @@ static Index *IndexUnordered_New(IndexType type, const string &name, const Index
 								 const FieldsSet &fields) {
 	switch (type) {
 		case IndexIntHash:
-			return new IndexUnordered<unordered_map<int, KeyEntryT>>(type, name, opts);
+			return new IndexUnordered<flat_hash_map<int, KeyEntryT>>(type, name, opts);
 		case IndexInt64Hash:
-			return new IndexUnordered<unordered_map<int64_t, KeyEntryT>>(type, name, opts);
+			return new IndexUnordered<flat_hash_map<int64_t, KeyEntryT>>(type, name, opts);
 		case IndexStrHash:
-			return new IndexUnordered<unordered_str_map<KeyEntryT>>(type, name, opts);
+			return new IndexUnordered<flat_unordered_str_map<KeyEntryT>>(type, name, opts);
 		case IndexCompositeHash:
 			return new IndexUnordered<unordered_payload_map<KeyEntryT>>(type, name, opts, payloadType, fields);
 		default:
@@ -288,5 +329,7 @@ template class IndexUnordered<btree_map<int64_t, Index::KeyEntry>>;
 template class IndexUnordered<btree_map<double, Index::KeyEntry>>;
 template class IndexUnordered<str_map<Index::KeyEntry>>;
 template class IndexUnordered<payload_map<Index::KeyEntry>>;
+// Fulltext indexes keep pointers to keys, so they use map with stable references
+template class IndexUnordered<unordered_str_map<Index::KeyEntryPlain>>;
 
 }  // namespace reindexer
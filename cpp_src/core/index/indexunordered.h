@@ -57,8 +57,11 @@ public:
 	IndexMemStat GetMemStat() override;
 	size_t Size() const override final { return idx_map.size(); }
 	IdSetRef Find(const KeyRef &key) override final;
+	bool VisitKeys(const Index::KeyVisitor &visitor, bool reverse) override;
 
 protected:
+	// Rebuild statistics of keys, if index was significantly changed since previous build
+	void updateStats();
 	void tryIdsetCache(const KeyValues &keys, CondType condition, SortType sortId, std::function<void(SelectKeyResult &)> selector,
 					   SelectKeyResult &res);
 
@@ -80,6 +83,8 @@ protected:
 	Index::KeyEntry empty_ids_;
 	// Tracker of updates
 	UpdateTracker<T> tracker_;
+	// Count of updates of keys since previous build of statistics
+	size_t updatesSinceStats_ = 0;
 };
 
 Index *IndexUnordered_New(IndexType type, const string &_name, const IndexOpts &opts, const PayloadType payloadType,
@@ -15,6 +15,11 @@ public:
 	virtual SortType getCurSortId() const = 0;
 	virtual const vector<SortType>& ids2Sorts() const = 0;
 	virtual vector<SortType>& ids2Sorts() = 0;
+	// Set of ordered indexes was not changed since previous build of sort orders
+	virtual bool prevSortsValid() const = 0;
+	// Map of previous sort orders of current sort id to new ones. Empty, if sort orders are built from scratch
+	virtual const vector<SortType>& prevSorts2Sorts() const = 0;
+	virtual vector<SortType>& prevSorts2Sorts() = 0;
 };
 
 template <typename IdSetT>
@@ -40,6 +45,26 @@ public:
 		}
 		std::sort(idsAsc.begin(), idsAsc.end());
 	}
+	// Ids of key were not changed since previous build of sort orders: translate sorted ids to new sort orders.
+	// Order is preserved for all ids, except moved by update of sort index, so full sort is rarely needed
+	void RemapSortedIds(const UpdateSortedContext& ctx) {
+		auto& prev2Sorts = ctx.prevSorts2Sorts();
+		// Sorted ids are kept only by heap buffer of idset: inline buffer is copied by move without them
+		if (ids_.is_hdata() || ids_.capacity() < (ctx.getSortedIdxCount() + 1) * ids_.size() || prev2Sorts.empty()) {
+			UpdateSortedIds(ctx);
+			return;
+		}
+
+		auto idsAsc = Sorted(ctx.getCurSortId());
+		bool sorted = true;
+		for (size_t idx = 0; idx < idsAsc.size(); idx++) {
+			assertf(idsAsc[idx] < int(prev2Sorts.size()) && prev2Sorts[idsAsc[idx]] != SortIdUnexists, "sortId=%d,prev2Sorts.size()=%d", idsAsc[idx],
+					int(prev2Sorts.size()));
+			idsAsc[idx] = prev2Sorts[idsAsc[idx]];
+			if (idx && idsAsc[idx] < idsAsc[idx - 1]) sorted = false;
+		}
+		if (!sorted) std::sort(idsAsc.begin(), idsAsc.end());
+	}
 
 	IdSetT ids_;
 };
@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include "core/keyvalue/key_string.h"
 #include "cpp-btree/btree_map.h"
+#include "estl/flat_hash_map.h"
 #include "estl/intrusive_ptr.h"
 #include "tools/customhash.h"
 #include "tools/customlocal.h"
@@ -40,6 +41,9 @@ struct hash_sptr {
 
 template <typename T1>
 using unordered_str_map = unordered_map<key_string, T1, hash_sptr, equal_sptr>;
+// Open addressing map of strings. Unlike unordered_str_map it moves elements on rehash
+template <typename T1>
+using flat_unordered_str_map = flat_hash_map<key_string, T1, hash_sptr, equal_sptr>;
 template <typename T1>
 using str_map = btree_map<key_string, T1, comparator_sptr>;
 
@@ -47,6 +51,8 @@ template <typename T>
 struct is_string_unord_map_key : std::false_type {};
 template <typename T1>
 struct is_string_unord_map_key<unordered_str_map<T1>> : std::true_type {};
+template <typename T1>
+struct is_string_unord_map_key<flat_unordered_str_map<T1>> : std::true_type {};
 template <typename T>
 struct is_string_map_key : std::false_type {};
 template <typename T1>
@@ -23,26 +23,30 @@ struct is_safe_iterators_map<unordered_str_map<T1>> : std::true_type {};
 template <typename T>
 class UpdateTracker {
 public:
-	UpdateTracker(const UpdateTracker<T> &other) : completeUpdated_(other.updated_.size() || other.completeUpdated_) {}
+	// Sorted idsets are not copied with index, so all keys of copy are marked as updated for sort orders
+	UpdateTracker(const UpdateTracker<T> &other)
+		: completeUpdated_(other.updated_.size() || other.completeUpdated_), sortCompleteUpdated_(true), sortEmptyUpdated_(true) {}
 	UpdateTracker() {}
 	UpdateTracker &operator=(const UpdateTracker<T> &other) = delete;
 
 	// Partial update of index routines. Thera 2 implementations:
 	// 1. For safe iterators maps (like std::map and std::unordered_map), which do not invalidate references on insert.
-	// 2. For unsafe iterators maps (like btree_map), which invalidate references on insert
+	// 2. For unsafe iterators maps (like btree_map and open addressing flat_hash_map), which invalidate references on insert
 
 	// Safe iterators implementation:
 	// Store pointers to keys, which already in the index map
 
 	template <typename U = T, typename std::enable_if<is_safe_iterators_map<U>::value && !is_payload_map_key<T>::value>::type * = nullptr>
 	void markUpdated(T &idx_map, typename T::value_type *k) {
-		if (completeUpdated_) return;
-		if (updated_.size() > idx_map.size() / 2) {
-			completeUpdated_ = true;
-			updated_.clear();
-			return;
-		}
-		updated_.emplace(k);
+		markKey(updated_, completeUpdated_, idx_map.size() / 2, k);
+		markKey(sortUpdated_, sortCompleteUpdated_, idx_map.size() / 2, k);
+	}
+
+	// Pointers to erased keys can be left in sortUpdated_, but they are never dereferenced:
+	// new key, which is placed at the same address, is marked as updated by insertion
+	template <typename U = T, typename std::enable_if<is_safe_iterators_map<U>::value && !is_payload_map_key<U>::value>::type * = nullptr>
+	bool isSortUpdated(typename T::value_type *k) const {
+		return sortCompleteUpdated_ || (sortUpdated_.size() && sortUpdated_.find(k) != sortUpdated_.end());
 	}
 
 	template <typename U = T, typename std::enable_if<is_safe_iterators_map<U>::value && !is_payload_map_key<U>::value>::type * = nullptr>
@@ -57,13 +61,13 @@ public:
 	// Store copy key values
 	template <typename U = T, typename std::enable_if<!is_safe_iterators_map<U>::value && !is_payload_map_key<U>::value>::type * = nullptr>
 	void markUpdated(T &idx_map, typename T::value_type *k) {
-		if (completeUpdated_) return;
-		if (updated_.size() > static_cast<size_t>(idx_map.size() / 8)) {
-			completeUpdated_ = true;
-			updated_.clear();
-			return;
-		}
-		updated_.emplace(k->first);
+		markKey(updated_, completeUpdated_, idx_map.size() / 8, k->first);
+		markKey(sortUpdated_, sortCompleteUpdated_, idx_map.size() / 8, k->first);
+	}
+
+	template <typename U = T, typename std::enable_if<!is_safe_iterators_map<U>::value && !is_payload_map_key<U>::value>::type * = nullptr>
+	bool isSortUpdated(typename T::value_type *k) const {
+		return sortCompleteUpdated_ || (sortUpdated_.size() && sortUpdated_.find(k->first) != sortUpdated_.end());
 	}
 
 	template <typename U = T, typename std::enable_if<!is_safe_iterators_map<U>::value && !is_payload_map_key<U>::value>::type * = nullptr>
@@ -78,15 +82,50 @@ public:
 	template <typename U = T, typename std::enable_if<is_payload_map_key<U>::value>::type * = nullptr>
 	void markUpdated(T &, typename T::value_type *) {
 		completeUpdated_ = true;
+		sortCompleteUpdated_ = true;
+	}
+	template <typename U = T, typename std::enable_if<is_payload_map_key<U>::value>::type * = nullptr>
+	bool isSortUpdated(typename T::value_type *) const {
+		return true;
 	}
 	template <typename U = T, typename std::enable_if<is_payload_map_key<U>::value>::type * = nullptr>
 	void commitUpdated(T &, const CommitContext &) {}
 
+	// Empty ids of index were changed
+	void markEmptyUpdated() { sortEmptyUpdated_ = true; }
+	bool isSortEmptyUpdated() const { return sortEmptyUpdated_; }
+
+	// Sort orders were rebuilt: Sorted idsets of all keys are valid now
+	void commitSortUpdated() {
+		sortUpdated_.clear();
+		sortCompleteUpdated_ = false;
+		sortEmptyUpdated_ = false;
+	}
+
+	typedef typename std::conditional<is_safe_iterators_map<T>::value || is_payload_map_key<T>::value,
+									  fast_hash_set<typename T::value_type *>, fast_hash_set<typename T::key_type>>::type updated_set;
+
 	// map of updated keys. depends on safe/unsafe index map's iterator implemntation
-	typename std::conditional<is_safe_iterators_map<T>::value || is_payload_map_key<T>::value, fast_hash_set<typename T::value_type *>,
-							  fast_hash_set<typename T::key_type>>::type updated_;
+	updated_set updated_;
+	bool completeUpdated_ = false;
+
+	// Keys, which were updated since last build of sort orders. Unlike updated_ it is not reset by commit of idsets,
+	// but only after Sorted idsets of all keys are rebuilt
+	updated_set sortUpdated_;
+	bool sortCompleteUpdated_ = true;
+	bool sortEmptyUpdated_ = true;
 
-	bool completeUpdated_;
+protected:
+	template <typename K>
+	static void markKey(updated_set &set, bool &complete, size_t limit, K &&k) {
+		if (complete) return;
+		if (set.size() > limit) {
+			complete = true;
+			set.clear();
+			return;
+		}
+		set.emplace(std::forward<K>(k));
+	}
 };
 
 }  // namespace reindexer
@@ -50,6 +50,8 @@ struct JoinCacheVal {
 	IdSet::Ptr ids_;
 	bool matchedAtLeastOnce = false;
 	bool inited = false;
+	// Version of namespace data, on which entry was built
+	uint64_t version = 0;
 	SelectCtx::PreResult::Ptr preResult;
 };
 typedef LRUCache<JoinCacheKey, JoinCacheVal, hash_join_cache_key, equal_join_cache_key> MainLruCache;
@@ -64,6 +66,8 @@ public:
 struct JoinCacheRes {
 	bool haveData = false;
 	bool needPut = false;
+	// Current version of namespace data, which is depending on queries of key
+	uint64_t version = 0;
 
 	JoinCacheKey key;
 	JoinCache::Iterator it;
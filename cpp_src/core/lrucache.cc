@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <climits>
+#include <tuple>
 
 #include "core/ft/ftsetcashe.h"
 #include "core/idset.h"
@@ -11,27 +14,59 @@ namespace reindexer {
 
 const size_t kElemSizeOverhead = 256;
 
+template <typename K, typename V, typename hash, typename equal>
+int LRUCache<K, V, hash, equal>::FrequencySketch::Increment(uint64_t keyHash) {
+	if (counters_.empty()) counters_.resize(kDepth * kWidth, 0);
+
+	int estimate = INT_MAX;
+	for (int row = 0; row < kDepth; row++) {
+		uint8_t &counter = counters_[row * kWidth + index(keyHash, row)];
+		if (counter < UINT8_MAX) counter++;
+		estimate = std::min(estimate, int(counter));
+	}
+	if (++increments_ >= kAgingPeriod) {
+		for (auto &counter : counters_) counter >>= 1;
+		increments_ = 0;
+	}
+	return estimate;
+}
+
 template <typename K, typename V, typename hash, typename equal>
 typename LRUCache<K, V, hash, equal>::Iterator LRUCache<K, V, hash, equal>::Get(const K &key) {
 	if (cacheSizeLimit_ == 0) return Iterator();
 
-	std::lock_guard<mutex> lk(lock_);
-
-	auto it = items_.find(key);
-
-	if (it == items_.end()) {
-		it = items_.emplace(key, Entry{}).first;
-		totalCacheSize_ += kElemSizeOverhead + sizeof(Entry) + key.Size();
-		it->second.lruPos = lru_.insert(lru_.end(), &it->first);
-		eraseLRU();
-	} else if (std::next(it->second.lruPos) != lru_.end()) {
-		lru_.splice(lru_.end(), lru_, it->second.lruPos, std::next(it->second.lruPos));
-		it->second.lruPos = std::prev(lru_.end());
+	uint64_t keyHash = hash()(key);
+	Shard &shard = getShard(keyHash);
+	{
+		shared_lock<shared_timed_mutex> lk(shard.lock);
+		auto it = shard.items.find(key);
+		if (it != shard.items.end()) {
+			it->second.referenced.store(true, std::memory_order_relaxed);
+			return Iterator(&it->first, it->second.val);
+		}
 	}
-	if (++it->second.hitCount < hitCountToCache_) {
-		return Iterator();
+
+	std::lock_guard<shared_timed_mutex> lk(shard.lock);
+	auto it = shard.items.find(key);
+	if (it == shard.items.end()) {
+		// Rarely requested keys are not admitted to cache, and do not allocate entries
+		if (shard.sketch.Increment(keyHash) < std::min(hitCountToCache_, int(UINT8_MAX))) return Iterator();
+
+		it = shard.items.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first;
+		if (shard.freeSlots.size()) {
+			it->second.slot = shard.freeSlots.back();
+			shard.freeSlots.pop_back();
+			shard.clock[it->second.slot] = &*it;
+		} else {
+			it->second.slot = shard.clock.size();
+			shard.clock.push_back(&*it);
+		}
+		shard.totalSize += entrySize(*it);
+		itemsCount_.fetch_add(1, std::memory_order_relaxed);
+		evict(shard, &*it);
+	} else {
+		it->second.referenced.store(true, std::memory_order_relaxed);
 	}
-	++getCount_;
 
 	// logPrintf(LogInfo, "Cache::Get (cond=%d,sortId=%d,keys=%d), total in cache items=%d,size=%d", key.cond, key.sort,
 	// 		  (int)key.keys.size(), items_.size(), totalCacheSize_);
@@ -42,64 +77,67 @@ template <typename K, typename V, typename hash, typename equal>
 void LRUCache<K, V, hash, equal>::Put(const K &key, const V &v) {
 	if (cacheSizeLimit_ == 0) return;
 
-	std::lock_guard<mutex> lk(lock_);
-	auto it = items_.find(key);
-	if (it == items_.end()) return;
+	Shard &shard = getShard(hash()(key));
+	std::lock_guard<shared_timed_mutex> lk(shard.lock);
+	auto it = shard.items.find(key);
+	if (it == shard.items.end()) return;
 
-	totalCacheSize_ += v.Size() - it->second.val.Size();
+	shard.totalSize += v.Size() - it->second.val.Size();
 	it->second.val = v;
 
 	// logPrintf(LogInfo, "IdSetCache::Put () add %d,left %d,fwdCnt=%d,sz=%d", endIt - begIt, left, it->second.fwdCount,
 	// 		  it->second.ids->size());
-	++putCount_;
 
-	eraseLRU();
+	evict(shard, &*it);
 }
 
 template <typename K, typename V, typename hash, typename equal>
-void LRUCache<K, V, hash, equal>::eraseLRU() {
-	typename LRUList::iterator it = lru_.begin();
-
-	while (totalCacheSize_ > cacheSizeLimit_) {
-		assert(it != lru_.end());
-		auto mIt = items_.find(**it);
-		assert(mIt != items_.end());
-		totalCacheSize_ = totalCacheSize_ - (sizeof(Entry) + kElemSizeOverhead + mIt->first.Size() + mIt->second.val.Size());
-		items_.erase(mIt);
-		it = lru_.erase(it);
-		++eraseCount_;
-	}
+size_t LRUCache<K, V, hash, equal>::entrySize(const typename Map::value_type &item) const {
+	return kElemSizeOverhead + sizeof(Entry) + item.first.Size() + item.second.val.Size();
+}
 
-	if (eraseCount_ && putCount_ * 16 > getCount_) {
-		logPrintf(LogWarning, "IdSetCache::eraseLRU () cache invalidates too fast eraseCount=%d,putCount=%d,getCount=%d", eraseCount_,
-				  putCount_, eraseCount_);
-		eraseCount_ = 0;
-		hitCountToCache_ *= 2;
-		putCount_ = 0;
-		getCount_ = 0;
+template <typename K, typename V, typename hash, typename equal>
+void LRUCache<K, V, hash, equal>::evict(Shard &shard, const typename Map::value_type *keep) {
+	const size_t shardSizeLimit = cacheSizeLimit_ / kShards;
+
+	// Referenced entries are given second chance, so two turns of hand are enough to find victim
+	for (size_t steps = 0; shard.totalSize > shardSizeLimit && steps < 2 * shard.clock.size(); steps++) {
+		if (shard.hand >= shard.clock.size()) shard.hand = 0;
+		size_t slot = shard.hand++;
+		auto item = shard.clock[slot];
+		if (!item || item == keep) continue;
+		if (item->second.referenced.exchange(false, std::memory_order_relaxed)) continue;
+
+		shard.totalSize -= entrySize(*item);
+		shard.clock[slot] = nullptr;
+		shard.freeSlots.push_back(slot);
+		shard.items.erase(shard.items.find(item->first));
+		itemsCount_.fetch_sub(1, std::memory_order_relaxed);
 	}
 }
+
 template <typename K, typename V, typename hash, typename equal>
 void LRUCache<K, V, hash, equal>::Invalidate() {
-	std::lock_guard<mutex> lk(lock_);
-
-	eraseCount_ += items_.size();
-	items_.clear();
-	lru_.clear();
-	totalCacheSize_ = 0;
+	for (auto &shard : shards_) {
+		std::lock_guard<shared_timed_mutex> lk(shard.lock);
+		itemsCount_.fetch_sub(shard.items.size(), std::memory_order_relaxed);
+		shard.items.clear();
+		shard.clock.clear();
+		shard.freeSlots.clear();
+		shard.hand = 0;
+		shard.totalSize = 0;
+	}
 }
 
 template <typename K, typename V, typename hash, typename equal>
 LRUCacheMemStat LRUCache<K, V, hash, equal>::GetMemStat() {
-	std::lock_guard<mutex> lk(lock_);
 	LRUCacheMemStat ret;
-	ret.totalSize = totalCacheSize_;
-	ret.itemsCount = items_.size();
+	for (auto &shard : shards_) {
+		shared_lock<shared_timed_mutex> lk(shard.lock);
+		ret.totalSize += shard.totalSize;
+		ret.itemsCount += shard.items.size();
+	}
 	ret.emptyCount = 0;
-	// for (auto &item : items_) {
-	// 	if (item.second.val.Empty()) ret.emptyCount++;
-	// }
-
 	ret.hitCountLimit = hitCountToCache_;
 
 	return ret;
@@ -1,58 +1,95 @@
 #pragma once
 
-#include <estl/fast_hash_set.h>
-#include <list>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
+#include "estl/shared_mutex.h"
 #include "namespacestat.h"
 
 namespace reindexer {
-using std::list;
 using std::mutex;
 using std::unordered_map;
 
 const size_t kDefaultCacheSizeLimit = 1024 * 1024 * 128;
 const int kDefaultHitCountToCache = 2;
 
+// Cache is split to shards by hash of key, each shard has it's own lock. Hits are taking shared lock of shard and only mark entry as
+// referenced, entries are evicted by CLOCK. Entries for keys are created, only if keys were requested hitCount times recently
 template <typename K, typename V, typename hash, typename equal>
 class LRUCache {
 public:
 	LRUCache(size_t sizeLimit = kDefaultCacheSizeLimit, int hitCount = kDefaultHitCountToCache)
-		: totalCacheSize_(0), cacheSizeLimit_(sizeLimit), hitCountToCache_(hitCount) {}
+		: cacheSizeLimit_(sizeLimit), hitCountToCache_(hitCount) {}
 	struct Iterator {
 		Iterator(const K *k = nullptr, const V &v = V()) : key(k), val(v) {}
 		const K *key;
 		V val;
 	};
-	// Get cached val. Create new entry in cache if unexists
+	// Get cached val. Create new entry in cache if unexists and key is requested frequently
 	Iterator Get(const K &k);
 	// Put cached val
 	void Put(const K &k, const V &v);
 
 	LRUCacheMemStat GetMemStat();
 
-	bool Empty() const { return items_.empty(); }
+	bool Empty() const { return itemsCount_.load(std::memory_order_relaxed) == 0; }
 	void Invalidate();
 
 protected:
-	void eraseLRU();
+	// Count-min sketch of requests frequency of keys with periodic aging (TinyLFU admission)
+	class FrequencySketch {
+	public:
+		// Count request of key and return estimated number of recent requests of it
+		int Increment(uint64_t keyHash);
 
-	typedef list<const K *> LRUList;
+	protected:
+		static size_t index(uint64_t keyHash, int row) {
+			return size_t(((keyHash ^ (keyHash >> 29)) * (0x9E3779B97F4A7C15ULL + 2 * row)) >> (64 - kWidthBits));
+		}
+
+		static const int kDepth = 4;
+		static const int kWidthBits = 10;
+		static const size_t kWidth = size_t(1) << kWidthBits;
+		// Counters are halved after this number of increments, so frequencies of not requested keys are decaying
+		static const size_t kAgingPeriod = kWidth * 8;
+
+		std::vector<uint8_t> counters_;
+		size_t increments_ = 0;
+	};
 
 	struct Entry {
 		V val;
-		typename LRUList::iterator lruPos;
-		int hitCount = 0;
+		// Entry was accessed since last pass of CLOCK hand
+		std::atomic<bool> referenced{true};
+		size_t slot = 0;
+	};
+	typedef unordered_map<K, Entry, hash, equal> Map;
+
+	struct Shard {
+		shared_timed_mutex lock;
+		Map items;
+		// CLOCK ring of entries. Slots of evicted entries are reused by new entries
+		std::vector<typename Map::value_type *> clock;
+		std::vector<size_t> freeSlots;
+		size_t hand = 0;
+		size_t totalSize = 0;
+		FrequencySketch sketch;
 	};
 
-	unordered_map<K, Entry, hash, equal> items_;
-	LRUList lru_;
-	mutex lock_;
-	size_t totalCacheSize_;
+	static const int kShardsBits = 4;
+	static const size_t kShards = size_t(1) << kShardsBits;
+
+	Shard &getShard(uint64_t keyHash) { return shards_[(keyHash * 0x9E3779B97F4A7C15ULL) >> (64 - kShardsBits)]; }
+	size_t entrySize(const typename Map::value_type &item) const;
+	void evict(Shard &shard, const typename Map::value_type *keep);
+
+	Shard shards_[kShards];
+	std::atomic<size_t> itemsCount_{0};
 	size_t cacheSizeLimit_;
 	int hitCountToCache_;
-
-	int getCount_ = 0, putCount_ = 0, eraseCount_ = 0;
 };
 
 }  // namespace reindexer
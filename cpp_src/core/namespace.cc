@@ -5,11 +5,14 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include "core/cjson/cjsondecoder.h"
+#include "core/cjson/cjsonencoder.h"
 #include "core/cjson/jsonencoder.h"
 #include "core/index/index.h"
 #include "core/nsselecter/nsselecter.h"
 #include "itemimpl.h"
 #include "storage/storagefactory.h"
+#include "storageloader.h"
 #include "tools/errors.h"
 #include "tools/fsops.h"
 #include "tools/logger.h"
@@ -40,6 +43,14 @@ namespace reindexer {
 
 const int64_t kStorageSerialInitial = 1;
 
+static bool isSameKeys(const KeyRefs &lhs, const KeyRefs &rhs) {
+	if (lhs.size() != rhs.size()) return false;
+	for (size_t i = 0; i < lhs.size(); i++) {
+		if (lhs[i].Type() != rhs[i].Type() || lhs[i] != rhs[i]) return false;
+	}
+	return true;
+}
+
 Namespace::IndexesStorage::IndexesStorage(const Namespace &ns) : Base(), ns_(ns) {}
 
 // private implementation and NOT THREADSAFE of copy CTOR
@@ -50,21 +61,26 @@ Namespace::Namespace(const Namespace &src)
 	  items_(src.items_),
 	  free_(src.free_),
 	  name_(src.name_),
+	  tupleDict_(src.tupleDict_),
 	  payloadType_(src.payloadType_),
 	  tagsMatcher_(src.tagsMatcher_),
 	  storage_(src.storage_),
 	  updates_(src.updates_),
 	  unflushedCount_(0),
+	  flushingCount_(0),
 	  sortOrdersBuilt_(false),
 	  sortedQueriesCount_(0),
+	  preparedIndexes_(0),
+	  commitedIndexes_(0),
 	  pkFields_(src.pkFields_),
 	  meta_(src.meta_),
 	  dbpath_(src.dbpath_),
-	  queryCache_(src.queryCache_),
-	  joinCache_(src.joinCache_),
+	  queryCache_(make_shared<QueryCache>()),
+	  joinCache_(make_shared<JoinCache>()),
 	  cacheMode_(src.cacheMode_),
 	  enablePerfCounters_(src.enablePerfCounters_.load()),
 	  queriesLogLevel_(src.queriesLogLevel_) {
+	compressTuples_ = src.compressTuples_;
 	for (auto &idxIt : src.indexes_) indexes_.push_back(unique_ptr<Index>(idxIt->Clone()));
 	logPrintf(LogTrace, "Namespace::Namespace (clone %s)", name_.c_str());
 }
@@ -72,11 +88,15 @@ Namespace::Namespace(const Namespace &src)
 Namespace::Namespace(const string &name, CacheMode cacheMode)
 	: indexes_(*this),
 	  name_(name),
-	  payloadType_(name),
+	  tupleDict_(std::make_shared<TupleDictionary>()),
+	  payloadType_(name, tupleDict_),
 	  tagsMatcher_(payloadType_),
 	  unflushedCount_(0),
+	  flushingCount_(0),
 	  sortOrdersBuilt_(false),
 	  sortedQueriesCount_(0),
+	  preparedIndexes_(0),
+	  commitedIndexes_(0),
 	  queryCache_(make_shared<QueryCache>()),
 	  joinCache_(make_shared<JoinCache>()),
 	  cacheMode_(cacheMode),
@@ -128,6 +148,8 @@ void Namespace::updateItems(PayloadType oldPlType, const FieldsSet &changedField
 	}
 
 	KeyRefs krefs, skrefs;
+	WrSerializer tupleSer;
+	string_view tuple;
 	ItemImpl newItem(payloadType_, tagsMatcher_);
 	newItem.Unsafe(true);
 	int errCount = 0;
@@ -164,6 +186,7 @@ void Namespace::updateItems(PayloadType oldPlType, const FieldsSet &changedField
 
 			if ((fieldIdx == 0) || deltaFields >= 0) {
 				newItem.GetPayload().Get(fieldIdx, krefs);
+				if (fieldIdx == 0 && compressTuples_) compressTuple(krefs, tupleSer, tuple);
 				skrefs.resize(0);
 				for (auto key : krefs) skrefs.push_back(index.Upsert(key, rowId));
 
@@ -179,6 +202,8 @@ void Namespace::updateItems(PayloadType oldPlType, const FieldsSet &changedField
 		plCurr = std::move(plNew);
 	}
 	markUpdated();
+	invalidateQueryCache();
+	invalidateJoinCache();
 	if (errCount != 0) {
 		logPrintf(LogError, "Can't update indexes of %d items in namespace %s: %s", errCount, name_.c_str(), lastErr.what().c_str());
 	}
@@ -265,6 +290,9 @@ bool Namespace::dropIndex(const string &index) {
 
 	indexes_.erase(indexes_.begin() + fieldIdx);
 	indexesNames_.erase(itIdxName);
+	// Numbers of indexes are shifted, so versions of cached entries are not comparable anymore
+	invalidateQueryCache();
+	invalidateJoinCache();
 	return true;
 }
 
@@ -458,6 +486,8 @@ void Namespace::insertIndex(Index *newIndex, int idxNo, const string &realName)
 	}
 
 	indexesNames_.insert({realName, idxNo});
+	invalidateQueryCache();
+	invalidateJoinCache();
 
 	if (newIndex->Opts().IsPK()) {
 		if (newIndex->KeyType() == KeyValueComposite) {
@@ -492,13 +522,51 @@ void Namespace::Update(Item &item, bool store) { upsertInternal(item, store, UPD
 void Namespace::Upsert(Item &item, bool store) { upsertInternal(item, store, INSERT_MODE | UPDATE_MODE); }
 
 void Namespace::Delete(Item &item) {
-	ItemImpl *ritem = item.impl_;
-	string jsonSliceBuf;
+	PerfStatCalculatorMT calc(updatePerfCounter_, enablePerfCounters_);
+	WLock lock(mtx_);
+	calc.LockHit();
 
+	deleteItem(item);
+}
+
+void Namespace::ModifyItems(vector<Item> &items, int mode) {
+	uint8_t upsertMode = 0;
+	switch (mode) {
+		case ModeUpdate:
+			upsertMode = UPDATE_MODE;
+			break;
+		case ModeInsert:
+			upsertMode = INSERT_MODE;
+			break;
+		case ModeUpsert:
+			upsertMode = INSERT_MODE | UPDATE_MODE;
+			break;
+		case ModeDelete:
+			break;
+		default:
+			throw Error(errParams, "Unknown modify mode %d", mode);
+	}
+
+	// Whole batch is applied under single lock. Storage updates are collected to the same batch, and flushed later
 	PerfStatCalculatorMT calc(updatePerfCounter_, enablePerfCounters_);
 	WLock lock(mtx_);
 	calc.LockHit();
 
+	for (auto &item : items) {
+		if (mode == ModeDelete) {
+			deleteItem(item);
+		} else {
+			modifyItem(item, true, upsertMode);
+		}
+	}
+	// Tags of items are merged to namespace's tagsMatcher one by one, so earlier items of batch could miss tags, added by later ones
+	for (auto &item : items) item.impl_->tagsMatcher() = tagsMatcher_;
+}
+
+void Namespace::deleteItem(Item &item) {
+	ItemImpl *ritem = item.impl_;
+	string jsonSliceBuf;
+
 	updateTagsMatcherFromItem(ritem, jsonSliceBuf);
 
 	auto itItem = findByPK(ritem);
@@ -549,6 +617,7 @@ void Namespace::_delete(IdType id) {
 	// free PayloadValue
 	items_[id].Free();
 	markUpdated();
+	++rowsVersion_;
 	free_.emplace(id);
 }
 
@@ -570,6 +639,161 @@ void Namespace::Delete(const Query &q, QueryResults &result) {
 	}
 }
 
+void Namespace::Update(const Query &q, QueryResults &result) {
+	PerfStatCalculatorMT calc(updatePerfCounter_, enablePerfCounters_);
+	WLock lock(mtx_);
+	calc.LockHit();
+
+	// Fields are checked and values are converted to types of fields before selection, so invalid query doesn't modify any item
+	struct FieldUpdate {
+		int field;
+		KeyValues values;
+		KeyRefs krefs;
+		int tagName;
+		int tagType;
+	};
+	vector<FieldUpdate> updates;
+	updates.reserve(q.updateFields_.size());
+	for (auto &ue : q.updateFields_) {
+		int field = 0;
+		if (!getIndexByName(ue.column_, field) || field <= 0 || field >= indexes_.firstSparsePos()) {
+			throw Error(errParams, "Field '%s' of namespace '%s' can't be updated by query: only indexed fields are supported",
+						ue.column_.c_str(), name_.c_str());
+		}
+		Index &index = *indexes_[field];
+		if (index.Opts().IsPK()) {
+			throw Error(errParams, "PK field '%s' of namespace '%s' can't be updated by query", ue.column_.c_str(), name_.c_str());
+		}
+		if (index.Opts().IsArray() || ue.values_.size() != 1) {
+			throw Error(errParams, "Field '%s' of namespace '%s' can't be updated by query: only scalar values are supported",
+						ue.column_.c_str(), name_.c_str());
+		}
+		// Field, which is missing in tuple of item, is appended to top level object of tuple, so json path can't be nested
+		const auto &jsonPaths = payloadType_->Field(field).JsonPaths();
+		if (jsonPaths.size() != 1 || jsonPaths[0].find('.') != string::npos) {
+			throw Error(errParams, "Field '%s' of namespace '%s' can't be updated by query: only top level json paths are supported",
+						ue.column_.c_str(), name_.c_str());
+		}
+		KeyValueType fieldType = payloadType_->Field(field).Type();
+		int tagType = TAG_VARINT;
+		if (index.Type() == IndexBool) {
+			tagType = TAG_BOOL;
+		} else if (fieldType == KeyValueString) {
+			tagType = TAG_STRING;
+		} else if (fieldType == KeyValueDouble) {
+			tagType = TAG_DOUBLE;
+		}
+		// Tag is added before selection, so tags matcher of query results can decode updated items
+		updates.push_back({field, ue.values_, {}, tagsMatcher_.name2tag(jsonPaths[0].c_str(), true), tagType});
+		for (auto &kv : updates.back().values) kv.convert(fieldType);
+	}
+	for (auto &upd : updates) {
+		for (auto &kv : upd.values) upd.krefs.push_back(KeyRef(kv));
+		if (indexes_[upd.field]->Opts().GetCollateMode() == CollateUTF8)
+			for (auto &key : upd.krefs) key.EnsureUTF8();
+	}
+
+	NsSelecter selecter(this);
+	SelectCtx ctx(q, nullptr);
+	selecter(result, ctx);
+
+	auto tmStart = high_resolution_clock::now();
+	if (indexesVersions_.size() < size_t(indexes_.firstCompositePos())) indexesVersions_.resize(indexes_.firstCompositePos());
+
+	// Composite indexes, which contain updated fields
+	h_vector<int, 4> composites;
+	for (int field = indexes_.firstCompositePos(); field < indexes_.totalSize(); ++field) {
+		for (auto &upd : updates) {
+			if (indexes_[field]->Fields().contains(upd.field)) {
+				composites.push_back(field);
+				break;
+			}
+		}
+	}
+
+	// Tuple refers only to indexed fields, which were present in JSON of item. Updated fields, which are missing in tuple, are not encoded
+	// to CJSON of item and are lost on load from storage, so tuple is rebuilt with them the same way, as on upsert of item
+	WrSerializer tupleSer;
+	auto appendMissingFields = [&](string_view tuple) {
+		FieldsSet present;
+		TupleSerializer rdser(tuple, tupleDict_.get());
+		size_t endPos = 0;
+		ctag tag = rdser.GetVarUint();
+		assert(tag.Type() == TAG_OBJECT);
+		for (endPos = rdser.Pos(), tag = rdser.GetVarUint(); tag.Type() != TAG_END; endPos = rdser.Pos(), tag = rdser.GetVarUint()) {
+			if (tag.Field() >= 0) present.push_back(tag.Field());
+			skipCjsonTag(tag, rdser);
+		}
+		tupleSer.Reset();
+		tupleSer.Write(tuple.substr(0, endPos));
+		for (auto &upd : updates) {
+			if (!present.contains(upd.field)) tupleSer.PutVarUint(static_cast<int>(ctag(upd.tagType, upd.tagName, upd.field)));
+		}
+		if (tupleSer.Len() == endPos) return false;
+		tupleSer.PutVarUint(static_cast<int>(ctag(TAG_END, 0)));
+		return true;
+	};
+
+	KeyRefs krefs;
+	WrSerializer cjson;
+	JsonPrintFilter filter;
+	CJsonEncoder encoder(tagsMatcher_, filter);
+	for (auto &r : result.Items()) {
+		PayloadValue &plData = items_[r.id];
+		Payload pl(payloadType_, plData);
+		// Payload is shared with results of query, so it's cloned before modification
+		plData.AllocOrClone(pl.RealSize());
+
+		for (int field : composites) indexes_[field]->Delete(KeyRef(plData), r.id);
+		for (auto &upd : updates) {
+			Index &index = *indexes_[upd.field];
+			pl.Get(upd.field, krefs);
+			// Value is not changed: do not touch index keys, so their idsets and sort orders remain valid
+			if (isSameKeys(krefs, upd.krefs)) continue;
+			++indexesVersions_[upd.field];
+			for (auto key : krefs) index.Delete(key, r.id);
+			if (!krefs.size()) index.Delete(KeyRef(), r.id);
+			krefs.resize(0);
+			for (auto key : upd.krefs) krefs.push_back(index.Upsert(key, r.id));
+			pl.Set(upd.field, krefs);
+		}
+		for (int field : composites) indexes_[field]->Upsert(KeyRef(plData), r.id);
+
+		// Empty tuple of item without JSON is built from all fields of payload by encoder
+		pl.Get(0, krefs);
+		if (!krefs.empty() && string_view(krefs[0]).size() && appendMissingFields(string_view(krefs[0]))) {
+			string_view tuple = tupleSer.Slice();
+			indexes_[0]->Delete(krefs[0], r.id);
+			krefs.resize(0);
+			krefs.push_back(indexes_[0]->Upsert(KeyRef(p_string(&tuple)), r.id));
+			pl.Set(0, krefs);
+		}
+
+		// Updated items are written to the same batch of storage updates, which is flushed later
+		if (storage_) {
+			char pk[512];
+			auto prefLen = strlen(kStorageItemPrefix);
+			memcpy(pk, kStorageItemPrefix, prefLen);
+			pl.GetPK(pk + prefLen, sizeof(pk) - prefLen, pkFields_);
+			ConstPayload cpl(payloadType_, plData);
+			cjson.Reset();
+			cjson.PutUInt32(0);
+			encoder.Encode(&cpl, cjson);
+			updates_->Put(string_view(pk), cjson.Slice());
+			++unflushedCount_;
+		}
+
+		r.value = plData;
+		r.version = plData.GetVersion();
+	}
+	if (result.Count()) markUpdated();
+
+	if (q.debugLevel >= LogInfo) {
+		logPrintf(LogInfo, "Updated %d items in %d µs", int(result.Count()),
+				  int(duration_cast<microseconds>(high_resolution_clock::now() - tmStart).count()));
+	}
+}
+
 void Namespace::upsert(ItemImpl *ritem, IdType id, bool doUpdate) {
 	// Upsert fields to indexes
 	assert(items_.exists(id));
@@ -580,10 +804,16 @@ void Namespace::upsert(ItemImpl *ritem, IdType id, bool doUpdate) {
 	Payload plNew = ritem->GetPayload();
 	if (doUpdate) {
 		plData.AllocOrClone(pl.RealSize());
+	} else {
+		++rowsVersion_;
 	}
 	markUpdated();
+	if (indexesVersions_.size() < size_t(indexes_.firstCompositePos())) indexesVersions_.resize(indexes_.firstCompositePos());
 
 	KeyRefs krefs, skrefs;
+	// Compressed tuple is kept here, until it's copied to index of tuples
+	WrSerializer tupleSer;
+	string_view tuple;
 
 	// Delete from composite indexes first
 	if (doUpdate) {
@@ -610,6 +840,7 @@ void Namespace::upsert(ItemImpl *ritem, IdType id, bool doUpdate) {
 			plNew.GetByJsonPath(index.Fields().getTagsPath(0), skrefs);
 		} else {
 			plNew.Get(field, skrefs);
+			if (field == 0 && compressTuples_) compressTuple(skrefs, tupleSer, tuple);
 		}
 
 		if (index.Opts().GetCollateMode() == CollateUTF8)
@@ -622,6 +853,9 @@ void Namespace::upsert(ItemImpl *ritem, IdType id, bool doUpdate) {
 			} else {
 				pl.Get(field, krefs);
 			}
+			// Value is not changed: do not touch index keys, so their idsets and sort orders remain valid
+			if (isSameKeys(krefs, skrefs)) continue;
+			++indexesVersions_[field];
 			for (auto key : krefs) index.Delete(key, id);
 			if (!krefs.size()) index.Delete(KeyRef(), id);
 		}
@@ -641,6 +875,50 @@ void Namespace::upsert(ItemImpl *ritem, IdType id, bool doUpdate) {
 	}
 }
 
+void Namespace::compressTuple(KeyRefs &krefs, WrSerializer &ser, string_view &tuple) {
+	if (krefs.empty()) return;
+	tupleDict_->Train(string_view(krefs[0]));
+	tuple = tupleDict_->Compress(string_view(krefs[0]), ser);
+	krefs[0] = KeyRef(p_string(&tuple));
+}
+
+void Namespace::EnableTuplesCompression(bool enable) {
+	WLock lock(mtx_);
+	if (compressTuples_ == enable) return;
+	compressTuples_ = enable;
+	// Tuples, which are already compressed, are still readable, since dictionary is never dropped
+	if (!enable) return;
+
+	// Train dictionary by all existing tuples first, so strings are replaced in all of them
+	KeyRefs krefs, skrefs;
+	for (auto &item : items_) {
+		if (item.IsFree()) continue;
+		ConstPayload(payloadType_, item).Get(0, krefs);
+		if (!krefs.empty()) tupleDict_->Train(string_view(krefs[0]));
+	}
+	if (!tupleDict_->Size()) return;
+
+	Index &index = *indexes_[0];
+	WrSerializer ser;
+	for (IdType id = 0; id < IdType(items_.size()); ++id) {
+		PayloadValue &plData = items_[id];
+		if (plData.IsFree()) continue;
+		Payload pl(payloadType_, plData);
+		pl.Get(0, krefs);
+		if (krefs.empty()) continue;
+		string_view tuple = string_view(krefs[0]);
+		string_view compressed = tupleDict_->Compress(tuple, ser);
+		if (compressed.data() == tuple.data()) continue;
+
+		plData.AllocOrClone(pl.RealSize());
+		index.Delete(krefs[0], id);
+		skrefs.resize(0);
+		skrefs.push_back(index.Upsert(KeyRef(p_string(&compressed)), id));
+		pl.Set(0, skrefs);
+	}
+	markUpdated();
+}
+
 void Namespace::updateTagsMatcherFromItem(ItemImpl *ritem, string &jsonSliceBuf) {
 	if (ritem->tagsMatcher().isUpdated()) {
 		logPrintf(LogTrace, "Updated TagsMatcher of namespace '%s' on modify:\n%s", name_.c_str(), ritem->tagsMatcher().dump().c_str());
@@ -666,14 +944,18 @@ void Namespace::updateTagsMatcherFromItem(ItemImpl *ritem, string &jsonSliceBuf)
 }
 
 void Namespace::upsertInternal(Item &item, bool store, uint8_t mode) {
-	// Item to upsert
-	ItemImpl *itemImpl = item.impl_;
-	string jsonSlice;
-
 	PerfStatCalculatorMT calc(updatePerfCounter_, enablePerfCounters_);
 	WLock lock(mtx_);
 	calc.LockHit();
 
+	modifyItem(item, store, mode);
+}
+
+void Namespace::modifyItem(Item &item, bool store, uint8_t mode) {
+	// Item to upsert
+	ItemImpl *itemImpl = item.impl_;
+	string jsonSlice;
+
 	updateTagsMatcherFromItem(itemImpl, jsonSlice);
 
 	auto realItem = findByPK(itemImpl);
@@ -773,28 +1055,32 @@ pair<IdType, bool> Namespace::findByPK(ItemImpl *ritem) {
 }
 
 void Namespace::commit(const NSCommitContext &ctx, SelectLockUpgrader *lockUpgrader) {
-	bool needCommit = (!sortOrdersBuilt_ && (ctx.phases() & CommitContext::MakeSortOrders));
+	bool needSortOrders = !sortOrdersBuilt_ && (ctx.phases() & CommitContext::MakeSortOrders);
+	uint64_t mask = ctx.indexes() ? indexesMask(*ctx.indexes()) : 0;
 
-	if (ctx.indexes())
-		for (auto idxNo : *ctx.indexes()) needCommit = needCommit || !preparedIndexes_.contains(idxNo) || !commitedIndexes_.contains(idxNo);
-
-	if (!needCommit) {
+	if (!needSortOrders && (commitedIndexes_ & mask) == mask && (preparedIndexes_ & mask) == mask) {
 		return;
 	}
 
-	if (lockUpgrader) lockUpgrader->Upgrade();
+	// Sort orders are shared by all indexes, so they are rebuilt under exclusive lock.
+	// Idsets of separate indexes are commited under shared lock: writers are locked out by it, and selects, which are using
+	// not commited indexes, are waiting for commitMtx_, so selects by already commited indexes are not blocked by commit.
+	if (needSortOrders && lockUpgrader) lockUpgrader->Upgrade();
+
+	std::lock_guard<std::mutex> lck(commitMtx_);
 
 	// Commit changes
-	if ((ctx.phases() & CommitContext::MakeIdsets) && !commitedIndexes_.containsAll(indexes_.size())) {
+	uint64_t allMask = indexes_.size() < 64 ? (uint64_t(1) << indexes_.size()) - 1 : ~uint64_t(0);
+	if ((ctx.phases() & CommitContext::MakeIdsets) && commitedIndexes_ != allMask) {
 		assert(indexes_.firstCompositePos() != 0);
 		int field = indexes_.firstCompositePos();
 		bool was = false;
 		do {
 			field %= indexes_.totalSize();
 			if (!ctx.indexes() || ctx.indexes()->contains(field) || (ctx.phases() & CommitContext::MakeSortOrders)) {
-				if (!commitedIndexes_.contains(field)) {
+				if (!(commitedIndexes_ & (uint64_t(1) << field))) {
 					indexes_[field]->Commit(ctx);
-					commitedIndexes_.push_back(field);
+					commitedIndexes_ |= uint64_t(1) << field;
 					was = true;
 				}
 			}
@@ -803,13 +1089,14 @@ void Namespace::commit(const NSCommitContext &ctx, SelectLockUpgrader *lockUpgra
 		//	items_.shrink_to_fit();
 	}
 
-	if (!sortOrdersBuilt_ && (ctx.phases() & CommitContext::MakeSortOrders)) {
+	if (needSortOrders && !sortOrdersBuilt_) {
 		// Update sort orders and sort_id for each index
 
 		int i = 1;
+		int sortedIdxCount = getSortedIdxCount();
 		for (auto &idxIt : indexes_) {
 			if (idxIt->IsOrdered()) {
-				NSUpdateSortedContext sortCtx(*this, i++);
+				NSUpdateSortedContext sortCtx(*this, i++, sortedIdxCount == sortOrdersIdxCount_);
 				idxIt->MakeSortOrders(sortCtx);
 				// Build in multiple threads
 				int maxIndexWorkers = std::thread::hardware_concurrency();
@@ -826,16 +1113,17 @@ void Namespace::commit(const NSCommitContext &ctx, SelectLockUpgrader *lockUpgra
 				for (int i = 0; i < maxIndexWorkers; i++) thrs[i].join();
 			}
 		}
+		sortOrdersIdxCount_ = sortedIdxCount;
 		sortOrdersBuilt_ = true;
 	}
 
 	if (ctx.indexes()) {
 		NSCommitContext ctx1(*this, CommitContext::PrepareForSelect, ctx.indexes());
 		for (auto idxNo : *ctx.indexes())
-			if ((idxNo != IndexValueType::SetByJsonPath) && !preparedIndexes_.contains(idxNo)) {
+			if ((idxNo != IndexValueType::SetByJsonPath) && !(preparedIndexes_ & (uint64_t(1) << idxNo))) {
 				assert(static_cast<size_t>(idxNo) < indexes_.size());
 				indexes_[idxNo]->Commit(ctx1);
-				preparedIndexes_.push_back(idxNo);
+				preparedIndexes_ |= uint64_t(1) << idxNo;
 			}
 	}
 }
@@ -843,10 +1131,29 @@ void Namespace::commit(const NSCommitContext &ctx, SelectLockUpgrader *lockUpgra
 void Namespace::markUpdated() {
 	sortOrdersBuilt_ = false;
 	sortedQueriesCount_ = 0;
-	preparedIndexes_.clear();
-	commitedIndexes_.clear();
-	invalidateQueryCache();
-	invalidateJoinCache();
+	preparedIndexes_ = 0;
+	commitedIndexes_ = 0;
+	++dataVersion_;
+}
+
+uint64_t Namespace::getCacheVersion(const Query &q, bool withSort) const {
+	// Sorted idsets of all indexes are rebuilt after any modification
+	if (withSort && !q.sortBy.empty()) return dataVersion_;
+
+	// Result of query depends on set of items, and on values of indexes, used in conditions.
+	// Versions are only incremented, so sum of them is changed by any of these modifications
+	uint64_t version = rowsVersion_;
+	auto addIndexVersion = [this, &version](const string &name) {
+		int idxNo;
+		if (!getIndexByName(name, idxNo) || idxNo >= indexes_.firstCompositePos()) return false;
+		if (size_t(idxNo) < indexesVersions_.size()) version += indexesVersions_[idxNo];
+		return true;
+	};
+	// Composite indexes are rebuilt on each update, and non indexed fields are not tracked, so they are depending on any modification
+	for (auto &entry : q.entries) {
+		if (!addIndexVersion(entry.index)) return dataVersion_;
+	}
+	return version;
 }
 
 void Namespace::Select(QueryResults &result, SelectCtx &params) {
@@ -887,6 +1194,8 @@ NamespaceDef Namespace::GetDefinition() {
 
 NamespaceMemStat Namespace::GetMemStat() {
 	RLock lck(mtx_);
+	// Indexes could be commited by concurrent selects
+	std::lock_guard<std::mutex> commitLck(commitMtx_);
 
 	NamespaceMemStat ret;
 	ret.name = name_;
@@ -894,13 +1203,23 @@ NamespaceMemStat Namespace::GetMemStat() {
 	ret.queryCache = queryCache_->GetMemStat();
 
 	ret.itemsCount = items_.size() - free_.size();
+	ret.tuples.compressed = compressTuples_;
+	ret.tuples.dictStringsCount = tupleDict_->Size();
+	ret.tuples.dictSize = tupleDict_->MemSize();
+	KeyRefs krefs;
 	for (auto &item : items_) {
-		if (!item.IsFree()) ret.dataSize += item.GetCapacity() + sizeof(PayloadValue::dataHeader);
+		if (item.IsFree()) continue;
+		ret.dataSize += item.GetCapacity() + sizeof(PayloadValue::dataHeader);
+		ConstPayload(payloadType_, item).Get(0, krefs);
+		if (krefs.empty()) continue;
+		string_view tuple(krefs[0]);
+		ret.tuples.tuplesSize += tuple.size();
+		ret.tuples.uncompressedTuplesSize += tupleDict_->UncompressedSize(tuple);
 	}
 
 	ret.emptyItemsCount = free_.size();
 
-	ret.Total.dataSize = ret.dataSize + items_.capacity() * sizeof(PayloadValue);
+	ret.Total.dataSize = ret.dataSize + items_.capacity() * sizeof(PayloadValue) + ret.tuples.dictSize;
 	ret.Total.cacheSize = ret.joinCache.totalSize + ret.queryCache.totalSize;
 
 	for (auto &idx : indexes_) {
@@ -923,6 +1242,12 @@ NamespacePerfStat Namespace::GetPerfStat() {
 	ret.name = name_;
 	ret.selects = selectPerfCounter_.Get<PerfStat>();
 	ret.updates = updatePerfCounter_.Get<PerfStat>();
+	ret.storageFlushes = flushPerfCounter_.Get<PerfStat>();
+	ret.selectPhases.prepare = selectPreparePerf_.Get();
+	ret.selectPhases.indexes = selectIndexesPerf_.Get();
+	ret.selectPhases.postprocess = selectPostprocessPerf_.Get();
+	ret.selectPhases.loop = selectLoopPerf_.Get();
+	ret.storageBacklog = unflushedCount_ + flushingCount_;
 	return ret;
 }
 
@@ -1064,49 +1389,67 @@ void Namespace::LoadFromStorage() {
 	getCachedMode();
 	logPrintf(LogTrace, "Loading items to '%s' from storage", name_.c_str());
 	unique_ptr<datastorage::Cursor> dbIter(storage_->GetCursor(opts));
-	ItemImpl item(payloadType_, tagsMatcher_);
-	item.Unsafe(true);
 	int errCount = 0;
 	Error lastErr = errOK;
-	for (dbIter->Seek(kStorageItemPrefix);
-		 dbIter->Valid() && dbIter->GetComparator().Compare(dbIter->Key(), string_view(kStorageItemPrefix "\xFF")) < 0; dbIter->Next()) {
-		string_view dataSlice = dbIter->Value();
-		if (dataSlice.size() > 0) {
-			auto err = item.FromCJSON(dataSlice);
-			if (!err.ok()) {
-				logPrintf(LogTrace, "Error load item to '%s' from storage: '%s'", name_.c_str(), err.what().c_str());
-				errCount++;
-				lastErr = err;
-			}
-
-			IdType id = items_.size();
-			items_.emplace_back(PayloadValue(item.GetPayload().RealSize()));
-			upsert(&item, id, false);
-
-			ldcount += dataSlice.size();
-		}
-	}
+	// Items are decoded from CJSON by loader threads, and upserted to indexes here
+	StorageLoader loader(payloadType_, tagsMatcher_);
+	// Ids are upserted in ascending order, so they are appended to idsets
+	for (auto &idx : indexes_) idx->SetBulkLoad(true);
+	try {
+		loader.Load(*dbIter, string_view(kStorageItemPrefix), string_view(kStorageItemPrefix "\xFF"),
+					[&](ItemImpl &item, const Error &err, size_t dataSize) {
+						if (!err.ok()) {
+							logPrintf(LogTrace, "Error load item to '%s' from storage: '%s'", name_.c_str(), err.what().c_str());
+							errCount++;
+							lastErr = err;
+						}
+
+						IdType id = items_.size();
+						items_.emplace_back(PayloadValue(item.GetPayload().RealSize()));
+						upsert(&item, id, false);
+
+						ldcount += dataSize;
+					});
+	} catch (...) {
+		for (auto &idx : indexes_) idx->SetBulkLoad(false);
+		throw;
+	}
+	for (auto &idx : indexes_) idx->SetBulkLoad(false);
 	logPrintf(LogInfo, "[%s] Done loading storage. %d items loaded (%d errors %s), total size=%dM", name_.c_str(), int(items_.size()),
 			  errCount, lastErr.what().c_str(), int(ldcount / (1024 * 1024)));
 }
 
 void Namespace::FlushStorage() {
-	WLock wlock(mtx_);
-	flushStorage();
+	std::lock_guard<std::mutex> flushLock(flushMtx_);
+	PerfStatCalculatorMT calc(flushPerfCounter_, enablePerfCounters_);
+	shared_ptr<datastorage::IDataStorage> storage;
+	{
+		WLock wlock(mtx_);
+		if (!storage_) {
+			calc.enable_ = false;
+			return;
+		}
+		storage = storage_;
+		putCachedMode();
+		putTagsMatcher();
+		// Swap collected updates with empty buffer, and write them to storage outside namespace lock
+		if (unflushedCount_ && !flushingCount_) {
+			if (!flushUpdates_) flushUpdates_.reset(storage_->GetUpdatesCollection());
+			std::swap(updates_, flushUpdates_);
+			flushingCount_ = unflushedCount_.exchange(0);
+		}
+		// Do not count flushes without updates
+		if (!flushingCount_) calc.enable_ = false;
+	}
+	calc.LockHit();
+	writeFlushUpdates(storage);
 }
 
 void Namespace::flushStorage() {
 	if (storage_) {
 		putCachedMode();
-
-		if (tagsMatcher_.isUpdated()) {
-			WrSerializer ser;
-			tagsMatcher_.serialize(ser);
-			updates_->Put(string_view(kStorageTagsPrefix), string_view(reinterpret_cast<const char *>(ser.Buf()), ser.Len()));
-			unflushedCount_++;
-			tagsMatcher_.clearUpdated();
-			logPrintf(LogTrace, "Saving tags of namespace %s:\n%s", name_.c_str(), tagsMatcher_.dump().c_str());
-		}
+		putTagsMatcher();
+		writeFlushUpdates(storage_);
 
 		if (unflushedCount_) {
 			Error status = storage_->Write(StorageOpts().FillCache(), *(updates_.get()));
@@ -1117,7 +1460,28 @@ void Namespace::flushStorage() {
 	}
 }
 
+void Namespace::putTagsMatcher() {
+	if (tagsMatcher_.isUpdated()) {
+		WrSerializer ser;
+		tagsMatcher_.serialize(ser);
+		updates_->Put(string_view(kStorageTagsPrefix), string_view(reinterpret_cast<const char *>(ser.Buf()), ser.Len()));
+		unflushedCount_++;
+		tagsMatcher_.clearUpdated();
+		logPrintf(LogTrace, "Saving tags of namespace %s:\n%s", name_.c_str(), tagsMatcher_.dump().c_str());
+	}
+}
+
+void Namespace::writeFlushUpdates(shared_ptr<datastorage::IDataStorage> storage) {
+	// If write was failed, then updates are kept in flushUpdates_, and will be written on next flush
+	if (!flushingCount_) return;
+	Error status = storage->Write(StorageOpts().FillCache(), *(flushUpdates_.get()));
+	if (!status.ok()) throw Error(errLogic, "Error write ns '%s' to storage: %s", name_.c_str(), status.what().c_str());
+	flushUpdates_->Clear();
+	flushingCount_ = 0;
+}
+
 void Namespace::DeleteStorage() {
+	std::lock_guard<std::mutex> flushLock(flushMtx_);
 	WLock lck(mtx_);
 	if (storage_) {
 		storage_->Destroy(dbpath_.c_str());
@@ -1126,6 +1490,7 @@ void Namespace::DeleteStorage() {
 	}
 }
 void Namespace::CloseStorage() {
+	std::lock_guard<std::mutex> flushLock(flushMtx_);
 	WLock lck(mtx_);
 	if (storage_) {
 		flushStorage();
@@ -1209,6 +1574,14 @@ Namespace *Namespace::Clone(Namespace::Ptr ns) {
 	return new Namespace(*ns);
 }
 
+uint64_t Namespace::indexesMask(const FieldsSet &indexes) {
+	uint64_t mask = 0;
+	for (auto idxNo : indexes) {
+		if (idxNo != IndexValueType::SetByJsonPath) mask |= uint64_t(1) << idxNo;
+	}
+	return mask;
+}
+
 int Namespace::getSortedIdxCount() const {
 	int cnt = 0;
 	for (auto &it : indexes_)
@@ -1303,7 +1676,7 @@ void Namespace::GetFromJoinCache(JoinCacheRes &ctx) {
 	ctx.needPut = false;
 	ctx.haveData = false;
 	if (it.key) {
-		if (!it.val.inited) {
+		if (!it.val.inited || it.val.version != ctx.version) {
 			ctx.needPut = true;
 		} else {
 			ctx.haveData = true;
@@ -1320,7 +1693,7 @@ void Namespace::GetIndsideFromJoinCache(JoinCacheRes &ctx) {
 	ctx.needPut = false;
 	ctx.haveData = false;
 	if (it.key) {
-		if (!it.val.inited) {
+		if (!it.val.inited || it.val.version != ctx.version) {
 			ctx.needPut = true;
 		} else {
 			ctx.haveData = true;
@@ -1333,11 +1706,13 @@ void Namespace::PutToJoinCache(JoinCacheRes &res, SelectCtx::PreResult::Ptr preR
 	JoinCacheVal joinCacheVal;
 	res.needPut = false;
 	joinCacheVal.inited = true;
+	joinCacheVal.version = res.version;
 	joinCacheVal.preResult = preResult;
 	joinCache_->Put(res.key, joinCacheVal);
 }
 void Namespace::PutToJoinCache(JoinCacheRes &res, JoinCacheVal &val) {
 	val.inited = true;
+	val.version = res.version;
 	joinCache_->Put(res.key, val);
 }
 void Namespace::SetCacheMode(CacheMode cacheMode) {
@@ -4,6 +4,7 @@
 #include <mutex>
 #include <vector>
 #include "core/cjson/tagsmatcher.h"
+#include "core/cjson/tupledictionary.h"
 #include "core/item.h"
 #include "core/selectfunc/selectfunc.h"
 #include "estl/fast_hash_map.h"
@@ -55,8 +56,8 @@ protected:
 
 	class NSUpdateSortedContext : public UpdateSortedContext {
 	public:
-		NSUpdateSortedContext(const Namespace &ns, SortType curSortId)
-			: ns_(ns), sorted_indexes_(ns_.getSortedIdxCount()), curSortId_(curSortId) {
+		NSUpdateSortedContext(const Namespace &ns, SortType curSortId, bool prevSortsValid)
+			: ns_(ns), sorted_indexes_(ns_.getSortedIdxCount()), curSortId_(curSortId), prevSortsValid_(prevSortsValid) {
 			ids2Sorts_.reserve(ns.items_.size());
 			for (IdType i = 0; i < IdType(ns_.items_.size()); i++)
 				ids2Sorts_.push_back(ns_.items_[i].IsFree() ? SortIdUnexists : SortIdUnfilled);
@@ -65,12 +66,17 @@ protected:
 		SortType getCurSortId() const override { return curSortId_; }
 		const vector<SortType> &ids2Sorts() const override { return ids2Sorts_; };
 		vector<SortType> &ids2Sorts() override { return ids2Sorts_; };
+		bool prevSortsValid() const override { return prevSortsValid_; }
+		const vector<SortType> &prevSorts2Sorts() const override { return prevSorts2Sorts_; };
+		vector<SortType> &prevSorts2Sorts() override { return prevSorts2Sorts_; };
 
 	protected:
 		const Namespace &ns_;
 		int sorted_indexes_;
 		IdType curSortId_;
+		bool prevSortsValid_;
 		vector<SortType> ids2Sorts_;
+		vector<SortType> prevSorts2Sorts_;
 	};
 
 	class IndexesStorage : public vector<unique_ptr<Index>> {
@@ -120,12 +126,16 @@ public:
 	void Upsert(Item &item, bool store = true);
 
 	void Delete(Item &item);
+	// Insert, update, upsert or delete batch of items under single lock
+	void ModifyItems(vector<Item> &items, int mode);
 	void Select(QueryResults &result, SelectCtx &params);
 	NamespaceDef GetDefinition();
 	NamespaceMemStat GetMemStat();
 	NamespacePerfStat GetPerfStat();
 	vector<string> EnumMeta();
 	void Delete(const Query &query, QueryResults &result);
+	// Set fields of items, which match query. Only indexes of changed fields are updated
+	void Update(const Query &query, QueryResults &result);
 	void FlushStorage();
 	void CloseStorage();
 	void SetCacheMode(CacheMode cacheMode);
@@ -149,15 +159,22 @@ public:
 		WLock lck(mtx_);
 		queriesLogLevel_ = lvl;
 	}
+	// Store tuples of non indexed fields compressed by dictionary of frequent strings. Tuples of existing items are compressed on enable
+	void EnableTuplesCompression(bool enable);
 
 protected:
 	void saveIndexesToStorage();
 	bool loadIndexesFromStorage();
 	void markUpdated();
+	// Get version of data, on which result of query depends. If withSort is false, order of result is not taken into account
+	uint64_t getCacheVersion(const Query &q, bool withSort = true) const;
 	void upsert(ItemImpl *ritem, IdType id, bool doUpdate);
 	void upsertInternal(Item &item, bool store = true, uint8_t mode = (INSERT_MODE | UPDATE_MODE));
+	void modifyItem(Item &item, bool store, uint8_t mode);
+	void deleteItem(Item &item);
 	void updateTagsMatcherFromItem(ItemImpl *ritem, string &jsonSliceBuf);
 	void updateItems(PayloadType oldPlType, const FieldsSet &changedFields, int deltaFields);
+	void compressTuple(KeyRefs &krefs, WrSerializer &ser, string_view &tuple);
 	void _delete(IdType id);
 	void commit(const NSCommitContext &ctx, SelectLockUpgrader *lockUpgrader);
 	void insertIndex(Index *newIndex, int idxNo, const string &realName);
@@ -169,6 +186,8 @@ protected:
 
 	string getMeta(const string &key);
 	void flushStorage();
+	void putTagsMatcher();
+	void writeFlushUpdates(shared_ptr<datastorage::IDataStorage> storage);
 	void putMeta(const string &key, const string_view &data);
 	void putCachedMode();
 	void getCachedMode();
@@ -176,6 +195,7 @@ protected:
 	pair<IdType, bool> findByPK(ItemImpl *ritem);
 
 	int getSortedIdxCount() const;
+	static uint64_t indexesMask(const FieldsSet &indexes);
 
 	void setFieldsBasedOnPrecepts(ItemImpl *ritem);
 
@@ -194,6 +214,8 @@ protected:
 	fast_hash_set<IdType> free_;
 	// Namespace name
 	string name_;
+	// Dictionary of frequent strings of tuples. It's shared with payload type, so tuples of query results can be read without lock
+	TupleDictionary::Ptr tupleDict_;
 	// Payload types
 	PayloadType payloadType_;
 
@@ -202,15 +224,27 @@ protected:
 
 	shared_ptr<datastorage::IDataStorage> storage_;
 	datastorage::UpdatesCollection::Ptr updates_;
-	int unflushedCount_;
-
+	std::atomic<int> unflushedCount_;
+	// Updates swapped out from updates_, which are being written to storage by FlushStorage outside of namespace lock
+	datastorage::UpdatesCollection::Ptr flushUpdates_;
+	std::atomic<int> flushingCount_;
+	// Serializes storage flushes. Must be locked before mtx_
+	std::mutex flushMtx_;
+
+	// Selects are holding shared lock for whole execution, and writers - exclusive lock. There is no snapshot read path:
+	// selects are still waiting for writers, and writers for selects
 	shared_timed_mutex mtx_;
 	shared_timed_mutex cache_mtx_;
 
 	// Commit phases state
 	bool sortOrdersBuilt_;
+	// Count of ordered indexes on last build of sort orders. Sorted idsets can be remapped to new sort orders only if it is not changed
+	int sortOrdersIdxCount_ = 0;
 	std::atomic<int> sortedQueriesCount_;
-	FieldsSet preparedIndexes_, commitedIndexes_;
+	// Masks of indexes, which idsets are commited and prepared for select. Selects are checking them without locking of commitMtx_
+	std::atomic<uint64_t> preparedIndexes_, commitedIndexes_;
+	// Serializes commit of indexes by selects, which are holding shared lock of namespace
+	std::mutex commitMtx_;
 	FieldsSet pkFields_;
 
 	unordered_map<string, string> meta_;
@@ -218,10 +252,15 @@ protected:
 	string dbpath_;
 
 	shared_ptr<QueryCache> queryCache_;
+	// Versions of data, which are checked by query and join caches on lookup instead of invalidation of caches on each write.
+	// dataVersion_ is changed by any modification, rowsVersion_ - by insert or delete of item, indexesVersions_ - by update of index value
+	uint64_t dataVersion_ = 0, rowsVersion_ = 0;
+	vector<uint64_t> indexesVersions_;
 	// shows if each subindex was PK
 	fast_hash_map<string, bool> compositeIndexesPkState_;
 
 	int sparseIndexesCount_ = 0;
+	bool compressTuples_ = false;
 
 private:
 	Namespace(const Namespace &src);
@@ -239,7 +278,9 @@ private:
 	CacheMode cacheMode_;
 	bool needPutCacheMode_;
 
-	PerfStatCounterMT updatePerfCounter_, selectPerfCounter_;
+	PerfStatCounterMT updatePerfCounter_, selectPerfCounter_, flushPerfCounter_;
+	// Latencies of phases of selects
+	LatencyHistogram selectPreparePerf_, selectIndexesPerf_, selectPostprocessPerf_, selectLoopPerf_;
 	std::atomic<bool> enablePerfCounters_;
 	LogLevel queriesLogLevel_;
 };
@@ -39,6 +39,8 @@ void NamespaceMemStat::GetJSON(WrSerializer &ser) {
 	joinCache.GetJSON(ser);
 	ser.Printf(",\"query_cache\":");
 	queryCache.GetJSON(ser);
+	ser.Printf(",\"tuples\":");
+	tuples.GetJSON(ser);
 	ser.Printf(",\"indexes\":[");
 	for (unsigned i = 0; i < indexes.size(); i++) {
 		if (i != 0) ser.PutChar(',');
@@ -48,6 +50,18 @@ void NamespaceMemStat::GetJSON(WrSerializer &ser) {
 	ser.PutChars("]}");
 };
 
+void TuplesMemStat::GetJSON(WrSerializer &ser) {
+	ser.PutChar('{');
+
+	ser.Printf("\"compressed\":%s,", compressed ? "true" : "false");
+	ser.Printf("\"dict_strings_count\":%" PRI_SIZE_T ",", dictStringsCount);
+	ser.Printf("\"dict_size\":%" PRI_SIZE_T ",", dictSize);
+	ser.Printf("\"tuples_size\":%" PRI_SIZE_T ",", tuplesSize);
+	ser.Printf("\"uncompressed_tuples_size\":%" PRI_SIZE_T, uncompressedTuplesSize);
+
+	ser.PutChar('}');
+}
+
 void LRUCacheMemStat::GetJSON(WrSerializer &ser) {
 	ser.PutChar('{');
 
@@ -86,7 +100,33 @@ void PerfStat::GetJSON(WrSerializer &ser) {
 	ser.Printf("\"total_avg_lock_time_us\":%" PRI_SIZE_T ",", totalLockTimeUs);
 	ser.Printf("\"last_sec_qps\":%" PRI_SIZE_T ",", avgHitCount);
 	ser.Printf("\"last_sec_avg_lock_time_us\":%" PRI_SIZE_T ",", avgLockTimeUs);
-	ser.Printf("\"last_sec_avg_latency_us\":%" PRI_SIZE_T "", avgTimeUs);
+	ser.Printf("\"last_sec_avg_latency_us\":%" PRI_SIZE_T ",", avgTimeUs);
+	ser.Printf("\"latency\":");
+	latency.GetJSON(ser);
+	ser.Printf(",\"lock_time\":");
+	lockTime.GetJSON(ser);
+	ser.PutChar('}');
+}
+
+void LatencyStat::GetJSON(WrSerializer &ser) const {
+	ser.PutChar('{');
+	ser.Printf("\"p50_us\":%" PRI_SIZE_T ",", p50Us);
+	ser.Printf("\"p90_us\":%" PRI_SIZE_T ",", p90Us);
+	ser.Printf("\"p99_us\":%" PRI_SIZE_T ",", p99Us);
+	ser.Printf("\"p999_us\":%" PRI_SIZE_T ",", p999Us);
+	ser.Printf("\"max_us\":%" PRI_SIZE_T "", maxUs);
+	ser.PutChar('}');
+}
+
+void SelectPhasesPerfStat::GetJSON(WrSerializer &ser) const {
+	ser.Printf("{\"prepare\":");
+	prepare.GetJSON(ser);
+	ser.Printf(",\"indexes\":");
+	indexes.GetJSON(ser);
+	ser.Printf(",\"postprocess\":");
+	postprocess.GetJSON(ser);
+	ser.Printf(",\"loop\":");
+	loop.GetJSON(ser);
 	ser.PutChar('}');
 }
 
@@ -97,6 +137,11 @@ void NamespacePerfStat::GetJSON(WrSerializer &ser) {
 	updates.GetJSON(ser);
 	ser.Printf(",\"selects\":");
 	selects.GetJSON(ser);
+	ser.Printf(",\"storage_flushes\":");
+	storageFlushes.GetJSON(ser);
+	ser.Printf(",\"select_phases\":");
+	selectPhases.GetJSON(ser);
+	ser.Printf(",\"storage_backlog\":%" PRI_SIZE_T, storageBacklog);
 	ser.PutChar('}');
 }
 
@@ -32,6 +32,18 @@ struct IndexMemStat {
 	LRUCacheMemStat idsetCache;
 };
 
+// Memory usage of tuples of non indexed fields
+struct TuplesMemStat {
+	void GetJSON(WrSerializer &ser);
+	// Tuples are compressed by dictionary of frequent strings
+	bool compressed = false;
+	size_t dictStringsCount = 0;
+	size_t dictSize = 0;
+	// Total size of tuples of items, and their size without references to dictionary
+	size_t tuplesSize = 0;
+	size_t uncompressedTuplesSize = 0;
+};
+
 struct NamespaceMemStat {
 	void GetJSON(WrSerializer &ser);
 
@@ -49,9 +61,20 @@ struct NamespaceMemStat {
 	} Total;
 	LRUCacheMemStat joinCache;
 	LRUCacheMemStat queryCache;
+	TuplesMemStat tuples;
 	std::vector<IndexMemStat> indexes;
 };
 
+// Percentiles of latency
+struct LatencyStat {
+	void GetJSON(WrSerializer &ser) const;
+	size_t p50Us = 0;
+	size_t p90Us = 0;
+	size_t p99Us = 0;
+	size_t p999Us = 0;
+	size_t maxUs = 0;
+};
+
 struct PerfStat {
 	void GetJSON(WrSerializer &ser);
 	size_t totalHitCount;
@@ -60,6 +83,21 @@ struct PerfStat {
 	size_t avgHitCount;
 	size_t avgTimeUs;
 	size_t avgLockTimeUs;
+	LatencyStat latency;
+	LatencyStat lockTime;
+};
+
+// Latencies of phases of selects, which are measured by select loop
+struct SelectPhasesPerfStat {
+	void GetJSON(WrSerializer &ser) const;
+	// Preparation of query and evaluation of query plan
+	LatencyStat prepare;
+	// Selection of idsets from indexes
+	LatencyStat indexes;
+	// Postprocessing of idsets and preparation of joins
+	LatencyStat postprocess;
+	// Iteration over ids and check of conditions
+	LatencyStat loop;
 };
 
 struct NamespacePerfStat {
@@ -67,6 +105,11 @@ struct NamespacePerfStat {
 	std::string name;
 	PerfStat updates;
 	PerfStat selects;
+	// Storage flushes. Lock time is time of holding namespace write lock by flush
+	PerfStat storageFlushes;
+	SelectPhasesPerfStat selectPhases;
+	// Count of updates, which are not written to storage yet
+	size_t storageBacklog = 0;
 };
 
 }  // namespace reindexer
\ No newline at end of file
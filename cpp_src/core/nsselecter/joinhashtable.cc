@@ -0,0 +1,72 @@
+#include "joinhashtable.h"
+#include <algorithm>
+#include "core/payload/payloadiface.h"
+
+namespace reindexer {
+
+void JoinHashTable::Build(ItemRefVector &&items) {
+	assert(fields_.size());
+	rows_ = std::move(items);
+	std::sort(rows_.begin(), rows_.end(), [](const ItemRef &lhs, const ItemRef &rhs) { return lhs.id < rhs.id; });
+
+	KeyRefs krefs;
+	for (int n = 0; n < int(rows_.size()); n++) {
+		ConstPayload(payloadType_, rows_[n].value).Get(fields_[0].field, krefs);
+		for (auto &kref : krefs) {
+			auto &bucket = map_[KeyValue(kref)];
+			// Array field can contain same value several times
+			if (bucket.empty() || bucket.back() != n) bucket.push_back(n);
+		}
+	}
+}
+
+bool JoinHashTable::Probe(h_vector<KeyValues, 2> &keys, Rows &rows, unsigned limit) const {
+	assert(keys.size() == fields_.size());
+	rows.clear();
+	for (size_t i = 0; i < keys.size(); i++) {
+		for (auto &key : keys[i]) key.convert(fields_[i].type);
+	}
+
+	bool found = false;
+	bool merged = keys[0].size() > 1;
+	for (auto &key : keys[0]) {
+		auto it = map_.find(key);
+		if (it == map_.end()) continue;
+		for (int n : it->second) {
+			if (fields_.size() > 1 && !matchRest(rows_[n], keys)) continue;
+			found = true;
+			// if only one key, then bucket is already ordered - stop on limit
+			if (!merged && rows.size() >= limit) return found;
+			rows.push_back(n);
+		}
+	}
+
+	if (merged && rows.size()) {
+		std::sort(rows.begin(), rows.end());
+		rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+	}
+	if (rows.size() > limit) rows.erase(rows.begin() + limit, rows.end());
+	return found;
+}
+
+bool JoinHashTable::matchRest(const ItemRef &row, const h_vector<KeyValues, 2> &keys) const {
+	KeyRefs krefs;
+	ConstPayload pl(payloadType_, row.value);
+	for (size_t i = 1; i < fields_.size(); i++) {
+		pl.Get(fields_[i].field, krefs);
+		bool match = false;
+		for (auto &kref : krefs) {
+			for (auto &key : keys[i]) {
+				if (static_cast<const KeyRef &>(key) == kref) {
+					match = true;
+					break;
+				}
+			}
+			if (match) break;
+		}
+		if (!match) return false;
+	}
+	return true;
+}
+
+}  // namespace reindexer
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include "core/keyvalue/keyvalue.h"
+#include "core/payload/payloadtype.h"
+#include "core/query/queryresults.h"
+#include "estl/fast_hash_map.h"
+#include "estl/h_vector.h"
+
+namespace reindexer {
+
+using std::shared_ptr;
+
+// Hash table over rows of joined namespace, keyed by values of join fields.
+// It is built once per query from the joined namespace pre result, and then probed for each row of main namespace,
+// instead of executing select on joined namespace for each row of main namespace
+class JoinHashTable {
+public:
+	typedef shared_ptr<JoinHashTable> Ptr;
+	struct KeyField {
+		int field;
+		KeyValueType type;
+	};
+	typedef h_vector<KeyField, 2> KeyFields;
+	typedef h_vector<int, 8> Rows;
+
+	JoinHashTable(const PayloadType &payloadType, const KeyFields &fields) : payloadType_(payloadType), fields_(fields) {}
+
+	// Build table from rows of joined namespace. Table is keyed by 1-st key field, other fields are checked on probe
+	void Build(ItemRefVector &&items);
+	// Find rows, matched to keys of main namespace row. keys[i] contains values for fields[i]
+	// Rows are returned in ascending order of ids
+	bool Probe(h_vector<KeyValues, 2> &keys, Rows &rows, unsigned limit) const;
+
+	const ItemRef &Row(int n) const { return rows_[n]; }
+	size_t Size() const { return rows_.size(); }
+
+protected:
+	bool matchRest(const ItemRef &row, const h_vector<KeyValues, 2> &keys) const;
+
+	PayloadType payloadType_;
+	KeyFields fields_;
+	ItemRefVector rows_;
+	fast_hash_map<KeyValue, Rows> map_;
+};
+
+}  // namespace reindexer
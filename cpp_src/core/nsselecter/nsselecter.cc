@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <sstream>
 
 #include "core/cjson/cjsonencoder.h"
 #include "core/cjson/jsonencoder.h"
 #include "core/index/index.h"
+#include "core/indexdef.h"
 #include "core/namespace.h"
 #include "nsselecter.h"
+#include "queryworkers.h"
 #include "tools/logger.h"
 #include "tools/stringstools.h"
 
@@ -18,8 +21,28 @@ using std::stringstream;
 
 // Number of sorted queries to namespace after last updated, to call very expensive buildSortOrders, to do futher queries fast
 // If number of queries was less, than kBuildSortOrdersHitCount, then slow post process sort (applyGeneralSort) is
+// On rebuild sorted idsets of keys, which were not updated, are remapped to new sort orders
 const int kBuildSortOrdersHitCount = 5;
 
+// Parallel scan is split to morsels: kMorselsPerWorker morsels for each worker, but not less than kMinMorselSize items in morsel
+const int kMorselsPerWorker = 8;
+const int kMinMorselSize = 4096;
+// Aggregations are computed from keys of index, if loop visits at least 1/kIndexedAggregationRatio of items.
+// Otherwise flags of matched items, which are allocated for all items of namespace, cost more than the loop itself
+const size_t kIndexedAggregationRatio = 4;
+
+// Condition with several keys is checked by comparator instead of union of idsets, if it's estimated to match
+// kComparatorSelectivityRatio times more items, than driving condition
+const int kComparatorSelectivityRatio = 8;
+// Sorted query is sorted after selection instead of building of sort orders, if it's estimated to match less than
+// 1/kPostSortSelectivityRatio of items
+const int kPostSortSelectivityRatio = 16;
+
+// Index, which has no own idsets, and is always checked by comparator
+static bool isStore(IndexType type) {
+	return type == IndexIntStore || type == IndexInt64Store || type == IndexStrStore || type == IndexDoubleStore || type == IndexBool;
+}
+
 namespace reindexer {
 #define TIMEPOINT(n)                                  \
 	std::chrono::high_resolution_clock::time_point n; \
@@ -34,16 +57,20 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 		const_cast<Query *>(&ctx.query)->debugLevel = ns_->queriesLogLevel_;
 	}
 
-	bool enableTiming = ctx.query.debugLevel >= LogInfo;
+	bool explain = ctx.query.explain_;
+	bool perfCounters = ns_->enablePerfCounters_;
+	bool enableTiming = ctx.query.debugLevel >= LogInfo || explain || perfCounters;
 
 	TIMEPOINT(tmStart);
 
 	bool needCalcTotal = ctx.query.calcTotal == ModeAccurateTotal;
 	bool needPutCachedTotal = false;
+	uint64_t cacheVersion = 0;
 
 	if (ctx.query.calcTotal == ModeCachedTotal) {
+		cacheVersion = ns_->getCacheVersion(ctx.query, false);
 		auto cached = ns_->queryCache_->Get({ctx.query});
-		if (cached.key && cached.val.total_count >= 0) {
+		if (cached.key && cached.val.total_count >= 0 && cached.val.version == cacheVersion) {
 			result.totalCount = cached.val.total_count;
 			logPrintf(LogTrace, "[*] using value from cache: %d\t namespace: %s\n", result.totalCount, ns_->name_.c_str());
 		} else {
@@ -79,12 +106,17 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 			}
 		}
 	}
+	// Joined queries are executed for each item of main query, so they are not planned
+	QueryPlan plan;
+	bool planQuery = !ctx.skipIndexesLookup && !containsFullText;
+	if (planQuery) estimateConditions(*whereEntries, plan);
+
 	// DO NOT use deducted sort order in the following cases:
 	// - query contains explicity specified sort order
 	// - query contains FullText query.
 	bool disableOptimizeSortOrder = !ctx.query.sortBy.empty() || ctx.preResult;
 
-	auto sortBy = (containsFullText || disableOptimizeSortOrder) ? ctx.query.sortBy : getOptimalSortOrder(*whereEntries);
+	auto sortBy = (containsFullText || disableOptimizeSortOrder) ? ctx.query.sortBy : getOptimalSortOrder(*whereEntries, plan);
 	int sortByIdxNo = sortBy.empty() ? -1 : ns_->getIndexByName(sortBy);
 
 	if (ctx.preResult) {
@@ -101,10 +133,13 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 		}
 	}
 
+	if (planQuery) planSelection(*whereEntries, ctx, sortBy, plan);
+
 	// Check if commit needed
-	bool needSortOrders = !sortBy.empty() && (ns_->sortedQueriesCount_ > kBuildSortOrdersHitCount || ctx.preResult || ctx.joinedSelectors);
+	bool needSortOrders = !sortBy.empty() && !plan.postSort &&
+						  (ns_->sortedQueriesCount_ > kBuildSortOrdersHitCount || ctx.preResult || ctx.joinedSelectors);
 
-	if (!whereEntries->empty() || needSortOrders) {
+	if (!whereEntries->empty() || needSortOrders || !ctx.query.aggregations_.empty()) {
 		FieldsSet indexesForCommit;
 		for (const QueryEntry &entry : *whereEntries) {
 			if (entry.idxNo != IndexValueType::SetByJsonPath) {
@@ -112,6 +147,8 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 			}
 		}
 		if (sortByIdxNo >= 0) indexesForCommit.push_back(sortByIdxNo);
+		// Indexed aggregations visit idsets of keys, so they must be commited too
+		for (auto &ag : ctx.query.aggregations_) indexesForCommit.push_back(ns_->getIndexByName(ag.index_));
 		for (int i = ns_->indexes_.firstCompositePos(); i < ns_->indexes_.totalSize(); i++) {
 			if (indexesForCommit.contains(ns_->indexes_[i]->Fields())) indexesForCommit.push_back(i);
 		}
@@ -150,7 +187,13 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 	}
 	TIMEPOINT(tm1);
 
-	selectWhere(*whereEntries, qres, sortIndex ? sortIndex->SortId() : 0, containsFullText);
+	selectWhere(*whereEntries, qres, sortIndex ? sortIndex->SortId() : 0, containsFullText, plan);
+
+	// All ids will be iterated, or iterators will be reused by joins - so merge dense unions once by bitmap
+	if (!containsFullText && (ctx.isForceAll || needCalcTotal || ctx.query.count == UINT_MAX ||
+							  (ctx.preResult && ctx.preResult->mode == SelectCtx::PreResult::ModeBuild))) {
+		for (auto &r : qres) r.MergeDenseIdsets();
+	}
 
 	TIMEPOINT(tm2);
 
@@ -225,7 +268,9 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 
 	// Let iterators choose most effecive algorith
 	assert(qres.size());
-	for (auto r = qres.begin() + 1; r != qres.end(); r++) r->SetExpectMaxIterations(iters);
+	// Comparators are called with ids in ascending or descending order, if items are not iterated by sort index or full text
+	bool orderedIds = !sortIndex && !containsFullText;
+	for (auto r = qres.begin() + 1; r != qres.end(); r++) r->SetExpectMaxIterations(iters, orderedIds);
 
 	result.addNSContext(ns_->payloadType_, ns_->tagsMatcher_, JsonPrintFilter(ns_->tagsMatcher_, ctx.query.selectFilter_));
 
@@ -235,15 +280,41 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 	lctx.qres = &qres;
 	lctx.ftIndex = containsFullText;
 	lctx.calcTotal = needCalcTotal;
+	// Results could be streamed only, if they are selected in final order, and are not post processed
+	lctx.stream = ctx.streamConsumer && !unorderedIndexSort && !forcedSort && !ctx.isForceAll && !containsFullText &&
+				  (!ctx.joinedSelectors || ctx.joinedSelectors->empty());
+	// Sorted query with limit keeps only offset+limit first items in sort order, instead of sort of all matched items
+	std::unique_ptr<TopNSorter> topN;
+	if (unorderedIndexSort && !forcedSort && !containsFullText && ctx.query.count != UINT_MAX && ctx.query.mergeQueries_.empty() &&
+		ctx.query.aggregations_.empty() && (!ctx.joinedSelectors || ctx.joinedSelectors->empty()) &&
+		!(ctx.preResult && ctx.preResult->mode == SelectCtx::PreResult::ModeBuild)) {
+		int sortFieldIdx = ns_->getIndexByName(sortBy);
+		if (!ns_->indexes_[sortFieldIdx]->Opts().IsArray()) {
+			FieldsSet fields;
+			if (sortFieldIdx >= ns_->payloadType_->NumFields()) {
+				fields = ns_->indexes_[sortFieldIdx]->Fields();
+			} else {
+				fields.push_back(sortFieldIdx);
+			}
+			topN.reset(new TopNSorter(ns_->payloadType_, fields, collateOpts, ctx.query.sortDirDesc,
+									  size_t(ctx.query.start) + size_t(ctx.query.count)));
+			lctx.topN = topN.get();
+		}
+	}
 	result.haveProcent = containsFullText;
-	if (reverse && haveComparators && haveScan) selectLoop<true, true, true>(lctx, result);
-	if (!reverse && haveComparators && haveScan) selectLoop<false, true, true>(lctx, result);
-	if (reverse && !haveComparators && haveScan) selectLoop<true, false, true>(lctx, result);
-	if (!reverse && !haveComparators && haveScan) selectLoop<false, false, true>(lctx, result);
-	if (reverse && haveComparators && !haveScan) selectLoop<true, true, false>(lctx, result);
-	if (!reverse && haveComparators && !haveScan) selectLoop<false, true, false>(lctx, result);
-	if (reverse && !haveComparators && !haveScan) selectLoop<true, false, false>(lctx, result);
-	if (!reverse && !haveComparators && !haveScan) selectLoop<false, false, false>(lctx, result);
+	int workers = haveComparators ? getParallelism(lctx) : 1;
+	if (workers > 1) {
+		selectParallel(lctx, result, reverse, haveScan, workers);
+	} else {
+		if (reverse && haveComparators && haveScan) selectLoop<true, true, true>(lctx, result);
+		if (!reverse && haveComparators && haveScan) selectLoop<false, true, true>(lctx, result);
+		if (reverse && !haveComparators && haveScan) selectLoop<true, false, true>(lctx, result);
+		if (!reverse && !haveComparators && haveScan) selectLoop<false, false, true>(lctx, result);
+		if (reverse && haveComparators && !haveScan) selectLoop<true, true, false>(lctx, result);
+		if (!reverse && haveComparators && !haveScan) selectLoop<false, true, false>(lctx, result);
+		if (reverse && !haveComparators && !haveScan) selectLoop<true, false, false>(lctx, result);
+		if (!reverse && !haveComparators && !haveScan) selectLoop<false, false, false>(lctx, result);
+	}
 
 	TIMEPOINT(tm4);
 
@@ -275,10 +346,38 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 		}
 	}
 
-	if (unorderedIndexSort) {
+	if (topN) {
+		topN->Finish(result.Items());
+	} else if (unorderedIndexSort) {
 		applyGeneralSort(result.Items(), ctx, sortBy, collateOpts);
 	}
 
+	if (perfCounters) {
+		ns_->selectPreparePerf_.Add(duration_cast<microseconds>(tm1 - tmStart));
+		ns_->selectIndexesPerf_.Add(duration_cast<microseconds>(tm2 - tm1));
+		ns_->selectPostprocessPerf_.Add(duration_cast<microseconds>(tm3 - tm2));
+		ns_->selectLoopPerf_.Add(duration_cast<microseconds>(tm4 - tm3));
+	}
+
+	if (explain) {
+		plan.sortIndex = sortBy;
+		plan.postSort = unorderedIndexSort;
+		plan.prepareUs = int(duration_cast<microseconds>(tm1 - tmStart).count());
+		plan.indexesUs = int(duration_cast<microseconds>(tm2 - tm1).count());
+		plan.postprocessUs = int(duration_cast<microseconds>(tm3 - tm2).count());
+		plan.loopUs = int(duration_cast<microseconds>(tm4 - tm3).count());
+		for (auto &r : qres) {
+			plan.selectors.push_back(
+				{r.name, int(r.size()), int(r.comparators_.size()), r.GetMaxIterations(), r.GetMatchedCount(), r.Cost(iters)});
+		}
+		if (ctx.joinedSelectors) {
+			for (auto &js : *ctx.joinedSelectors) plan.joins.push_back({js.ns, js.type, js.cost, js.called, js.matched});
+		}
+		WrSerializer ser;
+		plan.GetJSON(ser);
+		result.explainResults = ser.Slice().ToString();
+	}
+
 	if (!ctx.query.forcedSortOrder.empty()) {
 		applyCustomSort(result.Items(), ctx);
 	}
@@ -289,7 +388,7 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx) {
 
 	if (needPutCachedTotal) {
 		logPrintf(LogTrace, "[*] put totalCount value into query cache: %d\t namespace: %s\n", result.totalCount, ns_->name_.c_str());
-		ns_->queryCache_->Put({ctx.query}, {static_cast<size_t>(result.totalCount)});
+		ns_->queryCache_->Put({ctx.query}, {static_cast<size_t>(result.totalCount), cacheVersion});
 	}
 	if (ctx.preResult && ctx.preResult->mode == SelectCtx::PreResult::ModeBuild) {
 		ctx.preResult->mode = SelectCtx::PreResult::ModeIdSet;
@@ -456,9 +555,10 @@ QueryEntries NsSelecter::lookupQueryIndexes(const QueryEntries &entries) {
 	return ret;
 }
 
-void NsSelecter::selectWhere(const QueryEntries &entries, RawQueryResult &result, unsigned sortId, bool is_ft) {
+void NsSelecter::selectWhere(const QueryEntries &entries, RawQueryResult &result, unsigned sortId, bool is_ft, const QueryPlan &plan) {
 	bool fullText = false;
-	for (const QueryEntry &qe : entries) {
+	for (size_t i = 0; i < entries.size(); i++) {
+		const QueryEntry &qe = entries[i];
 		TagsPath tagsPath;
 		SelectKeyResults selectResults;
 		bool sparseIndex = false;
@@ -481,7 +581,7 @@ void NsSelecter::selectWhere(const QueryEntries &entries, RawQueryResult &result
 
 			Index::ResultType type = Index::Optimal;
 			if (is_ft && qe.distinct) throw Error(errQueryExec, "distinct and full text - can't do it");
-			if (is_ft)
+			if (is_ft || (i < plan.conditions.size() && plan.conditions[i].comparator))
 				type = Index::ForceComparator;
 			else if (qe.distinct)
 				type = Index::ForceIdset;
@@ -531,18 +631,26 @@ void NsSelecter::selectLoop(LoopCtx &ctx, QueryResults &result) {
 		start = sctx.query.start;
 		count = sctx.query.count;
 	}
-	auto aggregators = getAggregators(sctx.query);
 	// do not calc total by loop, if we have only 1 condition with 1 idset
 	bool calcTotal = ctx.calcTotal && (ctx.qres->size() > 1 || haveComparators || (*ctx.qres)[0].size() > 1);
 
 	// reserve queryresults, if we have only 1 condition with 1 idset
-	if (ctx.qres->size() == 1 && (*ctx.qres)[0].size() == 1) {
+	if (!ctx.topN && ctx.qres->size() == 1 && (*ctx.qres)[0].size() == 1) {
 		unsigned reserve = std::min(unsigned(ctx.qres->at(0).GetMaxIterations()), count);
         result.Items().reserve(reserve);
 	}
 
 	bool finish = (count == 0) && !sctx.reqMatchedOnceFlag && !calcTotal;
 
+	// Indexed aggregations of all items are computed from keys of indexes, without iteration over items
+	bool aggregateAll = !sctx.query.aggregations_.empty() && sctx.query.entries.empty() && !start && count == UINT_MAX && !calcTotal &&
+						!sctx.preResult && !sctx.reqMatchedOnceFlag && (!sctx.joinedSelectors || sctx.joinedSelectors->empty());
+	size_t maxIterations = std::min(size_t(std::max((*ctx.qres)[0].GetMaxIterations(), 0)), size_t(count));
+	auto aggregators = getAggregators(sctx.query, maxIterations, aggregateAll);
+	if (aggregateAll && std::all_of(aggregators.begin(), aggregators.end(), [](const Aggregator &a) { return a.IsIndexed(); })) {
+		finish = true;
+	}
+
 	bool haveInnerJoin = false;
 	if (sctx.joinedSelectors) {
 		for (size_t i = 0; i < sctx.joinedSelectors->size(); i++) {
@@ -661,8 +769,15 @@ void NsSelecter::selectLoop(LoopCtx &ctx, QueryResults &result) {
 					for (auto &aggregator : aggregators) aggregator.Aggregate(ns_->items_[realVal], realVal);
 				} else if (sctx.preResult && sctx.preResult->mode == SelectCtx::PreResult::ModeBuild) {
 					sctx.preResult->ids.Add(val, IdSet::Unordered);
+				} else if (ctx.topN) {
+					ctx.topN->Push({realVal, ns_->items_[realVal].GetVersion(), ns_->items_[realVal], proc, sctx.nsid});
 				} else {
 					result.Add({realVal, ns_->items_[realVal].GetVersion(), ns_->items_[realVal], proc, sctx.nsid});
+					if (ctx.stream && result.Count() >= size_t(kStreamResultsBatchSize)) {
+						Error err = (*sctx.streamConsumer)(result, false);
+						if (!err.ok()) throw err;
+						result.Items().clear();
+					}
 				}
 			}
 			if (!count && !calcTotal) break;
@@ -670,6 +785,7 @@ void NsSelecter::selectLoop(LoopCtx &ctx, QueryResults &result) {
 		}
 	}
 	for (auto &aggregator : aggregators) {
+		aggregator.Finish(ns_->items_);
 		result.aggregationResults.push_back(aggregator.GetResult());
 	}
 
@@ -683,13 +799,158 @@ void NsSelecter::selectLoop(LoopCtx &ctx, QueryResults &result) {
 	}
 }
 
-h_vector<Aggregator, 4> NsSelecter::getAggregators(const Query &q) {
+// Queries, which scan range of items and check each item by comparators, can be executed in parallel:
+// range is split to morsels, which are processed by shared pool of workers, and matched items are merged in order of morsels
+int NsSelecter::getParallelism(const LoopCtx &ctx) {
+	const SelectCtx &sctx = ctx.sctx;
+	int workers = sctx.query.parallelism ? sctx.query.parallelism : sctx.parallelism;
+	if (workers == 0) workers = QueryWorkers::MaxWorkers();
+	if (workers <= 1 || ctx.ftIndex || ctx.stream || sctx.preResult || sctx.reqMatchedOnceFlag) return 1;
+	if (sctx.joinedSelectors && sctx.joinedSelectors->size()) return 1;
+	// Parallel execution is worth only, if all matched items are required
+	if (!sctx.isForceAll && !ctx.calcTotal && (sctx.query.count != UINT_MAX || sctx.query.start) && sctx.query.aggregations_.empty())
+		return 1;
+	if (!sctx.isForceAll && !sctx.query.count) return 1;
+
+	IdType first, last;
+	if (!(*ctx.qres)[0].GetRange(first, last) || (*ctx.qres)[0].op != OpAnd) return 1;
+	if (size_t(last - first) < std::max(sctx.parallelScanThreshold, size_t(1))) return 1;
+	for (auto it = ctx.qres->begin() + 1; it != ctx.qres->end(); it++) {
+		if (it->size() || !it->comparators_.size() || it->distinct || (it->op != OpAnd && it->op != OpNot)) return 1;
+	}
+	return workers;
+}
+
+void NsSelecter::selectParallel(LoopCtx &ctx, QueryResults &result, bool reverse, bool haveScan, int workers) {
+	unsigned start = 0;
+	unsigned count = UINT_MAX;
+	SelectCtx &sctx = ctx.sctx;
+
+	if (!sctx.isForceAll) {
+		start = sctx.query.start;
+		count = sctx.query.count;
+	}
+	auto aggregators = getAggregators(sctx.query, std::max((*ctx.qres)[0].GetMaxIterations(), 0), false);
+	// Aggregate by workers, if all matched items are aggregated, otherwise aggregate matched items in window [start, start+count)
+	bool aggregateByWorkers = aggregators.size() && !start && count == UINT_MAX;
+
+	IdType first = 0, last = 0;
+	(*ctx.qres)[0].GetRange(first, last);
+	int morsels = std::min(workers * kMorselsPerWorker, (last - first + kMinMorselSize - 1) / kMinMorselSize);
+	int morselSize = (last - first + morsels - 1) / morsels;
+
+	// Each worker has own copies of comparators and aggregators
+	struct workerCtx {
+		bool started = false;
+		h_vector<SelectIterator> comparators;
+		h_vector<Aggregator, 4> aggregators;
+	};
+	vector<workerCtx> workerCtxs(workers);
+	vector<vector<IdType>> matched(morsels);
+	vector<size_t> matchedCount(morsels, 0);
+
+	QueryWorkers::ParallelFor(workers, morsels, [&](int worker, int morsel) {
+		auto &wctx = workerCtxs[worker];
+		if (!wctx.started) {
+			wctx.comparators.assign(ctx.qres->begin() + 1, ctx.qres->end());
+			if (aggregateByWorkers) wctx.aggregators = aggregators;
+			wctx.started = true;
+		}
+		IdType from = first + morsel * morselSize;
+		IdType to = std::min(from + morselSize, last);
+		auto &ids = matched[morsel];
+
+		for (IdType val = from; val < to; val++) {
+			IdType realVal = val;
+			if (haveScan && ns_->items_[realVal].IsFree()) continue;
+			if (ctx.sortIndex) {
+				assert(ctx.sortIndex->SortOrders().size() > static_cast<size_t>(val));
+				realVal = ctx.sortIndex->SortOrders()[val];
+			}
+			PayloadValue &itemPayloadValue(ns_->items_[realVal]);
+			bool found = true;
+			for (auto &cur : wctx.comparators) {
+				if (cur.TryCompare(itemPayloadValue, realVal) == (cur.op == OpNot)) {
+					found = false;
+					break;
+				}
+			}
+			if (!found) continue;
+			matchedCount[morsel]++;
+			if (aggregateByWorkers) {
+				for (auto &aggregator : wctx.aggregators) aggregator.Aggregate(itemPayloadValue, realVal);
+			} else {
+				ids.push_back(realVal);
+			}
+		}
+	});
+
+	size_t total = 0;
+	for (auto cnt : matchedCount) total += cnt;
+	if (total) sctx.matchedAtLeastOnce = true;
+	if (ctx.calcTotal) result.totalCount += total;
+
+	if (aggregateByWorkers) {
+		for (auto &wctx : workerCtxs) {
+			if (!wctx.started) continue;
+			for (size_t i = 0; i < aggregators.size(); i++) aggregators[i].Merge(wctx.aggregators[i]);
+		}
+	} else {
+		if (aggregators.empty() && !ctx.topN) result.Items().reserve(result.Items().size() + std::min(total, size_t(count)));
+		// Morsels are merged in order of iteration, so result is the same, as result of sequential loop
+		for (int i = 0; i < morsels && count; i++) {
+			auto &ids = matched[reverse ? morsels - 1 - i : i];
+			for (size_t j = 0; j < ids.size() && count; j++) {
+				IdType realVal = reverse ? ids[ids.size() - 1 - j] : ids[j];
+				if (start) {
+					--start;
+					continue;
+				}
+				--count;
+				if (aggregators.size()) {
+					for (auto &aggregator : aggregators) aggregator.Aggregate(ns_->items_[realVal], realVal);
+				} else if (ctx.topN) {
+					ctx.topN->Push({realVal, ns_->items_[realVal].GetVersion(), ns_->items_[realVal], 0, sctx.nsid});
+				} else {
+					result.Add({realVal, ns_->items_[realVal].GetVersion(), ns_->items_[realVal], 0, sctx.nsid});
+				}
+			}
+		}
+	}
+	for (auto &aggregator : aggregators) {
+		aggregator.Finish(ns_->items_);
+		result.aggregationResults.push_back(aggregator.GetResult());
+	}
+}
+
+h_vector<Aggregator, 4> NsSelecter::getAggregators(const Query &q, size_t maxIterations, bool allMatched) {
 	h_vector<Aggregator, 4> ret;
 
 	for (auto &ag : q.aggregations_) {
 		int idx = ns_->getIndexByName(ag.index_);
-		ret.push_back(Aggregator(ns_->indexes_[idx]->KeyType(), ns_->indexes_[idx]->Opts().IsArray(), nullptr, ag.type_));
-		ret.back().Bind(ns_->payloadType_, idx);
+		auto &index = ns_->indexes_[idx];
+		if (isComposite(index->Type())) throw Error(errQueryExec, "Aggregation by composite index '%s' is not supported", ag.index_.c_str());
+		bool numeric = index->KeyType() == KeyValueInt || index->KeyType() == KeyValueInt64 || index->KeyType() == KeyValueDouble;
+		bool byKeys = ag.type_ == AggFacet || ag.type_ == AggCountDistinct;
+		if (!numeric && !byKeys) {
+			throw Error(errQueryExec, "Aggregation '%s' can be applied only to numeric index, but '%s' is not numeric",
+						AggregationResult::TypeName(ag.type_), ag.index_.c_str());
+		}
+		bool byIndex = byKeys || ag.type_ == AggMin || ag.type_ == AggMax;
+		if (index->Opts().IsSparse() && !byIndex) {
+			throw Error(errQueryExec, "Aggregation '%s' can't be applied to sparse index '%s'", AggregationResult::TypeName(ag.type_),
+						ag.index_.c_str());
+		}
+		ret.push_back(Aggregator(index->KeyType(), index->Opts().IsArray(), nullptr, ag.type_, ag.index_, ag.limit_));
+		if (index->Opts().IsSparse()) {
+			ret.back().BindJsonPath(ns_->payloadType_, index->Fields().getTagsPath(0));
+		} else {
+			ret.back().Bind(ns_->payloadType_, idx);
+		}
+		// Facets, min and max of large share of items are computed from keys of index, instead of payloads of items
+		if (byIndex && (allMatched || maxIterations * kIndexedAggregationRatio >= ns_->items_.size())) {
+			ret.back().BindIndex(index.get(), ns_->items_.size(), allMatched);
+		}
 	}
 
 	return ret;
@@ -740,22 +1001,110 @@ void NsSelecter::updateCompositeIndexesValues(QueryEntries &qentries) {
 	}
 }
 
-const string &NsSelecter::getOptimalSortOrder(const QueryEntries &entries) {
-	Index *maxIdx = nullptr;
+const string &NsSelecter::getOptimalSortOrder(const QueryEntries &entries, const QueryPlan &plan) {
+	// Range by sort index is iterated as single range of sort orders. So the most selective range is chosen,
+	// or range by the biggest index, if selectivity of ranges is unknown
+	Index *maxIdx = nullptr, *minEstimatedIdx = nullptr;
+	double minEstimated = 0;
 	static string no = "";
-	for (auto c = entries.begin(); c != entries.end(); c++) {
+	for (size_t i = 0; i < entries.size(); i++) {
+		auto c = &entries[i];
 		if (((c->idxNo != IndexValueType::SetByJsonPath) && (c->condition == CondGe || c->condition == CondGt || c->condition == CondLe ||
 															 c->condition == CondLt || c->condition == CondRange)) &&
 			!c->distinct && ns_->indexes_[c->idxNo]->IsOrdered()) {
 			if (!maxIdx || ns_->indexes_[c->idxNo]->Size() > maxIdx->Size()) {
 				maxIdx = ns_->indexes_[c->idxNo].get();
 			}
+			double estimated = i < plan.conditions.size() ? plan.conditions[i].estimated : -1;
+			if (estimated >= 0 && (!minEstimatedIdx || estimated < minEstimated)) {
+				minEstimatedIdx = ns_->indexes_[c->idxNo].get();
+				minEstimated = estimated;
+			}
 		}
 	}
 
+	if (minEstimatedIdx) return minEstimatedIdx->Name();
 	return maxIdx ? maxIdx->Name() : no;
 }
 
+void NsSelecter::estimateConditions(const QueryEntries &entries, QueryPlan &plan) {
+	double itemsCount = double(ns_->items_.size() - ns_->free_.size());
+	for (auto &qe : entries) {
+		plan.conditions.push_back(QueryPlan::Condition(qe.Dump()));
+		if (qe.idxNo == IndexValueType::SetByJsonPath) continue;
+		auto stats = ns_->indexes_[qe.idxNo]->Stats();
+		if (stats) plan.conditions.back().estimated = std::min(stats->Estimate(qe.values, qe.condition), itemsCount);
+	}
+
+	// Conditions, which are united by OR, are selected by single iterator, so driver is chosen from groups of them
+	bool unknownDriver = false;
+	for (size_t i = 0; i < entries.size();) {
+		size_t groupEnd = i + 1;
+		double estimated = plan.conditions[i].estimated;
+		for (; groupEnd < entries.size() && entries[groupEnd].op == OpOr; groupEnd++) {
+			double orEstimated = plan.conditions[groupEnd].estimated;
+			estimated = (estimated < 0 || orEstimated < 0) ? -1 : estimated + orEstimated;
+		}
+		if (entries[i].op == OpAnd) {
+			if (estimated >= 0 && (plan.estimatedItems < 0 || estimated < plan.estimatedItems)) {
+				plan.estimatedItems = std::min(estimated, itemsCount);
+				plan.driver = i;
+			}
+			// Items of unknown selectivity could be selected by idsets of index, which has no statistics yet
+			const QueryEntry &qe = entries[i];
+			if (estimated < 0 && qe.idxNo != IndexValueType::SetByJsonPath && !isStore(ns_->indexes_[qe.idxNo]->Type()) &&
+				!isComposite(ns_->indexes_[qe.idxNo]->Type())) {
+				unknownDriver = true;
+			}
+		}
+		i = groupEnd;
+	}
+	if (unknownDriver) plan.driver = -1;
+}
+
+void NsSelecter::planSelection(const QueryEntries &entries, SelectCtx &ctx, const string &sortBy, QueryPlan &plan) {
+	plan.sortIndex = sortBy;
+
+	// Sort orders are rebuilt for all items after update of namespace, so selective query is cheaper to sort after selection
+	bool haveJoins = ctx.joinedSelectors && !ctx.joinedSelectors->empty();
+	if (!sortBy.empty() && !ns_->sortOrdersBuilt_ && !ctx.preResult && !haveJoins && plan.estimatedItems >= 0) {
+		plan.postSort = plan.estimatedItems * kPostSortSelectivityRatio < double(ns_->items_.size() - ns_->free_.size());
+	}
+
+	if (plan.driver >= 0) {
+		double driverEstimated = plan.conditions[plan.driver].estimated;
+		for (size_t i = 0; i < entries.size(); i++) {
+			const QueryEntry &qe = entries[i];
+			auto &cond = plan.conditions[i];
+			if (int(i) == plan.driver || cond.estimated < driverEstimated * kComparatorSelectivityRatio) continue;
+			if (qe.op != OpAnd || qe.distinct || qe.idxNo == IndexValueType::SetByJsonPath || qe.idxNo >= ns_->payloadType_->NumFields())
+				continue;
+			// Conditions, which are united by OR, are selected by single iterator
+			if (i + 1 < entries.size() && entries[i + 1].op == OpOr) continue;
+			auto &index = ns_->indexes_[qe.idxNo];
+			// Range by sort index is selected as single range of sort orders, it's cheap
+			if (index->Opts().IsSparse() || index->Name() == sortBy) continue;
+			// Idset of single key is intersected with driver by binary search, but union of idsets of many keys is expensive
+			bool manyKeys = (qe.condition == CondSet && qe.values.size() > 1) || qe.condition == CondLt || qe.condition == CondLe ||
+							qe.condition == CondGt || qe.condition == CondGe || qe.condition == CondRange;
+			if (manyKeys) cond.comparator = true;
+		}
+	}
+
+	if (haveJoins) {
+		// Consecutive inner joins are commutative, and each next of them is called only for items, which are matched by previous ones.
+		// OR inner join is applied to result of previous joins, so joins are not moved across it
+		auto &js = *ctx.joinedSelectors;
+		for (size_t i = 0; i < js.size();) {
+			size_t end = i;
+			while (end < js.size() && js[end].type == JoinType::InnerJoin) end++;
+			std::stable_sort(js.begin() + i, js.begin() + end,
+							 [](const JoinedSelector &lhs, const JoinedSelector &rhs) { return lhs.cost < rhs.cost; });
+			i = std::max(end, i + 1);
+		}
+	}
+}
+
 int NsSelecter::getCompositeIndex(const FieldsSet &fields) {
 	if (fields.getTagsPathsLength() == 0) {
 		for (int i = ns_->indexes_.firstCompositePos(); i < ns_->indexes_.totalSize(); i++) {
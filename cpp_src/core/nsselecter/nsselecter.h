@@ -1,7 +1,9 @@
 #pragma once
 #include <functional>
 #include "core/aggregator.h"
+#include "core/nsselecter/queryplan.h"
 #include "core/nsselecter/selectiterator.h"
+#include "core/nsselecter/topnsorter.h"
 #include "core/query/query.h"
 #include "core/query/queryresults.h"
 #include "core/selectfunc/ctx/basefunctionctx.h"
@@ -20,6 +22,8 @@ struct JoinedSelector {
 	FuncType func;
 	int called, matched;
 	string ns;
+	// Estimated cost of call of selector. Consecutive inner joins are called in ascending order of costs
+	double cost;
 };
 typedef vector<JoinedSelector> JoinedSelectors;
 
@@ -37,8 +41,14 @@ struct SelectCtx {
 	uint8_t nsid = 0;
 	bool isForceAll = false;
 	bool skipIndexesLookup = false;
+	// Max number of threads to execute query, if it is not set by query. 0 - number of CPU cores
+	int parallelism = 1;
+	// Min number of items to scan, to execute query in parallel
+	size_t parallelScanThreshold = 0;
 	SelectLockUpgrader *lockUpgrader;
 	SelectFunctionsHolder *functions = nullptr;
+	// If set, items are passed to consumer by batches during select, instead of collecting all of them in results
+	const QueryResultsConsumer *streamConsumer = nullptr;
 	struct PreResult {
 		enum Mode { ModeBuild, ModeIterators, ModeIdSet };
 
@@ -68,20 +78,27 @@ private:
 		Index *sortIndex = nullptr;
 		bool ftIndex = false;
 		bool calcTotal = false;
+		bool stream = false;
+		// Matched items are kept by top-N heap, instead of adding to results
+		TopNSorter *topN = nullptr;
 		SelectCtx &sctx;
 	};
 
 	template <bool reverse, bool haveComparators, bool haveDistinct>
 	void selectLoop(LoopCtx &ctx, QueryResults &result);
+	int getParallelism(const LoopCtx &ctx);
+	void selectParallel(LoopCtx &ctx, QueryResults &result, bool reverse, bool haveScan, int workers);
 	void applyCustomSort(ItemRefVector &result, const SelectCtx &ctx);
 	void applyGeneralSort(ItemRefVector &result, const SelectCtx &ctx, const string &fieldName, const CollateOpts &collateOpts);
 
 	bool containsFullTextIndexes(const QueryEntries &entries);
-	void selectWhere(const QueryEntries &entries, RawQueryResult &result, SortType sortId, bool is_ft);
+	void selectWhere(const QueryEntries &entries, RawQueryResult &result, SortType sortId, bool is_ft, const QueryPlan &plan);
 	QueryEntries lookupQueryIndexes(const QueryEntries &entries);
 	void substituteCompositeIndexes(QueryEntries &entries);
-	const string &getOptimalSortOrder(const QueryEntries &entries);
-	h_vector<Aggregator, 4> getAggregators(const Query &q);
+	const string &getOptimalSortOrder(const QueryEntries &entries, const QueryPlan &plan);
+	void estimateConditions(const QueryEntries &entries, QueryPlan &plan);
+	void planSelection(const QueryEntries &entries, SelectCtx &ctx, const string &sortBy, QueryPlan &plan);
+	h_vector<Aggregator, 4> getAggregators(const Query &q, size_t maxIterations, bool allMatched);
 	int getCompositeIndex(const FieldsSet &fieldsmask);
 	bool mergeQueryEntries(QueryEntry *lhs, QueryEntry *rhs);
 	void setLimitsAndOffset(ItemRefVector &result, const SelectCtx &ctx);
@@ -0,0 +1,45 @@
+#include "core/nsselecter/queryplan.h"
+#include "core/query/query.h"
+#include "tools/serializer.h"
+
+namespace reindexer {
+
+void QueryPlan::GetJSON(WrSerializer &ser) const {
+	ser.Printf("{\"prepare_us\":%d,\"indexes_us\":%d,\"postprocess_us\":%d,\"loop_us\":%d,", prepareUs, indexesUs, postprocessUs, loopUs);
+	ser.PutChars("\"sort_index\":");
+	ser.PrintJsonString(sortIndex);
+	ser.Printf(",\"sort_by_index\":%s,\"estimated_items\":%.0f,", (!sortIndex.empty() && !postSort) ? "true" : "false", estimatedItems);
+
+	ser.PutChars("\"conditions\":[");
+	for (size_t i = 0; i < conditions.size(); i++) {
+		auto &c = conditions[i];
+		if (i) ser.PutChar(',');
+		ser.PutChars("{\"condition\":");
+		ser.PrintJsonString(c.description);
+		ser.Printf(",\"estimated\":%.0f,\"method\":\"%s\",\"driver\":%s}", c.estimated, c.comparator ? "comparator" : "index",
+				   int(i) == driver ? "true" : "false");
+	}
+
+	ser.PutChars("],\"selectors\":[");
+	for (size_t i = 0; i < selectors.size(); i++) {
+		auto &s = selectors[i];
+		if (i) ser.PutChar(',');
+		ser.PutChars("{\"name\":");
+		ser.PrintJsonString(s.name);
+		ser.Printf(",\"idsets\":%d,\"comparators\":%d,\"max_iterations\":%d,\"cost\":%.0f,\"matched\":%d}", s.idsets, s.comparators,
+				   s.maxIterations, s.cost, s.matched);
+	}
+
+	ser.PutChars("],\"joins\":[");
+	for (size_t i = 0; i < joins.size(); i++) {
+		auto &j = joins[i];
+		if (i) ser.PutChar(',');
+		ser.PutChars("{\"namespace\":");
+		ser.PrintJsonString(j.ns);
+		ser.Printf(",\"type\":\"%s\",\"cost\":%.0f,\"called\":%d,\"matched\":%d}", Query::JoinTypeName(j.type), j.cost, j.called,
+				   j.matched);
+	}
+	ser.PutChars("]}");
+}
+
+}  // namespace reindexer
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "core/type_consts.h"
+#include "estl/h_vector.h"
+
+namespace reindexer {
+
+using std::string;
+using std::vector;
+
+class WrSerializer;
+
+// Plan of query execution. Plan is chosen by statistics of indexes before selection of idsets,
+// and is returned with results, if query is explained
+struct QueryPlan {
+	// Condition of query with estimated count of matched items
+	struct Condition {
+		Condition() {}
+		Condition(const string &desc) : description(desc) {}
+		string description;
+		// Negative, if condition can't be estimated
+		double estimated = -1;
+		// Condition is checked by comparator, instead of selection of idsets
+		bool comparator = false;
+	};
+	// Iterator of items, which is used by select loop
+	struct Selector {
+		string name;
+		int idsets, comparators, maxIterations, matched;
+		double cost;
+	};
+	struct Join {
+		string ns;
+		JoinType type;
+		double cost;
+		int called, matched;
+	};
+
+	void GetJSON(WrSerializer &ser) const;
+
+	h_vector<Condition, 4> conditions;
+	// Condition, which is expected to match the least count of items. Items are selected by it's idsets
+	int driver = -1;
+	double estimatedItems = -1;
+	string sortIndex;
+	// Results are sorted after selection, instead of iteration over sort orders of index
+	bool postSort = false;
+
+	// Execution details of explained query
+	h_vector<Selector, 4> selectors;
+	h_vector<Join, 1> joins;
+	int prepareUs = 0, indexesUs = 0, postprocessUs = 0, loopUs = 0;
+};
+
+}  // namespace reindexer
@@ -0,0 +1,64 @@
+#include "queryworkers.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include "tools/workerpool.h"
+
+namespace reindexer {
+
+struct parallelForState {
+	parallelForState(int morsels, const QueryWorkers::MorselFunc &fn) : morsels(morsels), fn(fn) {}
+
+	void run(int worker) {
+		for (;;) {
+			int morsel = next++;
+			if (morsel >= morsels) return;
+			std::exception_ptr err;
+			try {
+				fn(worker, morsel);
+			} catch (...) {
+				err = std::current_exception();
+			}
+			std::lock_guard<std::mutex> lck(mtx);
+			if (err && !error) error = err;
+			if (++done == morsels) cond.notify_all();
+		}
+	}
+
+	std::atomic<int> next{0};
+	const int morsels;
+	// fn is referenced only while there are not processed morsels, so it can live on caller's stack
+	const QueryWorkers::MorselFunc &fn;
+	std::mutex mtx;
+	std::condition_variable cond;
+	int done = 0;
+	std::exception_ptr error;
+};
+
+static WorkerPool &queryPool() {
+	static WorkerPool pool;
+	return pool;
+}
+
+int QueryWorkers::MaxWorkers() { return std::max(int(std::thread::hardware_concurrency()), 1); }
+
+void QueryWorkers::ParallelFor(int workers, int morsels, const MorselFunc &fn) {
+	if (morsels <= 0) return;
+	workers = std::min(std::min(workers, morsels), MaxWorkers());
+
+	// Helpers can be started by pool after all morsels are done, so state is shared with them
+	auto state = std::make_shared<parallelForState>(morsels, fn);
+	for (int i = 1; i < workers; i++) {
+		queryPool().Post([state, i]() { state->run(i); });
+	}
+	state->run(0);
+
+	std::unique_lock<std::mutex> lck(state->mtx);
+	state->cond.wait(lck, [&state]() { return state->done == state->morsels; });
+	if (state->error) std::rethrow_exception(state->error);
+}
+
+}  // namespace reindexer
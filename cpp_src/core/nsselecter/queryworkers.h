@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+
+namespace reindexer {
+
+/// Shared pool of threads for parallel execution of heavy queries
+class QueryWorkers {
+public:
+	/// Function, which processes one morsel of query
+	/// @param worker - number of worker in [0, workers). Morsels of one worker are processed sequentially
+	/// @param morsel - number of morsel in [0, morsels)
+	typedef std::function<void(int worker, int morsel)> MorselFunc;
+
+	/// Process morsels by up to workers threads, including caller's thread. Morsels are picked by threads dynamically,
+	/// so threads, which were done faster, are processing more morsels. Returns when all morsels are processed
+	/// First exception, thrown by fn, is rethrown in caller's thread
+	/// @param workers - Max number of threads to use
+	/// @param morsels - Number of morsels to process
+	/// @param fn - Function, which processes morsel
+	static void ParallelFor(int workers, int morsels, const MorselFunc &fn);
+	/// Get max number of threads, which can process query in parallel
+	static int MaxWorkers();
+};
+
+}  // namespace reindexer
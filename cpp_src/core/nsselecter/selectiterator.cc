@@ -48,6 +48,9 @@ void SelectIterator::Start(bool reverse) {
 		type_ = begin()->isRange_ ? SingleRange : SingleIdset;
 	} else if (size() == 1) {
 		type_ = begin()->isRange_ ? RevSingleRange : RevSingleIdset;
+	} else if (size() >= kMinIdsetsToHeap) {
+		type_ = reverse_ ? ReverseHeap : ForwardHeap;
+		buildHeap();
 	}
 	if (size() == 0) {
 		type_ = OnlyComparator;
@@ -108,6 +111,108 @@ bool SelectIterator::nextRev(IdType maxHint) {
 	return !(lastVal_ == INT_MIN);
 }
 
+// Heap next implementation
+// *************************
+void SelectIterator::buildHeap() {
+	heap_.clear();
+	heap_.reserve(size());
+	for (auto it = begin(); it != end(); it++) {
+		int idx = it - begin();
+		if (it->isRange_) {
+			if (!reverse_ && it->rIt_ < it->rEnd_) heap_.push_back({it->rIt_, idx});
+			if (reverse_ && it->rrIt_ > it->rrEnd_) heap_.push_back({it->rrIt_, idx});
+		} else {
+			if (!reverse_ && it->it_ != it->end_) heap_.push_back({*it->it_, idx});
+			if (reverse_ && it->rit_ != it->rend_) heap_.push_back({*it->rit_, idx});
+		}
+	}
+	for (size_t pos = heap_.size() / 2; pos > 0; pos--) heapSiftDown(pos - 1);
+}
+
+void SelectIterator::heapSiftDown(size_t pos) {
+	HeapEntry entry = heap_[pos];
+	for (;;) {
+		size_t child = 2 * pos + 1;
+		if (child >= heap_.size()) break;
+		if (child + 1 < heap_.size() && heapBefore(heap_[child + 1], heap_[child])) child++;
+		if (!heapBefore(heap_[child], entry)) break;
+		heap_[pos] = heap_[child];
+		pos = child;
+	}
+	heap_[pos] = entry;
+}
+
+bool SelectIterator::nextFwdHeap(IdType minHint) {
+	if (minHint > lastVal_) lastVal_ = minHint - 1;
+
+	// Only idsets, which are behind of lastVal_ are moved, each by O(log K) steps
+	while (!heap_.empty() && heap_.front().val <= lastVal_) {
+		HeapEntry &top = heap_.front();
+		auto it = begin() + top.idx;
+		bool exhausted;
+		if (it->isRange_) {
+			it->rIt_ = min(it->rEnd_, max(it->rIt_, lastVal_ + 1));
+			exhausted = it->rIt_ == it->rEnd_;
+			if (!exhausted) top.val = it->rIt_;
+		} else {
+			if (it->bsearch_) {
+				it->it_ = std::lower_bound(it->it_, it->end_, lastVal_ + 1);
+			} else {
+				for (; it->it_ != it->end_ && *it->it_ <= lastVal_; it->it_++) {
+				}
+			}
+			exhausted = it->it_ == it->end_;
+			if (!exhausted) top.val = *it->it_;
+		}
+		if (exhausted) {
+			top = heap_.back();
+			heap_.pop_back();
+		}
+		if (!heap_.empty()) heapSiftDown(0);
+	}
+
+	if (heap_.empty()) {
+		lastVal_ = INT_MAX;
+		return false;
+	}
+	lastVal_ = heap_.front().val;
+	lastIt_ = begin() + heap_.front().idx;
+	return true;
+}
+
+bool SelectIterator::nextRevHeap(IdType maxHint) {
+	if (maxHint < lastVal_) lastVal_ = maxHint + 1;
+
+	while (!heap_.empty() && heap_.front().val >= lastVal_) {
+		HeapEntry &top = heap_.front();
+		auto it = begin() + top.idx;
+		bool exhausted;
+		if (it->isRange_) {
+			it->rrIt_ = max(it->rrEnd_, min(it->rrIt_, lastVal_ - 1));
+			exhausted = it->rrIt_ == it->rrEnd_;
+			if (!exhausted) top.val = it->rrIt_;
+		} else {
+			for (; it->rit_ != it->rend_ && *it->rit_ >= lastVal_; it->rit_++) {
+			}
+			exhausted = it->rit_ == it->rend_;
+			if (!exhausted) top.val = *it->rit_;
+		}
+		if (exhausted) {
+			top = heap_.back();
+			heap_.pop_back();
+		}
+		if (!heap_.empty()) heapSiftDown(0);
+	}
+
+	if (heap_.empty()) {
+		lastVal_ = INT_MIN;
+		return false;
+	}
+	lastVal_ = heap_.front().val;
+	lastIt_ = begin() + heap_.front().idx;
+	return true;
+}
+
 // Single idset next implementation
 // ********************************
 bool SelectIterator::nextFwdSingleIdset(IdType minHint) {
@@ -190,6 +295,24 @@ void SelectIterator::ExcludeLastSet() {
 	assert(!comparators_.size());
 }
 
+bool SelectIterator::GetRange(IdType &first, IdType &last) const {
+	if (size() != 1 || !begin()->isRange_ || comparators_.size()) return false;
+	if (reverse_) {
+		first = begin()->rrEnd_ + 1;
+		last = begin()->rrBegin_ + 1;
+	} else {
+		first = begin()->rBegin_;
+		last = begin()->rEnd_;
+	}
+	return true;
+}
+
+void SelectIterator::MergeDenseIdsets() {
+	// Distinct needs separate idset of each key, and full text needs positions of ids in it's idsets
+	if (distinct || is_unsorted || forcedFirst_ || size() < kMinIdsetsToMerge || !canMergeByBitmap()) return;
+	mergeIdsets();
+}
+
 void SelectIterator::Append(SelectKeyResult &other) {
 	for (auto &r : other) push_back(std::move(r));
 	for (auto &c : other.comparators_) {
@@ -210,12 +333,18 @@ double SelectIterator::Cost(int expectedIterations) const {
 
 	if (size() < 2 && !comparators_.size()) return double(GetMaxIterations());
 
-	if (comparators_.size()) return expectedIterations + GetMaxIterations() * size() + 1;
+	if (comparators_.size()) return expectedIterations + GetMaxIterations() * unionFactor() + 1;
+
+	return GetMaxIterations() * unionFactor();
+}
 
-	return GetMaxIterations() * size();
+double SelectIterator::unionFactor() const {
+	// Linear scan of all K idsets, or sift down of heap of K idsets
+	if (size() < kMinIdsetsToHeap) return double(size());
+	return 2 * std::log2(double(size()));
 }
 
-void SelectIterator::SetExpectMaxIterations(int expectedIterations) {
+void SelectIterator::SetExpectMaxIterations(int expectedIterations, bool orderedIds) {
 	for (auto &r : *this) {
 		if (!r.isRange_ && r.ids_.size() > 1) {
 			int itersloop = r.ids_.size();
@@ -223,6 +352,7 @@ void SelectIterator::SetExpectMaxIterations(int expectedIterations) {
 			r.bsearch_ = itersbsearch < itersloop;
 		}
 	}
+	for (auto &cmp : comparators_) cmp.SetExpectMaxIterations(expectedIterations, orderedIds);
 }
 
 int SelectIterator::GetMaxIterations() const {
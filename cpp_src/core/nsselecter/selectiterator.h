@@ -15,6 +15,8 @@ public:
 		RevSingleIdset,
 		OnlyComparator,
 		Unsorted,
+		ForwardHeap,
+		ReverseHeap,
 	};
 
 	SelectIterator() {}
@@ -51,6 +53,12 @@ public:
 			case Unsorted:
 				res = nextUnsorted();
 				break;
+			case ForwardHeap:
+				res = nextFwdHeap(minHint);
+				break;
+			case ReverseHeap:
+				res = nextRevHeap(minHint);
+				break;
 		}
 		if (res) matchedCount_++;
 		return res;
@@ -75,7 +83,11 @@ public:
 	void AppendAndBind(SelectKeyResult &other, PayloadType type, int field);
 	double Cost(int totalIds) const;
 	int GetMaxIterations() const;
-	void SetExpectMaxIterations(int expectedIterations_);
+	void SetExpectMaxIterations(int expectedIterations_, bool orderedIds);
+	// Get bounds [first, last) of iterator, which is single continuous range of ids. Must be called after Start
+	bool GetRange(IdType &first, IdType &last) const;
+	// Merge union of many dense idsets into single idset. Merged idset is iterated much faster, than K-way union
+	void MergeDenseIdsets();
 
 	OpType op;
 	bool distinct;
@@ -90,8 +102,26 @@ protected:
 	bool nextFwdSingleIdset(IdType minHint);
 	bool nextRevSingleRange(IdType minHint);
 	bool nextRevSingleIdset(IdType minHint);
+	bool nextFwdHeap(IdType minHint);
+	bool nextRevHeap(IdType minHint);
 	bool is_unsorted = false;
 
+	// Heap of current ids of idsets and ranges in union. Top of heap is the next id of union
+	struct HeapEntry {
+		IdType val;
+		int idx;
+	};
+	void buildHeap();
+	void heapSiftDown(size_t pos);
+	bool heapBefore(const HeapEntry &lhs, const HeapEntry &rhs) const { return reverse_ ? lhs.val > rhs.val : lhs.val < rhs.val; }
+	// Number of steps to get next id of union
+	double unionFactor() const;
+
+	// Minimal number of idsets in union, which are worth to be merged
+	static const size_t kMinIdsetsToMerge = 4;
+	// Minimal number of idsets and ranges in union, which are iterated by heap instead of linear scan
+	static const size_t kMinIdsetsToHeap = 8;
+
 	bool reverse_ = false;
 	bool forcedFirst_;
 	int type_;
@@ -100,6 +130,7 @@ protected:
 	IdType end_ = 0;
 	int matchedCount_ = 0;
 	int counter_ = 0;
+	std::vector<HeapEntry> heap_;
 };
 
 }  // namespace reindexer
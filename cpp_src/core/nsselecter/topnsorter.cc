@@ -0,0 +1,99 @@
+#include "core/nsselecter/topnsorter.h"
+#include <algorithm>
+#include <cstring>
+#include "core/payload/payloadiface.h"
+#include "tools/customlocal.h"
+
+namespace reindexer {
+
+TopNSorter::TopNSorter(const PayloadType &payloadType, const FieldsSet &fields, const CollateOpts &collateOpts, bool desc, size_t limit)
+	: payloadType_(payloadType), fields_(fields), collateOpts_(collateOpts), desc_(desc), limit_(limit) {
+	if (fields_.size() != 1 || fields_.getTagsPathsLength() || *fields_.begin() < 0 || *fields_.begin() >= payloadType_->NumFields())
+		return;
+	auto &field = payloadType_->Field(*fields_.begin());
+	if (field.IsArray()) return;
+	switch (field.Type()) {
+		case KeyValueInt:
+		case KeyValueInt64:
+		case KeyValueDouble:
+			exactKey_ = true;
+			break;
+		case KeyValueString:
+			// Prefix of string is normalized only for byte-wise and ASCII case insensitive collations
+			if (collateOpts_.mode != CollateNone && collateOpts_.mode != CollateASCII) return;
+			break;
+		default:
+			return;
+	}
+	keyField_ = *fields_.begin();
+	keyType_ = field.Type();
+	heap_.reserve(std::min(limit_, size_t(kDefaultQueryResultsSize * 64)));
+}
+
+uint64_t TopNSorter::makeKey(const PayloadValue &pv) const {
+	if (keyField_ < 0) return 0;
+	const uint8_t *ptr = pv.Ptr() + payloadType_->Field(keyField_).Offset();
+	// Keys are mapped to unsigned integers with the same order
+	const uint64_t signBit = 1ULL << 63;
+	switch (keyType_) {
+		case KeyValueInt:
+			return uint64_t(int64_t(*reinterpret_cast<const int *>(ptr))) ^ signBit;
+		case KeyValueInt64:
+			return uint64_t(*reinterpret_cast<const int64_t *>(ptr)) ^ signBit;
+		case KeyValueDouble: {
+			uint64_t bits;
+			memcpy(&bits, ptr, sizeof(bits));
+			return (bits & signBit) ? ~bits : (bits | signBit);
+		}
+		default:
+			break;
+	}
+
+	// Big-endian first 8 bytes of string. Shorter strings are padded by zeros, so equal prefixes are compared by payloads
+	string_view str(*reinterpret_cast<const p_string *>(ptr));
+	uint64_t key = 0;
+	for (size_t i = 0; i < sizeof(key); i++) {
+		uint8_t ch = 0;
+		if (i < str.size()) {
+			// ASCII collation compares lowered chars as signed values
+			ch = collateOpts_.mode == CollateASCII ? uint8_t(int(int8_t(ToLower(wchar_t(str[i])))) + 128) : uint8_t(str[i]);
+		}
+		key = (key << 8) | ch;
+	}
+	return key;
+}
+
+bool TopNSorter::less(const Entry &lhs, const Entry &rhs) const {
+	if (lhs.key != rhs.key) return desc_ ? lhs.key > rhs.key : lhs.key < rhs.key;
+	if (!exactKey_) {
+		int res = ConstPayload(payloadType_, lhs.item.value).Compare(rhs.item.value, fields_, collateOpts_);
+		if (res) return desc_ ? res > 0 : res < 0;
+	}
+	return lhs.seq < rhs.seq;
+}
+
+void TopNSorter::Push(ItemRef &&item) {
+	if (!limit_) return;
+	uint64_t key = makeKey(item.value);
+	auto cmp = [this](const Entry &lhs, const Entry &rhs) { return less(lhs, rhs); };
+	if (heap_.size() < limit_) {
+		heap_.push_back({key, seq_++, std::move(item)});
+		std::push_heap(heap_.begin(), heap_.end(), cmp);
+		return;
+	}
+	// Item is compared with the last of kept items, before it is added to heap
+	Entry entry{key, seq_++, std::move(item)};
+	if (!less(entry, heap_.front())) return;
+	std::pop_heap(heap_.begin(), heap_.end(), cmp);
+	heap_.back() = std::move(entry);
+	std::push_heap(heap_.begin(), heap_.end(), cmp);
+}
+
+void TopNSorter::Finish(ItemRefVector &result) {
+	std::sort_heap(heap_.begin(), heap_.end(), [this](const Entry &lhs, const Entry &rhs) { return less(lhs, rhs); });
+	result.reserve(result.size() + heap_.size());
+	for (auto &entry : heap_) result.push_back(std::move(entry.item));
+	heap_.clear();
+}
+
+}  // namespace reindexer
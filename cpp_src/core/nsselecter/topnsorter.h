@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include "core/indexopts.h"
+#include "core/payload/fieldsset.h"
+#include "core/payload/payloadtype.h"
+#include "core/query/queryresults.h"
+
+namespace reindexer {
+
+// Bounded heap of the first N matched items in sort order. It is used by sorted queries with limit, which can't be
+// iterated by sort orders of index, so only N items are kept instead of materialization and sort of all matched items.
+// Each item is compared by precomputed key: value of numeric field, or normalized prefix of string field.
+// Payloads are compared only if keys are not exact and equal
+class TopNSorter {
+public:
+	TopNSorter(const PayloadType &payloadType, const FieldsSet &fields, const CollateOpts &collateOpts, bool desc, size_t limit);
+
+	void Push(ItemRef &&item);
+	// Move kept items to result in sort order
+	void Finish(ItemRefVector &result);
+
+	size_t Size() const { return heap_.size(); }
+
+protected:
+	struct Entry {
+		uint64_t key;
+		// Order of matching. Equal items are kept in order of matching
+		size_t seq;
+		ItemRef item;
+	};
+
+	uint64_t makeKey(const PayloadValue &pv) const;
+	// Returns true, if lhs is placed before rhs in sort order
+	bool less(const Entry &lhs, const Entry &rhs) const;
+
+	PayloadType payloadType_;
+	FieldsSet fields_;
+	CollateOpts collateOpts_;
+	bool desc_;
+	size_t limit_;
+	// Field, which value is key of item, or -1 if items are compared by payloads only
+	int keyField_ = -1;
+	KeyValueType keyType_ = KeyValueUndefined;
+	// Equal keys mean equal items
+	bool exactKey_ = false;
+	size_t seq_ = 0;
+	// Max-heap by sort order: top of heap is the last of kept items
+	std::vector<Entry> heap_;
+};
+
+}  // namespace reindexer
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "estl/cow.h"
@@ -12,6 +13,8 @@ namespace reindexer {
 using std::string;
 using std::vector;
 
+class TupleDictionary;
+
 // Type of all payload object
 class PayloadTypeImpl {
 public:
@@ -38,18 +41,26 @@ public:
 	size_t TotalSize() const;
 	string ToString() const;
 
+	// Dictionary of strings, which are referenced by compressed tuples. nullptr, if tuples are not compressed
+	const TupleDictionary *TupleDict() const { return tupleDict_.get(); }
+	void SetTupleDictionary(std::shared_ptr<const TupleDictionary> dict) { tupleDict_ = std::move(dict); }
+
 protected:
 	vector<PayloadFieldType> fields_;
 	fast_hash_map<string, int> fieldsByName_;
 	fast_hash_map<string, int> fieldsByJsonPath_;
 	string name_;
 	vector<int> strFields_;
+	std::shared_ptr<const TupleDictionary> tupleDict_;
 };
 
 class PayloadType : public shared_cow_ptr<PayloadTypeImpl> {
 public:
 	PayloadType() {}
 	PayloadType(const string &name) : shared_cow_ptr<PayloadTypeImpl>(std::make_shared<PayloadTypeImpl>(name)) {}
+	PayloadType(const string &name, std::shared_ptr<const TupleDictionary> tupleDict) : PayloadType(name) {
+		clone()->SetTupleDictionary(std::move(tupleDict));
+	}
 	const PayloadFieldType &Field(int field) const { return get()->Field(field); }
 
 	const string &Name() const { return get()->Name(); }
@@ -1,11 +1,75 @@
 
 #include "perfstatcounter.h"
+#include <algorithm>
 #include "estl/shared_mutex.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace reindexer {
 
+LatencyHistogram::LatencyHistogram() : max_(0) {
+	for (auto &b : buckets_) b.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucket(uint64_t us) {
+	if (us < uint64_t(kSubBuckets)) return int(us);
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanReverse64(&idx, us);
+	int exp = int(idx);
+#else
+	int exp = 63 - __builtin_clzll(us);
+#endif
+	if (exp >= kMaxExponent) return kBuckets - 1;
+	// Top kSubBucketBits bits after the highest one select linear bucket inside of [2^exp, 2^(exp+1))
+	int sub = int(us >> (exp - kSubBucketBits)) - kSubBuckets;
+	return (exp - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpper(int bucket) {
+	if (bucket < kSubBuckets) return uint64_t(bucket);
+	int exp = bucket / kSubBuckets + kSubBucketBits - 1, sub = bucket % kSubBuckets;
+	return (uint64_t(kSubBuckets + sub + 1) << (exp - kSubBucketBits)) - 1;
+}
+
+void LatencyHistogram::Add(std::chrono::microseconds time) {
+	uint64_t us = time.count() > 0 ? uint64_t(time.count()) : 0;
+	buckets_[bucket(us)].fetch_add(1, std::memory_order_relaxed);
+	uint64_t max = max_.load(std::memory_order_relaxed);
+	while (us > max && !max_.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+	}
+}
+
+LatencyStat LatencyHistogram::Get() const {
+	uint64_t counts[kBuckets], total = 0;
+	for (int i = 0; i < kBuckets; i++) {
+		counts[i] = buckets_[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+
+	LatencyStat ret;
+	ret.maxUs = size_t(max_.load(std::memory_order_relaxed));
+	if (!total) return ret;
+
+	const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+	size_t *results[] = {&ret.p50Us, &ret.p90Us, &ret.p99Us, &ret.p999Us};
+	uint64_t cumulative = 0;
+	int q = 0;
+	for (int i = 0; i < kBuckets && q < 4; i++) {
+		cumulative += counts[i];
+		// Percentile is the upper bound of bucket, which contains item with rank ceil(quantile * total)
+		while (q < 4 && double(cumulative) >= quantiles[q] * double(total)) {
+			*results[q++] = size_t(std::min(bucketUpper(i), uint64_t(ret.maxUs)));
+		}
+	}
+	return ret;
+}
+
 template <typename Mutex>
 void PerfStatCounter<Mutex>::Hit(std::chrono::microseconds time) {
+	latency_.Add(time);
 	std::unique_lock<Mutex> lck(mtx_);
 	totalTime += time;
 	calcTime += time;
@@ -16,6 +80,7 @@ void PerfStatCounter<Mutex>::Hit(std::chrono::microseconds time) {
 
 template <typename Mutex>
 void PerfStatCounter<Mutex>::LockHit(std::chrono::microseconds time) {
+	lockLatency_.Add(time);
 	std::unique_lock<Mutex> lck(mtx_);
 	calcLockTime += time;
 	totalLockTime += time;
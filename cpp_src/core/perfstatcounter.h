@@ -1,12 +1,41 @@
 #pragma once
 
 #include <stdlib.h>
+#include <atomic>
 #include <chrono>
 #include <mutex>
+#include "core/namespacestat.h"
 #include "estl/shared_mutex.h"
 
 namespace reindexer {
 
+// Lock-free histogram of latencies with logarithmic buckets (like HdrHistogram). Latencies below kSubBuckets us are counted exactly,
+// and each next range [2^n, 2^(n+1)) is split to kSubBuckets linear buckets, so percentiles are reported with error below 1/kSubBuckets.
+// Concurrent writers only increment counters of buckets, and readers merge buckets to percentiles
+class LatencyHistogram {
+public:
+	LatencyHistogram();
+	LatencyHistogram(const LatencyHistogram &) = delete;
+	LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+	void Add(std::chrono::microseconds time);
+	LatencyStat Get() const;
+
+	static const int kSubBucketBits = 3;
+	static const int kSubBuckets = 1 << kSubBucketBits;
+	// Latencies above 2^kMaxExponent us (about 25 days) are counted in the last bucket
+	static const int kMaxExponent = 41;
+	static const int kBuckets = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+protected:
+	static int bucket(uint64_t us);
+	// Max latency of bucket
+	static uint64_t bucketUpper(int bucket);
+
+	std::atomic<uint64_t> buckets_[kBuckets];
+	std::atomic<uint64_t> max_;
+};
+
 template <typename Mutex>
 class PerfStatCounter {
 public:
@@ -16,17 +45,23 @@ public:
 	void lap();
 	template <class T>
 	T Get() {
+		T ret;
+		ret.latency = latency_.Get();
+		ret.lockTime = lockLatency_.Get();
 		std::unique_lock<Mutex> lck(mtx_);
 		lap();
-		return T{totalHitCount,
-				 size_t(totalTime.count() / (totalHitCount ? totalHitCount : 1)),
-				 size_t(totalLockTime.count() / (totalHitCount ? totalHitCount : 1)),
-				 avgHitCount,
-				 size_t(avgTime.count() / (avgHitCount ? avgHitCount : 1)),
-				 size_t(avgLockTime.count() / (avgHitCount ? avgHitCount : 1))};
+		ret.totalHitCount = totalHitCount;
+		ret.totalTimeUs = size_t(totalTime.count() / (totalHitCount ? totalHitCount : 1));
+		ret.totalLockTimeUs = size_t(totalLockTime.count() / (totalHitCount ? totalHitCount : 1));
+		ret.avgHitCount = avgHitCount;
+		ret.avgTimeUs = size_t(avgTime.count() / (avgHitCount ? avgHitCount : 1));
+		ret.avgLockTimeUs = size_t(avgLockTime.count() / (avgHitCount ? avgHitCount : 1));
+		return ret;
 	}
 
 protected:
+	// Histograms are updated without lock of counter
+	LatencyHistogram latency_, lockLatency_;
 	size_t totalHitCount = 0;
 	std::chrono::microseconds totalTime = std::chrono::microseconds(0);
 	std::chrono::microseconds totalLockTime = std::chrono::microseconds(0);
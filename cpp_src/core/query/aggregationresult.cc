@@ -0,0 +1,44 @@
+#include "core/query/aggregationresult.h"
+#include "tools/serializer.h"
+
+namespace reindexer {
+
+const char *AggregationResult::TypeName(AggType type) {
+	switch (type) {
+		case AggSum:
+			return "sum";
+		case AggAvg:
+			return "avg";
+		case AggFacet:
+			return "facet";
+		case AggMin:
+			return "min";
+		case AggMax:
+			return "max";
+		case AggCountDistinct:
+			return "count_distinct";
+		default:
+			return "?";
+	}
+}
+
+void AggregationResult::GetJSON(WrSerializer &ser) const {
+	ser.PutChars("{\"field\":");
+	ser.PrintJsonString(field);
+	ser.Printf(",\"type\":\"%s\",", TypeName(type));
+	if (type == AggFacet) {
+		ser.PutChars("\"facets\":[");
+		for (size_t i = 0; i < facets.size(); i++) {
+			if (i) ser.PutChar(',');
+			ser.PutChars("{\"value\":");
+			ser.PrintJsonString(facets[i].value);
+			ser.Printf(",\"count\":%d}", facets[i].count);
+		}
+		ser.PutChar(']');
+	} else {
+		ser.Printf("\"value\":%.20g", value);
+	}
+	ser.PutChar('}');
+}
+
+}  // namespace reindexer
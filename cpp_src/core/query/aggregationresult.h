@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include "core/type_consts.h"
+#include "estl/h_vector.h"
+
+namespace reindexer {
+
+class WrSerializer;
+
+struct FacetResult {
+	FacetResult() {}
+	FacetResult(const std::string &v, int c) : value(v), count(c) {}
+	std::string value;
+	int count = 0;
+};
+
+struct AggregationResult {
+	// Put result as json object, like {"field":"year","type":"max","value":2018} or
+	// {"field":"genre","type":"facet","facets":[{"value":"action","count":10}]}
+	void GetJSON(WrSerializer &ser) const;
+	static const char *TypeName(AggType type);
+
+	std::string field;
+	AggType type = AggSum;
+	// Result of sum, avg, min, max and count_distinct aggregations
+	double value = 0;
+	// Result of facet aggregation: values of field with counts of items, sorted by count
+	h_vector<FacetResult, 1> facets;
+};
+
+}  // namespace reindexer
@@ -35,6 +35,7 @@ const unordered_map<Root, string, EnumClassHash> root_map = {{Root::Namespace, "
 															 {Root::SelectFunctions, "select_functions"},
 															 {Root::ReqTotal, "req_total"},
 															 {Root::Aggregations, "aggregations"},
+															 {Root::Explain, "explain"},
 															 {Root::NextOp, "next_op"}};
 
 const unordered_map<Sort, string, EnumClassHash> sort_map = {{Sort::Desc, "desc"}, {Sort::Field, "field"}, {Sort::Values, "values"}};
@@ -61,8 +62,10 @@ const unordered_map<OpType, string, EnumClassHash> op_map = {{OpOr, "or"}, {OpAn
 const unordered_map<CalcTotalMode, string, EnumClassHash> reqtotal_values = {
 	{ModeNoTotal, "disabled"}, {ModeAccurateTotal, "enabled"}, {ModeCachedTotal, "cached"}};
 
-const unordered_map<Aggregation, string, EnumClassHash> aggregation_map = {{Aggregation::Field, "field"}, {Aggregation::Type, "type"}};
-const unordered_map<AggType, string, EnumClassHash> aggregation_types = {{AggSum, "sum"}, {AggAvg, "avg"}};
+const unordered_map<Aggregation, string, EnumClassHash> aggregation_map = {
+	{Aggregation::Field, "field"}, {Aggregation::Type, "type"}, {Aggregation::Limit, "limit"}};
+const unordered_map<AggType, string, EnumClassHash> aggregation_types = {{AggSum, "sum"}, {AggAvg, "avg"}, {AggFacet, "facet"},
+																		 {AggMin, "min"}, {AggMax, "max"}, {AggCountDistinct, "count_distinct"}};
 
 template <typename T>
 string get(unordered_map<T, string, EnumClassHash> const& m, const T& key) {
@@ -265,6 +268,10 @@ void encodeAggregationFunctions(const Query& query, string& dsl) {
 		encodeStringField(get(aggregation_map, Aggregation::Field), entry.index_, dsl);
 		addComa(dsl);
 		encodeStringField(get(aggregation_map, Aggregation::Type), get(aggregation_types, entry.type_), dsl);
+		if (entry.limit_ != UINT_MAX) {
+			addComa(dsl);
+			encodeNumericField(get(aggregation_map, Aggregation::Limit), entry.limit_, dsl);
+		}
 		dsl += rightBracket;
 		if (i != query.aggregations_.size() - 1) addComa(dsl);
 	}
@@ -335,6 +342,8 @@ std::string toDsl(const Query& query) {
 	encodeStringField(get(root_map, Root::ReqTotal), get(reqtotal_values, query.calcTotal), dsl);
 	addComa(dsl);
 	encodeStringField(get(root_map, Root::NextOp), get(op_map, query.nextOp_), dsl);
+	addComa(dsl);
+	encodeBooleanField(get(root_map, Root::Explain), query.explain_, dsl);
 
 	if (!query.selectFilter_.empty()) addComa(dsl);
 	encodeSelectFilter(query, dsl);
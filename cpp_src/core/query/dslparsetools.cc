@@ -24,6 +24,7 @@ static const fast_hash_map<string, Root> root_map = {{"namespace", Root::Namespa
 													 {"select_functions", Root::SelectFunctions},
 													 {"req_total", Root::ReqTotal},
 													 {"aggregations", Root::Aggregations},
+													 {"explain", Root::Explain},
 													 {"next_op", Root::NextOp}};
 
 // additional for parse field 'sort'
@@ -62,8 +63,10 @@ static const fast_hash_map<string, CalcTotalMode> reqtotal_values = {
 
 // additional for 'Root::Aggregations' field
 
-static const fast_hash_map<string, Aggregation> aggregation_map = {{"field", Aggregation::Field}, {"type", Aggregation::Type}};
-static const fast_hash_map<string, AggType> aggregation_types = {{"sum", AggSum}, {"avg", AggAvg}};
+static const fast_hash_map<string, Aggregation> aggregation_map = {
+	{"field", Aggregation::Field}, {"type", Aggregation::Type}, {"limit", Aggregation::Limit}};
+static const fast_hash_map<string, AggType> aggregation_types = {{"sum", AggSum}, {"avg", AggAvg}, {"facet", AggFacet},
+																 {"min", AggMin}, {"max", AggMax}, {"count_distinct", AggCountDistinct}};
 
 void checkJsonValueType(JsonValue& val, const string& name, JsonTag expectedType) {
 	if (val.getTag() != expectedType) throw Error(errParseJson, "Wrong type of field '%s'", name.c_str());
@@ -290,6 +293,10 @@ void parseAggregation(JsonValue& aggregation, Query& query) {
 				checkJsonValueType(value, name, JSON_STRING);
 				aggEntry.type_ = get(aggregation_types, lower(value.toString()));
 				break;
+			case Aggregation::Limit:
+				checkJsonValueType(value, name, JSON_NUMBER);
+				aggEntry.limit_ = static_cast<unsigned>(value.toNumber());
+				break;
 		}
 	}
 	query.aggregations_.push_back(aggEntry);
@@ -361,6 +368,12 @@ void parse(JsonValue& root, Query& q) {
 			case Root::Aggregations:
 				checkJsonValueType(v, name, JSON_ARRAY);
 				for (auto aggregation : v) parseAggregation(aggregation->value, q);
+				break;
+			case Root::Explain:
+				if ((v.getTag() != JSON_TRUE) && (v.getTag() != JSON_FALSE))
+					throw Error(errParseJson, "Wrong type of field '%s'", name.c_str());
+				q.explain_ = (v.getTag() == JSON_TRUE);
+				break;
 		}
 	}
 }
@@ -21,14 +21,15 @@ enum class Root {
 	SelectFunctions,
 	ReqTotal,
 	NextOp,
-	Aggregations
+	Aggregations,
+	Explain
 };
 
 enum class Sort { Desc, Field, Values };
 enum class JoinRoot { Type, On, Op, Namespace, Filters, Sort, Limit, Offset };
 enum class JoinEntry { LetfField, RightField, Cond, Op };
 enum class Filter { Cond, Op, Field, Value };
-enum class Aggregation { Field, Type };
+enum class Aggregation { Field, Type, Limit };
 
 void parse(JsonValue& value, Query& q);
 }  // namespace dsl
@@ -24,11 +24,14 @@ bool Query::operator==(const Query &obj) const {
 	if (start != obj.start) return false;
 	if (count != obj.count) return false;
 	if (debugLevel != obj.debugLevel) return false;
+	if (explain_ != obj.explain_) return false;
 	if (joinType != obj.joinType) return false;
+	if (joinStrategy != obj.joinStrategy) return false;
 	if (forcedSortOrder != obj.forcedSortOrder) return false;
 
 	if (selectFilter_ != obj.selectFilter_) return false;
 	if (selectFunctions_ != obj.selectFunctions_) return false;
+	if (updateFields_ != obj.updateFields_) return false;
 	if (joinQueries_ != obj.joinQueries_) return false;
 	if (mergeQueries_ != obj.mergeQueries_) return false;
 
@@ -82,6 +85,10 @@ void Query::deserialize(Serializer &ser) {
 			case QueryAggregation:
 				aggregations_.push_back({ser.GetVString().ToString(), AggType(ser.GetVarUint())});
 				break;
+			case QueryAggregationLimit:
+				if (aggregations_.empty()) throw Error(errParams, "Aggregation limit without aggregation");
+				aggregations_.back().limit_ = ser.GetVarUint();
+				break;
 			case QueryDistinct:
 				qe.index = ser.GetVString().ToString();
 				qe.distinct = true;
@@ -121,6 +128,24 @@ void Query::deserialize(Serializer &ser) {
 			case QuerySelectFunction:
 				selectFunctions_.push_back(ser.GetVString().ToString());
 				break;
+			case QueryJoinStrategy:
+				joinStrategy = JoinStrategy(ser.GetVarUint());
+				break;
+			case QueryParallelism:
+				parallelism = ser.GetVarUint();
+				break;
+			case QueryExplain:
+				explain_ = true;
+				break;
+			case QueryUpdateField: {
+				UpdateEntry ue;
+				ue.column_ = ser.GetVString().ToString();
+				int count = ser.GetVarUint();
+				ue.values_.reserve(count);
+				while (count--) ue.values_.push_back(ser.GetValue());
+				updateFields_.push_back(std::move(ue));
+				break;
+			}
 			case QueryEnd:
 				return;
 		}
@@ -130,8 +155,15 @@ void Query::deserialize(Serializer &ser) {
 int Query::Parse(tokenizer &parser) {
 	token tok = parser.next_token();
 
+	if (tok.text() == "explain"_sv) {
+		explain_ = true;
+		tok = parser.next_token();
+	}
+
 	if (tok.text() == "select"_sv) {
 		selectParse(parser);
+	} else if (tok.text() == "update"_sv && !explain_) {
+		updateParse(parser);
 	} else {
 		throw Error(errParams, "Syntax error at or near '%s', %s", tok.text().data(), parser.where().c_str());
 	}
@@ -160,9 +192,27 @@ int Query::selectParse(tokenizer &parser) {
 				aggregations_.push_back({tok.text().ToString(), AggAvg});
 			} else if (name.text() == "sum"_sv) {
 				aggregations_.push_back({tok.text().ToString(), AggSum});
+			} else if (name.text() == "min"_sv) {
+				aggregations_.push_back({tok.text().ToString(), AggMin});
+			} else if (name.text() == "max"_sv) {
+				aggregations_.push_back({tok.text().ToString(), AggMax});
+			} else if (name.text() == "facet"_sv) {
+				aggregations_.push_back({tok.text().ToString(), AggFacet});
+				if (parser.peek_token().text() == "limit"_sv) {
+					parser.next_token();
+					tok = parser.next_token();
+					if (tok.type != TokenNumber)
+						throw Error(errParseSQL, "Expected number, but found '%s' in query, %s", tok.text().data(), parser.where().c_str());
+					aggregations_.back().limit_ = atoi(tok.text().data());
+				}
 			} else if (name.text() == "count"_sv) {
-				calcTotal = ModeAccurateTotal;
-				count = 0;
+				if (tok.text() == "distinct"_sv) {
+					tok = parser.next_token();
+					aggregations_.push_back({tok.text().ToString(), AggCountDistinct});
+				} else {
+					calcTotal = ModeAccurateTotal;
+					count = 0;
+				}
 			} else {
 				throw Error(errParams, "Unknown function name SQL - %s, %s", name.text().data(), parser.where().c_str());
 			}
@@ -270,6 +320,43 @@ int Query::selectParse(tokenizer &parser) {
 	return 0;
 }
 
+int Query::updateParse(tokenizer &parser) {
+	token tok = parser.next_token();
+	if (tok.type != TokenName && tok.type != TokenString)
+		throw Error(errParseSQL, "Expected namespace name, but found '%s' in query, %s", tok.text().data(), parser.where().c_str());
+	_namespace = tok.text().ToString();
+
+	tok = parser.next_token();
+	if (tok.text() != "set"_sv) throw Error(errParseSQL, "Expected 'SET', but found '%s' in query, %s", tok.text().data(), parser.where().c_str());
+
+	for (;;) {
+		UpdateEntry entry;
+		tok = parser.next_token();
+		if (tok.type != TokenName && tok.type != TokenString)
+			throw Error(errParseSQL, "Expected field name, but found '%s' in query, %s", tok.text().data(), parser.where().c_str());
+		entry.column_ = tok.text().ToString();
+
+		tok = parser.next_token();
+		if (tok.text() != "="_sv) throw Error(errParseSQL, "Expected '=', but found '%s' in query, %s", tok.text().data(), parser.where().c_str());
+
+		tok = parser.next_token();
+		if (tok.type != TokenNumber && tok.type != TokenString)
+			throw Error(errParseSQL, "Expected parameter, but found '%s' in query, %s", tok.text().data(), parser.where().c_str());
+		entry.values_.push_back(token2kv(tok));
+		updateFields_.push_back(std::move(entry));
+
+		if (parser.peek_token().text() != ","_sv) break;
+		parser.next_token();
+	}
+
+	parser.skip_space();
+	if (parser.peek_token().text() == "where"_sv) {
+		parser.next_token();
+		ParseWhere(parser);
+	}
+	return 0;
+}
+
 void Query::parseJoin(JoinType type, tokenizer &parser) {
 	Query jquery;
 	auto tok = parser.next_token();
@@ -402,6 +489,10 @@ void Query::Serialize(WrSerializer &ser, uint8_t mode) const {
 		ser.PutVarUint(QueryAggregation);
 		ser.PutVString(agg.index_);
 		ser.PutVarUint(agg.type_);
+		if (agg.limit_ != UINT_MAX) {
+			ser.PutVarUint(QueryAggregationLimit);
+			ser.PutVarUint(agg.limit_);
+		}
 	}
 
 	if (!sortBy.empty()) {
@@ -445,6 +536,25 @@ void Query::Serialize(WrSerializer &ser, uint8_t mode) const {
 		ser.PutVString(sf);
 	}
 
+	if (joinStrategy != JoinStrategyAuto) {
+		ser.PutVarUint(QueryJoinStrategy);
+		ser.PutVarUint(joinStrategy);
+	}
+
+	if (parallelism) {
+		ser.PutVarUint(QueryParallelism);
+		ser.PutVarUint(parallelism);
+	}
+
+	if (explain_) ser.PutVarUint(QueryExplain);
+
+	for (auto &ue : updateFields_) {
+		ser.PutVarUint(QueryUpdateField);
+		ser.PutVString(ue.column_);
+		ser.PutVarUint(ue.values_.size());
+		for (auto &kv : ue.values_) ser.PutValue(kv);
+	}
+
 	ser.PutVarUint(QueryEnd);  // finita la commedia... of root query
 
 	if (!(mode & SkipJoinQueries)) {
@@ -568,11 +678,25 @@ string Query::Dump(bool stripArgs) const {
 				case AggSum:
 					filt += "SUM(";
 					break;
+				case AggMin:
+					filt += "MIN(";
+					break;
+				case AggMax:
+					filt += "MAX(";
+					break;
+				case AggFacet:
+					filt += "FACET(";
+					break;
+				case AggCountDistinct:
+					filt += "COUNT(DISTINCT ";
+					break;
 				default:
 					filt += "<?> (";
 					break;
 			}
-			filt += a.index_ + ")";
+			filt += a.index_;
+			if (a.limit_ != UINT_MAX) filt += " LIMIT " + std::to_string(a.limit_);
+			filt += ")";
 		}
 	} else if (selectFilter_.size()) {
 		for (auto &f : selectFilter_) {
@@ -583,7 +707,21 @@ string Query::Dump(bool stripArgs) const {
 		filt = "*";
 	if (calcTotal) filt += ", COUNT(*)";
 
-	string buf = "SELECT " + filt + " FROM " + _namespace + QueryWhere::toString(stripArgs) + dumpJoined(stripArgs) +
+	if (updateFields_.size()) {
+		string set;
+		for (auto &ue : updateFields_) {
+			if (&ue != &*updateFields_.begin()) set += ",";
+			set += " " + ue.column_ + " = ";
+			if (stripArgs) {
+				set += '?';
+			} else {
+				for (auto &v : ue.values_) set += "'" + v.As<string>() + "'";
+			}
+		}
+		return "UPDATE " + _namespace + " SET" + set + QueryWhere::toString(stripArgs);
+	}
+
+	string buf = string(explain_ ? "EXPLAIN " : "") + "SELECT " + filt + " FROM " + _namespace + QueryWhere::toString(stripArgs) + dumpJoined(stripArgs) +
 				 dumpMerged(stripArgs) + dumpOrderBy(stripArgs) + lim;
 	return buf;
 }
@@ -31,7 +31,7 @@ public:
 	/// Allows to compare 2 Query objects.
 	bool operator==(const Query &) const;
 
-	/// Parses pure sql select query and initializes Query object data members as a result.
+	/// Parses pure sql select or update query and initializes Query object data members as a result.
 	/// @param q - sql query.
 	/// @return always returns 0.
 	int Parse(const string &q);
@@ -199,6 +199,15 @@ public:
 		return innerJoinQr;
 	}
 
+	/// Forces algorithm, which will be used to join this query with main query.
+	/// By default algorithm is choosen by estimated amount of rows in both namespaces.
+	/// @param strategy - join strategy (Auto, NestedLoop or Hash).
+	/// @return Query object.
+	Query &ForceJoinStrategy(JoinStrategy strategy) {
+		joinStrategy = strategy;
+		return *this;
+	}
+
 	/// Changes debug level.
 	/// @param level - debug level.
 	/// @return Query object.
@@ -207,6 +216,24 @@ public:
 		return *this;
 	}
 
+	/// Sets max number of threads, which can be used to execute query.
+	/// Query is executed in parallel only if it scans large amount of items.
+	/// @param threads - number of threads. 0 - use default from config, 1 - disable parallel execution.
+	/// @return Query object.
+	Query &Parallel(int threads) {
+		parallelism = threads;
+		return *this;
+	}
+
+	/// Requests plan of query execution: estimated selectivity of conditions, chosen methods of selection and order of joins.
+	/// Plan is returned with results of query in JSON format.
+	/// @param on - explain query or not.
+	/// @return Query object.
+	Query &Explain(bool on = true) {
+		explain_ = on;
+		return *this;
+	}
+
 	/// Performs sorting by certain column. Analog to sql ORDER BY.
 	/// @param sort - sorting column name.
 	/// @param desc - is sorting direction descending or ascending.
@@ -237,10 +264,24 @@ public:
 	/// Adds an aggregate function for certain column.
 	/// Analog to sql aggregate functions (min, max, avg, etc).
 	/// @param idx - name of the field to be aggregated.
-	/// @param type - aggregation function type (Sum, Avg).
+	/// @param type - aggregation function type (Sum, Avg, Facet, Min, Max, CountDistinct).
+	/// @param limit - max number of facets in result of Facet aggregation. Facets with the biggest counts are returned.
 	/// @return Query object ready to be executed.
-	Query &Aggregate(const string &idx, AggType type) {
-		aggregations_.push_back({idx, type});
+	Query &Aggregate(const string &idx, AggType type, unsigned limit = UINT_MAX) {
+		aggregations_.push_back({idx, type, limit});
+		return *this;
+	}
+
+	/// Sets new value of indexed field of items, which match conditions of query. Analog to sql UPDATE ... SET.
+	/// Query with set fields is executed by Reindexer::Update.
+	/// @param field - name of indexed field to be updated.
+	/// @param val - new value of field.
+	/// @return Query object ready to be executed.
+	template <typename Input>
+	Query &Set(const string &field, Input val) {
+		KeyValues values;
+		values.push_back(KeyValue(val));
+		updateFields_.push_back(UpdateEntry(field, values));
 		return *this;
 	}
 
@@ -319,6 +360,11 @@ protected:
 	/// @return always returns zero.
 	int selectParse(tokenizer &tok);
 
+	/// Parses set and filter parts of sql update query.
+	/// @param tok - tokenizer object instance.
+	/// @return always returns zero.
+	int updateParse(tokenizer &tok);
+
 	/// Parses JSON dsl set.
 	/// @param dsl - dsl set.
 	void parseJson(const string &dsl);
@@ -373,9 +419,18 @@ public:
 	/// Debug level.
 	int debugLevel = 0;
 
+	/// Max number of threads to execute query. 0 - use default from config.
+	int parallelism = 0;
+
+	/// Return plan of query execution with results.
+	bool explain_ = false;
+
 	/// Default join type.
 	JoinType joinType = JoinType::LeftJoin;
 
+	/// Algorithm to join this query with main query.
+	JoinStrategy joinStrategy = JoinStrategyAuto;
+
 	/// Keys whiech always go first - before any ordered values.
 	KeyValues forcedSortOrder;
 
@@ -390,6 +445,9 @@ public:
 
 	/// List of sql functions
 	h_vector<string, 1> selectFunctions_;
+
+	/// List of fields with new values, which are set by update query.
+	h_vector<UpdateEntry, 1> updateFields_;
 };
 
 }  // namespace reindexer
@@ -13,11 +13,13 @@ namespace reindexer {
 
 struct QueryCacheVal {
 	QueryCacheVal() = default;
-	QueryCacheVal(const size_t& total) : total_count(total) {}
+	QueryCacheVal(const size_t& total, uint64_t ver = 0) : total_count(total), version(ver) {}
 
 	size_t Size() const { return 0; }
 
 	int total_count = -1;
+	// Version of namespace data, on which total count was calculated
+	uint64_t version = 0;
 };
 
 struct QueryCacheKey {
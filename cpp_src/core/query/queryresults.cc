@@ -29,6 +29,7 @@ QueryResults &QueryResults::operator=(QueryResults &&obj) noexcept {
 		assert(!obj.items_.size());
 		joined_ = std::move(obj.joined_);
 		aggregationResults = std::move(obj.aggregationResults);
+		explainResults = std::move(obj.explainResults);
 		totalCount = std::move(obj.totalCount);
 		haveProcent = std::move(obj.haveProcent);
 		ctxs = std::move(obj.ctxs);
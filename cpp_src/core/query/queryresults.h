@@ -1,7 +1,9 @@
 #pragma once
 
+#include <functional>
 #include <unordered_map>
 #include "core/item.h"
+#include "core/query/aggregationresult.h"
 #include "core/itemimpl.h"
 #include "estl/h_vector.h"
 
@@ -12,6 +14,8 @@ using std::unordered_map;
 using std::unique_ptr;
 
 static const int kDefaultQueryResultsSize = 32;
+// Max number of items in batch of streamed query results
+static const int kStreamResultsBatchSize = 1024;
 struct ItemRef {
 	ItemRef(IdType iid = 0, int iversion = 0) : id(iid), version(iversion) {}
 	ItemRef(IdType iid, int iversion, const PayloadValue &ivalue, uint8_t iproc = 0, uint8_t insid = 0)
@@ -78,7 +82,9 @@ public:
 
 	// joinded fields 0 - 1st joined ns, 1 - second joined
 	unique_ptr<unordered_map<IdType, QRVector>> joined_;  // joinded items
-	h_vector<double> aggregationResults;
+	h_vector<AggregationResult, 1> aggregationResults;
+	// Plan of query execution in JSON format, if query was explained
+	string explainResults;
 	int totalCount = 0;
 	bool haveProcent = false;
 	bool nonCacheableData = false;
@@ -114,4 +120,9 @@ public:
 	using h_vector<QueryResults, 2>::h_vector;
 };
 
+/// Consumer of streamed query results. It is called with consecutive batches of results, items of batch are released after return.
+/// Last call is made with isLast == true, and it's batch holds totalCount and aggregation results of query.
+/// Returned error stops the stream
+typedef std::function<Error(QueryResults &batch, bool isLast)> QueryResultsConsumer;
+
 }  // namespace reindexer
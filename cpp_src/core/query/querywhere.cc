@@ -29,11 +29,20 @@ bool QueryJoinEntry::operator==(const QueryJoinEntry &obj) const {
 bool AggregateEntry::operator==(const AggregateEntry &obj) const {
 	if (index_ != obj.index_) return false;
 	if (type_ != obj.type_) return false;
+	if (limit_ != obj.limit_) return false;
 	return true;
 }
 
 bool AggregateEntry::operator!=(const AggregateEntry &obj) const { return !operator==(obj); }
 
+bool UpdateEntry::operator==(const UpdateEntry &obj) const {
+	if (column_ != obj.column_) return false;
+	if (values_ != obj.values_) return false;
+	return true;
+}
+
+bool UpdateEntry::operator!=(const UpdateEntry &obj) const { return !operator==(obj); }
+
 bool QueryWhere::operator==(const QueryWhere &obj) const {
 	if (entries != obj.entries) return false;
 	if (aggregations_ != obj.aggregations_) return false;
@@ -60,7 +69,7 @@ CondType QueryWhere::getCondType(string_view cond) {
 	throw Error(errParseSQL, "Expected condition operator, but found '%s' in query", cond.data());
 }
 
-static KeyValue token2kv(const token &tok) {
+KeyValue QueryWhere::token2kv(const token &tok) {
 	auto text = tok.text();
 	bool digit = text.length() < 21;
 
@@ -76,6 +85,7 @@ static KeyValue token2kv(const token &tok) {
 		int64_t d = strtoull(text.data(), &p, 10);
 		return KeyValue(d);
 	}
+	if (tok.type == TokenNumber) return KeyValue(strtod(text.data(), nullptr));
 	return KeyValue(make_key_string(text.data(), text.length()));
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,6 +16,7 @@ using std::vector;
 
 class QueryWhere;
 class tokenizer;
+class token;
 
 struct QueryEntry {
 	QueryEntry(OpType o, CondType cond, const string &idx, int idxN, bool dist = false)
@@ -46,10 +48,24 @@ struct QueryJoinEntry {
 struct QueryEntries : public h_vector<QueryEntry, 4> {};
 
 struct AggregateEntry {
+	AggregateEntry() {}
+	AggregateEntry(const string &index, AggType type, unsigned limit = UINT_MAX) : index_(index), type_(type), limit_(limit) {}
 	bool operator==(const AggregateEntry &) const;
 	bool operator!=(const AggregateEntry &) const;
 	string index_;
-	AggType type_;
+	AggType type_ = AggSum;
+	// Max number of facets in result, facets with the biggest counts are returned
+	unsigned limit_ = UINT_MAX;
+};
+
+// Field, which is set by update query, and it's new value
+struct UpdateEntry {
+	UpdateEntry() {}
+	UpdateEntry(const string &column, const KeyValues &values) : column_(column), values_(values) {}
+	bool operator==(const UpdateEntry &) const;
+	bool operator!=(const UpdateEntry &) const;
+	string column_;
+	KeyValues values_;
 };
 
 class QueryWhere {
@@ -62,6 +78,7 @@ protected:
 	int ParseWhere(tokenizer &tok);
 	string toString(bool stripArgs) const;
 	static CondType getCondType(string_view cond);
+	static KeyValue token2kv(const token &tok);
 
 public:
 	QueryEntries entries;
@@ -11,22 +11,24 @@ namespace reindexer {
 
 void QueriesStatTracer::Hit(const Query &q, std::chrono::microseconds time) {
 	auto sqlq = q.Dump(true);
-	std::unique_lock<std::mutex> lck(mtx_);
-	stat_.emplace(sqlq, PerfStatCounterST()).first->second.Hit(time);
+	auto &shard = shards_[std::hash<std::string>()(sqlq) % kShards];
+	std::unique_lock<std::mutex> lck(shard.mtx);
+	shard.stat[sqlq].Hit(time);
 };
 
 void QueriesStatTracer::LockHit(const Query &q, std::chrono::microseconds time) {
 	auto sqlq = q.Dump(true);
-	std::unique_lock<std::mutex> lck(mtx_);
-	stat_.emplace(sqlq, PerfStatCounterST()).first->second.LockHit(time);
+	auto &shard = shards_[std::hash<std::string>()(sqlq) % kShards];
+	std::unique_lock<std::mutex> lck(shard.mtx);
+	shard.stat[sqlq].LockHit(time);
 };
 
 const std::vector<QueryPerfStat> QueriesStatTracer::Data() {
-	std::unique_lock<std::mutex> lck(mtx_);
-
 	std::vector<QueryPerfStat> ret;
-	ret.reserve(stat_.size());
-	for (auto &stat : stat_) ret.push_back({stat.first, stat.second.Get<PerfStat>()});
+	for (auto &shard : shards_) {
+		std::unique_lock<std::mutex> lck(shard.mtx);
+		for (auto &stat : shard.stat) ret.push_back({stat.first, stat.second.Get<PerfStat>()});
+	}
 	return ret;
 }
 
@@ -38,7 +40,11 @@ void QueryPerfStat::GetJSON(WrSerializer &ser) const {
 	ser.Printf("\"total_avg_latency_us\":%" PRI_SIZE_T ",", perf.totalTimeUs);
 	ser.Printf("\"last_sec_qps\":%" PRI_SIZE_T ",", perf.avgHitCount);
 	ser.Printf("\"last_sec_avg_lock_time_us\":%" PRI_SIZE_T ",", perf.avgLockTimeUs);
-	ser.Printf("\"last_sec_avg_latency_us\":%" PRI_SIZE_T "", perf.avgTimeUs);
+	ser.Printf("\"last_sec_avg_latency_us\":%" PRI_SIZE_T ",", perf.avgTimeUs);
+	ser.Printf("\"latency\":");
+	perf.latency.GetJSON(ser);
+	ser.Printf(",\"lock_time\":");
+	perf.lockTime.GetJSON(ser);
 	ser.PutChar('}');
 }
 
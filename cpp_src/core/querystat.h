@@ -27,8 +27,13 @@ public:
 	const std::vector<QueryPerfStat> Data();
 
 protected:
-	std::mutex mtx_;
-	std::unordered_map<std::string, PerfStatCounterST> stat_;
+	// Stats are sharded by hash of normalized query, so concurrent queries rarely wait for the same mutex
+	struct Shard {
+		std::mutex mtx;
+		std::unordered_map<std::string, PerfStatCounterST> stat;
+	};
+	static const size_t kShards = 16;
+	Shard shards_[kShards];
 };
 
 class QueryStatCalculator {
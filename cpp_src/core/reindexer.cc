@@ -19,6 +19,9 @@ Error Reindexer::Insert(const string& _namespace, Item& item) { return impl_->In
 Error Reindexer::Update(const string& _namespace, Item& item) { return impl_->Update(_namespace, item); }
 Error Reindexer::Upsert(const string& _namespace, Item& item) { return impl_->Upsert(_namespace, item); }
 Error Reindexer::Delete(const string& _namespace, Item& item) { return impl_->Delete(_namespace, item); }
+Error Reindexer::ModifyItems(const string& _namespace, vector<Item>& items, int mode) {
+	return impl_->ModifyItems(_namespace, items, mode);
+}
 Item Reindexer::NewItem(const string& _namespace) { return impl_->NewItem(_namespace); }
 Error Reindexer::GetMeta(const string& _namespace, const string& key, string& data) { return impl_->GetMeta(_namespace, key, data); }
 Error Reindexer::PutMeta(const string& _namespace, const string& key, const string_view& data) {
@@ -26,8 +29,10 @@ Error Reindexer::PutMeta(const string& _namespace, const string& key, const stri
 }
 Error Reindexer::EnumMeta(const string& _namespace, vector<string>& keys) { return impl_->EnumMeta(_namespace, keys); }
 Error Reindexer::Delete(const Query& q, QueryResults& result) { return impl_->Delete(q, result); }
+Error Reindexer::Update(const Query& q, QueryResults& result) { return impl_->Update(q, result); }
 Error Reindexer::Select(const string& query, QueryResults& result) { return impl_->Select(query, result); }
 Error Reindexer::Select(const Query& q, QueryResults& result) { return impl_->Select(q, result); }
+Error Reindexer::Select(const Query& q, const QueryResultsConsumer& consumer) { return impl_->Select(q, consumer); }
 Error Reindexer::Commit(const string& _namespace) { return impl_->Commit(_namespace); }
 Error Reindexer::ConfigureIndex(const string& _namespace, const string& index, const string& config) {
 	return impl_->ConfigureIndex(_namespace, index, config);
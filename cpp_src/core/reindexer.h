@@ -87,18 +87,35 @@ public:
 	/// @param nsName - Name of namespace
 	/// @param item - Item, obtained by call to NewItem of the same namespace
 	Error Delete(const string &nsName, Item &item);
+	/// Insert, update, upsert or delete batch of items. Batch is applied to namespace under single lock, so it is much faster,
+	/// than modification of items one by one. On error, items before failed one are already applied
+	/// @param nsName - Name of namespace
+	/// @param items - Items, obtained by call to NewItem of the same namespace. On success item.GetID() will return internal Item ID
+	/// @param mode - One of ModeInsert, ModeUpdate, ModeUpsert or ModeDelete
+	Error ModifyItems(const string &nsName, vector<Item> &items, int mode);
 	/// Delete all items froms namespace, which matches provided Query
 	/// @param query - Query with conditions
 	/// @param result - QueryResults with IDs of deleted items
 	Error Delete(const Query &query, QueryResults &result);
+	/// Set fields of all items from namespace, which matches provided Query, under single lock.
+	/// Only indexes of changed fields are updated. Only scalar, non PK indexed fields with top level json path can be set
+	/// @param query - Query with conditions and set fields
+	/// @param result - QueryResults with updated items
+	Error Update(const Query &query, QueryResults &result);
 	/// Execute SQL Query and return results
-	/// @param query - SQL query. Only "SELECT" semantic is supported
+	/// @param query - SQL query. "SELECT" and "UPDATE" semantic is supported
 	/// @param result - QueryResults with found items
 	Error Select(const string &query, QueryResults &result);
 	/// Execute Query and return results
 	/// @param query - Query object with query attributes
 	/// @param result - QueryResults with found items
 	Error Select(const Query &query, QueryResults &result);
+	/// Execute Query and pass results to consumer by batches, without collecting of all results in memory.
+	/// Namespaces of query are locked for reading until the end of stream, so consumer must not modify them.
+	/// Queries with joins, merges, full text or sort by unordered index are passed to consumer by single batch
+	/// @param query - Query object with query attributes
+	/// @param consumer - Function, which is called with batches of found items
+	Error Select(const Query &query, const QueryResultsConsumer &consumer);
 	/// Flush changes to storage
 	/// @param nsName - Name of namespace
 	Error Commit(const string &nsName);
@@ -1,8 +1,11 @@
 #include "core/reindexerimpl.h"
 #include <stdio.h>
 #include <chrono>
+#include <cmath>
 #include <thread>
 #include "core/cjson/jsondecoder.h"
+#include "core/cjson/jsonprintfilter.h"
+#include "core/index/index.h"
 #include "core/namespacedef.h"
 #include "core/selectfunc/selectfunc.h"
 #include "kx/kxsort.h"
@@ -21,9 +24,15 @@ const char* kNamespacesNamespace = "#namespaces";
 const char* kConfigNamespace = "#config";
 const char* kStoragePlaceholderFilename = ".reindexer.storage";
 
+// Estimated cost of join select for single row of main namespace, in terms of cost of put single row to join hash table
+// If joined namespace has less rows, than estimated amount of probes * kJoinNestedLoopRowCost, then hash join is used
+const int kJoinNestedLoopRowCost = 32;
+
 namespace reindexer {
 
-ReindexerImpl::ReindexerImpl() : profConfig_(std::make_shared<DBProfilingConfig>()) { stopFlusher_ = false; }
+ReindexerImpl::ReindexerImpl() : profConfig_(std::make_shared<DBProfilingConfig>()), selectConfig_(std::make_shared<DBSelectConfig>()) {
+	stopFlusher_ = false;
+}
 
 ReindexerImpl::~ReindexerImpl() {
 	if (storagePath_.length()) {
@@ -246,6 +255,21 @@ Error ReindexerImpl::Upsert(const string& _namespace, Item& item) {
 	return errOK;
 }
 
+Error ReindexerImpl::ModifyItems(const string& _namespace, vector<Item>& items, int mode) {
+	try {
+		auto ns = getNamespace(_namespace);
+		ns->ModifyItems(items, mode);
+		if (mode != ModeDelete) {
+			for (auto& item : items) {
+				if (item.GetID() != -1) updateSystemNamespace(_namespace, item);
+			}
+		}
+	} catch (const Error& err) {
+		return err;
+	}
+	return errOK;
+}
+
 Item ReindexerImpl::NewItem(const string& _namespace) {
 	try {
 		return getNamespace(_namespace)->NewItem();
@@ -299,11 +323,21 @@ Error ReindexerImpl::Delete(const Query& q, QueryResults& result) {
 	}
 	return errOK;
 }
+Error ReindexerImpl::Update(const Query& q, QueryResults& result) {
+	try {
+		auto ns = getNamespace(q._namespace);
+		ns->Update(q, result);
+	} catch (const Error& err) {
+		return err;
+	}
+	return errOK;
+}
 
 Error ReindexerImpl::Select(const string& query, QueryResults& result) {
 	try {
 		Query q;
 		q.Parse(query);
+		if (q.updateFields_.size()) return Update(q, result);
 		return Select(q, result);
 
 	} catch (const Error& err) {
@@ -325,7 +359,14 @@ struct ItemRefLess {
 	}
 };
 
-Error ReindexerImpl::Select(const Query& q, QueryResults& result) {
+Error ReindexerImpl::Select(const Query& q, QueryResults& result) { return select(q, result, nullptr); }
+
+Error ReindexerImpl::Select(const Query& q, const QueryResultsConsumer& consumer) {
+	QueryResults result;
+	return select(q, result, &consumer);
+}
+
+Error ReindexerImpl::select(const Query& q, QueryResults& result, const QueryResultsConsumer* consumer) {
 	NsLocker locks;
 
 	if (!q.joinQueries_.empty() && !q.mergeQueries_.empty()) {
@@ -373,12 +414,18 @@ Error ReindexerImpl::Select(const Query& q, QueryResults& result) {
 			SelectFunctionsHolder func;
 			h_vector<Query, 4> queries;
 			JoinedSelectors joinedSelectors = prepareJoinedSelectors(q, result, locks, queries, func);
-			doSelect(q, result, joinedSelectors, locks, func);
+			doSelect(q, result, joinedSelectors, locks, func, consumer);
+			if (consumer) {
+				func.Process(result);
+				// Namespaces are still locked, so results are not locked
+				return (*consumer)(result, true);
+			}
 			result.lockResults();
 			func.Process(result);
 
 			break;
 		} catch (const Error& err) {
+			// Locks are upgraded only before selection of items, so retry will not pass items to consumer twice
 			if (err.code() == errWasRelock) {
 				result = QueryResults();
 				logPrintf(LogInfo, "Was lock upgrade in multi namespaces_ query. Retrying");
@@ -411,6 +458,7 @@ JoinedSelectors ReindexerImpl::prepareJoinedSelectors(const Query& q, QueryResul
 
 		JoinCacheRes joinRes;
 		joinRes.key.SetData(0, jq);
+		joinRes.version = jns->getCacheVersion(jq);
 		jns->GetFromJoinCache(joinRes);
 		Query* pjItemQ = nullptr;
 		if (jjq.entries.size() && !joinRes.haveData) {
@@ -445,6 +493,32 @@ JoinedSelectors ReindexerImpl::prepareJoinedSelectors(const Query& q, QueryResul
 		queries.push_back(std::move(jItemQ));
 		pjItemQ = &queries.back();
 
+		JoinHashTable::Ptr hashTable = prepareJoinHashTable(q, jq, ns, jns, preResult, locks);
+		if (hashTable) {
+			auto hashJoinedSelector = [&result, &jq, jns, hashTable, pos, pjItemQ](IdType id, ConstPayload payload, bool match) {
+				h_vector<KeyValues, 2> keys;
+				keys.resize(jq.joinEntries_.size());
+				int cnt = 0;
+				for (auto& je : jq.joinEntries_) payload.Get(je.idxNo, keys[cnt++]);
+
+				JoinHashTable::Rows rows;
+				bool found = hashTable->Probe(keys, rows, match ? jq.count : 0);
+				if (match && rows.size()) {
+					QueryResults joinItemR;
+					joinItemR.addNSContext(jns->payloadType_, jns->tagsMatcher_, JsonPrintFilter(jns->tagsMatcher_, pjItemQ->selectFilter_));
+					for (int row : rows) joinItemR.Add(hashTable->Row(row));
+
+					auto& jres = result.joined_->emplace(id, QRVector()).first->second;
+					if (pos >= jres.size()) jres.resize(pos + 1);
+					jres[pos] = std::move(joinItemR);
+				}
+				return found;
+			};
+			// Probe of hash table takes constant time
+			joinedSelectors.push_back({jq.joinType, jq.count == 0, hashJoinedSelector, 0, 0, jns->name_, 1});
+			continue;
+		}
+
 		auto joinedSelector = [&result, &jq, jns, preResult, pos, pjItemQ, &locks, &func, ns](JoinCacheRes& joinRes, IdType id,
 																							  ConstPayload payload, bool match) {
 			QueryResults joinItemR;
@@ -463,6 +537,7 @@ JoinedSelectors ReindexerImpl::prepareJoinedSelectors(const Query& q, QueryResul
 			bool matchedAtLeastOnce = false;
 			JoinCacheRes joinResLong;
 			joinResLong.key.SetData(jq, *pjItemQ);
+			joinResLong.version = jns->getCacheVersion(jq) + jns->getCacheVersion(*pjItemQ);
 			jns->GetFromJoinCache(joinResLong);
 
 			jns->GetIndsideFromJoinCache(joinRes);
@@ -505,24 +580,88 @@ JoinedSelectors ReindexerImpl::prepareJoinedSelectors(const Query& q, QueryResul
 		};
 		auto cache_func_selector = std::bind(joinedSelector, std::move(joinRes), _1, _2, _3);
 
-		joinedSelectors.push_back({jq.joinType, jq.count == 0, cache_func_selector, 0, 0, jns->name_});
+		// Nested loop join selects joined namespace for each item, and search of joined rows takes logarithmic time
+		double cost = kJoinNestedLoopRowCost + std::log2(1 + estimateJoinedRows(jns, preResult));
+		joinedSelectors.push_back({jq.joinType, jq.count == 0, cache_func_selector, 0, 0, jns->name_, cost});
 	}
 	return joinedSelectors;
 }
 
+int ReindexerImpl::estimateJoinedRows(const Namespace::Ptr& jns, const SelectCtx::PreResult::Ptr& preResult) {
+	int joinedRows = jns->items_.size() - jns->free_.size();
+	if (preResult && preResult->mode == SelectCtx::PreResult::ModeIdSet) {
+		joinedRows = preResult->ids.size();
+	} else if (preResult && preResult->mode == SelectCtx::PreResult::ModeIterators) {
+		for (auto& it : preResult->iterators) {
+			if (it.comparators_.empty() && it.op != OpNot) joinedRows = std::min(joinedRows, it.GetMaxIterations());
+		}
+	}
+	return joinedRows;
+}
+
+JoinHashTable::Ptr ReindexerImpl::prepareJoinHashTable(const Query& q, const Query& jq, Namespace::Ptr ns, Namespace::Ptr jns,
+														SelectCtx::PreResult::Ptr preResult, NsLocker& locks) {
+	if (jq.joinStrategy == JoinStrategyNestedLoop || jq.joinEntries_.empty()) return nullptr;
+
+	// Hash join can't keep sort order of joined items, and is applicable only for equality conditions
+	if (!jq.sortBy.empty()) return nullptr;
+	JoinHashTable::KeyFields fields;
+	for (auto& je : jq.joinEntries_) {
+		if (je.op_ != OpAnd || (je.condition_ != CondEq && je.condition_ != CondSet)) return nullptr;
+		int jidx = jns->getIndexByName(je.joinIndex_);
+		if (je.idxNo < 0 || je.idxNo >= ns->payloadType_->NumFields() || jidx >= jns->payloadType_->NumFields()) return nullptr;
+		auto& jindex = jns->indexes_[jidx];
+		if (isFullText(jindex->Type()) || jindex->Opts().GetCollateMode() != CollateNone) return nullptr;
+		fields.push_back(JoinHashTable::KeyField{jidx, jindex->KeyType()});
+	}
+	for (auto& qe : jq.entries) {
+		int idx;
+		if (jns->getIndexByName(qe.index, idx) && isFullText(jns->indexes_[idx]->Type())) return nullptr;
+	}
+
+	// Estimate amount of rows in joined namespace, which will be put to hash table
+	int joinedRows = estimateJoinedRows(jns, preResult);
+	// Estimate amount of rows in main namespace, which will be probed. Left join is called only for rows in result
+	int64_t probes = ns->items_.size() - ns->free_.size();
+	if (jq.joinType == JoinType::LeftJoin) probes = std::min(probes, int64_t(q.start) + q.count);
+
+	if (jq.joinStrategy == JoinStrategyAuto && int64_t(joinedRows) >= probes * kJoinNestedLoopRowCost) return nullptr;
+
+	Query buildQ(jq._namespace);
+	QueryResults jr;
+	SelectCtx ctx(buildQ, &locks);
+	if (!jq.entries.empty()) ctx.preResult = preResult;
+	jns->Select(jr, ctx);
+
+	auto hashTable = std::make_shared<JoinHashTable>(jns->payloadType_, fields);
+	hashTable->Build(std::move(jr.Items()));
+	if (jq.debugLevel >= LogInfo) {
+		logPrintf(LogInfo, "Built join hash table on '%s' with %d rows (expected %d rows, %d probes)", jq._namespace.c_str(),
+				  int(hashTable->Size()), joinedRows, int(probes));
+	}
+	return hashTable;
+}
+
 void ReindexerImpl::doSelect(const Query& q, QueryResults& result, JoinedSelectors& joinedSelectors, NsLocker& locks,
-							 SelectFunctionsHolder& func) {
+							 SelectFunctionsHolder& func, const QueryResultsConsumer* consumer) {
 	auto ns = locks.Get(q._namespace);
 	if (!ns) {
 		throw Error(errParams, "Namespace '%s' is not exists", q._namespace.c_str());
 	}
+	mtx_.lock_shared();
+	auto selectCfg = selectConfig_;
+	mtx_.unlock_shared();
+
 	SelectCtx ctx(q, &locks);
 
 	{
+		ctx.parallelism = selectCfg->parallelism;
+		ctx.parallelScanThreshold = selectCfg->parallelScanThreshold;
 		ctx.functions = &func;
 		ctx.joinedSelectors = &joinedSelectors;
 		ctx.nsid = 0;
 		ctx.isForceAll = !q.mergeQueries_.empty() || !q.forcedSortOrder.empty();
+		ctx.streamConsumer = consumer;
 		ns->Select(result, ctx);
 	}
 
@@ -534,6 +673,8 @@ void ReindexerImpl::doSelect(const Query& q, QueryResults& result, JoinedSelecto
 			SelectCtx ctx(mq, &locks);
 			ctx.nsid = ++counter;
 			ctx.isForceAll = true;
+			ctx.parallelism = selectCfg->parallelism;
+			ctx.parallelScanThreshold = selectCfg->parallelScanThreshold;
 			ctx.functions = &func;
 
 			mns->Select(result, ctx);
@@ -742,11 +883,23 @@ std::vector<string> defDBConfig = {
 			"memstats":true
 		}
 	})json",
+	R"json({
+		"type":"select",
+		"select":{
+			"parallelism":1,
+			"parallel_scan_threshold":100000
+		}
+	})json",
 	R"json({
 		"type":"log_queries", 
 		"log_queries":[
 			{"namespace":"*","log_level":"none"}
 	]})json",
+	R"json({
+		"type":"namespaces",
+		"namespaces":[
+			{"namespace":"*","compress_tuples":false}
+	]})json",
 };
 
 Error ReindexerImpl::InitSystemNamespaces() {
@@ -859,6 +1012,13 @@ void ReindexerImpl::updateSystemNamespace(const string& nsName, Item& item) {
 					ns->EnablePerfCounters(cfg->perfStats);
 				}
 
+			} else if (!strcmp(elem->key, "select")) {
+				auto cfg = std::make_shared<DBSelectConfig>();
+				auto err = cfg->FromJSON(elem->value);
+				if (!err.ok()) throw err;
+				mtx_.lock();
+				selectConfig_ = cfg;
+				mtx_.unlock();
 			} else if (!strcmp(elem->key, "log_queries")) {
 				DBLoggingConfig cfg;
 				auto err = cfg.FromJSON(elem->value);
@@ -876,6 +1036,23 @@ void ReindexerImpl::updateSystemNamespace(const string& nsName, Item& item) {
 					}
 					ns->SetQueriesLogLevel(logLevel);
 				}
+			} else if (!strcmp(elem->key, "namespaces")) {
+				DBNamespacesConfig cfg;
+				auto err = cfg.FromJSON(elem->value);
+				if (!err.ok()) throw err;
+				bool defCompress = false;
+				if (cfg.compressTuples.find("*") != cfg.compressTuples.end()) {
+					defCompress = cfg.compressTuples.find("*")->second;
+				}
+
+				auto nsarray = getNamespaces();
+				for (auto& ns : nsarray) {
+					bool compress = defCompress;
+					if (cfg.compressTuples.find(ns->GetName()) != cfg.compressTuples.end()) {
+						compress = cfg.compressTuples.find(ns->GetName())->second;
+					}
+					ns->EnableTuplesCompression(compress);
+				}
 			}
 		}
 	};
@@ -6,6 +6,7 @@
 #include <string>
 #include <thread>
 #include "core/namespace.h"
+#include "core/nsselecter/joinhashtable.h"
 #include "core/nsselecter/nsselecter.h"
 #include "dbconfig.h"
 #include "estl/fast_hash_map.h"
@@ -40,9 +41,12 @@ public:
 	Error Update(const string &_namespace, Item &item);
 	Error Upsert(const string &_namespace, Item &item);
 	Error Delete(const string &_namespace, Item &item);
+	Error ModifyItems(const string &_namespace, vector<Item> &items, int mode);
 	Error Delete(const Query &query, QueryResults &result);
+	Error Update(const Query &query, QueryResults &result);
 	Error Select(const string &query, QueryResults &result);
 	Error Select(const Query &query, QueryResults &result);
+	Error Select(const Query &query, const QueryResultsConsumer &consumer);
 	Error Commit(const string &namespace_);
 	Item NewItem(const string &_namespace);
 	Error GetMeta(const string &_namespace, const string &key, string &data);
@@ -95,9 +99,15 @@ protected:
 		bool locked_ = false;
 		bool upgraded_ = false;
 	};
-	void doSelect(const Query &q, QueryResults &res, JoinedSelectors &joinedSelectors, NsLocker &locker, SelectFunctionsHolder &func);
+	Error select(const Query &q, QueryResults &result, const QueryResultsConsumer *consumer);
+	void doSelect(const Query &q, QueryResults &res, JoinedSelectors &joinedSelectors, NsLocker &locker, SelectFunctionsHolder &func,
+				  const QueryResultsConsumer *consumer = nullptr);
 	JoinedSelectors prepareJoinedSelectors(const Query &q, QueryResults &result, NsLocker &locks, h_vector<Query, 4> &queries,
 										   SelectFunctionsHolder &func);
+	// Estimate count of rows of joined namespace, which are matched by conditions of joined query
+	int estimateJoinedRows(const Namespace::Ptr &jns, const SelectCtx::PreResult::Ptr &preResult);
+	JoinHashTable::Ptr prepareJoinHashTable(const Query &q, const Query &jq, Namespace::Ptr ns, Namespace::Ptr jns,
+											SelectCtx::PreResult::Ptr preResult, NsLocker &locks);
 
 	void syncSystemNamespaces(const string &nsName);
 	void createSystemNamespaces();
@@ -120,6 +130,7 @@ protected:
 
 	QueriesStatTracer queriesStatTracker_;
 	std::shared_ptr<DBProfilingConfig> profConfig_;
+	std::shared_ptr<DBSelectConfig> selectConfig_;
 	std::mutex profCfgMtx_;
 };
 
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
+#include <functional>
 #include <memory>
 
 #include "core/comparator.h"
 #include "core/idset.h"
+#include "core/idsetbitmap.h"
 
 namespace reindexer {
 
@@ -85,28 +88,62 @@ public:
 		auto mergedIds = std::make_shared<IdSet>();
 
 		size_t expectSize = 0;
+		IdType minId = INT_MAX, maxId = INT_MIN;
 		for (auto it = begin(); it != end(); it++) {
 			it->it_ = it->ids_.begin();
 			expectSize += it->ids_.size();
+			if (it->ids_.size()) {
+				minId = std::min(minId, it->ids_.front());
+				maxId = std::max(maxId, it->ids_.back());
+			}
 		}
-		mergedIds->reserve(expectSize);
 
-		for (;;) {
-			int min = mergedIds->size() ? mergedIds->back() : INT_MIN;
-			int curMin = INT_MAX;
+		if (size() > 1 && IdSetBitmap::IsDense(minId, maxId, expectSize)) {
+			IdSetBitmap bitmap(minId, maxId);
+			for (auto it = begin(); it != end(); it++) bitmap.Add(it->ids_.begin(), it->ids_.end());
+			bitmap.CopyTo(*mergedIds);
+		} else {
+			// K-way merge by min-heap of current ids of idsets: O(N*log(K)) steps
+			mergedIds->reserve(expectSize);
+			std::vector<std::pair<IdType, size_t>> heap;
+			heap.reserve(size());
 			for (auto it = begin(); it != end(); it++) {
-				for (; it->it_ != it->ids_.end() && *it->it_ <= min; it->it_++) {
-				};
-				if (it->it_ != it->ids_.end() && *it->it_ < curMin) curMin = *it->it_;
+				if (it->it_ != it->ids_.end()) heap.emplace_back(*it->it_, it - begin());
 			}
-			if (curMin == INT_MAX) break;
-			mergedIds->Add(curMin, IdSet::Unordered);
-		};
+			auto cmp = std::greater<std::pair<IdType, size_t>>();
+			std::make_heap(heap.begin(), heap.end(), cmp);
+			while (!heap.empty()) {
+				std::pop_heap(heap.begin(), heap.end(), cmp);
+				auto &top = heap.back();
+				if (!mergedIds->size() || mergedIds->back() != top.first) mergedIds->Add(top.first, IdSet::Unordered);
+				auto it = begin() + top.second;
+				if (++it->it_ != it->ids_.end()) {
+					top.first = *it->it_;
+					std::push_heap(heap.begin(), heap.end(), cmp);
+				} else {
+					heap.pop_back();
+				}
+			}
+		}
 		mergedIds->shrink_to_fit();
 		clear();
 		push_back(SingleSelectKeyResult(mergedIds));
 		return mergedIds;
 	}
+	// Idsets could be merged by bitmap: they are dense enough and there are no ranges
+	bool canMergeByBitmap() const {
+		size_t idsCount = 0;
+		IdType minId = INT_MAX, maxId = INT_MIN;
+		for (auto it = begin(); it != end(); it++) {
+			if (it->isRange_) return false;
+			idsCount += it->ids_.size();
+			if (it->ids_.size()) {
+				minId = std::min(minId, it->ids_.front());
+				maxId = std::max(maxId, it->ids_.back());
+			}
+		}
+		return IdSetBitmap::IsDense(minId, maxId, idsCount);
+	}
 };
 
 class SelectKeyResults : public h_vector<SelectKeyResult, 1> {
@@ -0,0 +1,150 @@
+#include "core/storageloader.h"
+#include <stdint.h>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/itemimpl.h"
+
+namespace reindexer {
+
+// Number of items, which are read from cursor and decoded at once
+const int kItemsPerChunk = 256;
+// Max number of decoder threads. Namespaces are loaded in parallel too, so do not use all CPU cores for single namespace
+const int kMaxStorageDecoders = 4;
+
+StorageLoader::StorageLoader(PayloadType payloadType, const TagsMatcher &tagsMatcher, int decoders)
+	: payloadType_(payloadType), tagsMatcher_(tagsMatcher), decoders_(decoders) {
+	if (decoders_ <= 0) decoders_ = std::min(std::max(int(std::thread::hardware_concurrency()) - 1, 1), kMaxStorageDecoders);
+}
+
+void StorageLoader::Load(datastorage::Cursor &cursor, string_view from, string_view to, const ItemFunc &fn) {
+	// Chunk of items, which is passed through pipeline: Free -> Read -> Decoding -> Decoded -> Free
+	struct chunk {
+		enum State { Free, Read, Decoding, Decoded } state = Free;
+		std::vector<std::string> data;
+		std::vector<ItemImpl> items;
+		std::vector<Error> errors;
+		size_t count = 0;
+	};
+
+	std::vector<chunk> chunks(2 * decoders_ + 2);
+	std::mutex mtx;
+	std::condition_variable cond;
+	// Sequence numbers of chunks: next to read, next to decode, and total number of chunks, if cursor is at the end
+	size_t readSeq = 0, decodeSeq = 0, totalChunks = SIZE_MAX;
+	bool terminate = false;
+
+	// Error of storage reading. Reader stops on error, and it is thrown to caller after all read chunks are processed
+	Error readErr;
+	auto setReadErr = [&](const Error &err) {
+		std::lock_guard<std::mutex> lck(mtx);
+		readErr = err;
+		totalChunks = readSeq;
+		cond.notify_all();
+	};
+
+	auto reader = [&]() {
+		try {
+			cursor.Seek(from);
+			for (;;) {
+				std::unique_lock<std::mutex> lck(mtx);
+				auto &ch = chunks[readSeq % chunks.size()];
+				cond.wait(lck, [&]() { return terminate || ch.state == chunk::Free; });
+				if (terminate) return;
+				lck.unlock();
+
+				ch.count = 0;
+				for (; ch.count < size_t(kItemsPerChunk) && cursor.Valid() && cursor.GetComparator().Compare(cursor.Key(), to) < 0;
+					 cursor.Next()) {
+					string_view dataSlice = cursor.Value();
+					if (!dataSlice.size()) continue;
+					if (ch.data.size() <= ch.count) ch.data.emplace_back();
+					ch.data[ch.count++].assign(dataSlice.data(), dataSlice.size());
+				}
+
+				lck.lock();
+				if (ch.count) {
+					ch.state = chunk::Read;
+					readSeq++;
+				}
+				if (ch.count < size_t(kItemsPerChunk)) totalChunks = readSeq;
+				cond.notify_all();
+				if (totalChunks != SIZE_MAX) return;
+			}
+		} catch (const Error &err) {
+			setReadErr(err);
+		} catch (const std::exception &err) {
+			setReadErr(Error(errLogic, err.what()));
+		}
+	};
+
+	auto decoder = [&]() {
+		for (;;) {
+			std::unique_lock<std::mutex> lck(mtx);
+			cond.wait(lck, [&]() {
+				return terminate || decodeSeq == totalChunks || (decodeSeq < readSeq && chunks[decodeSeq % chunks.size()].state == chunk::Read);
+			});
+			if (terminate || decodeSeq == totalChunks) return;
+			auto &ch = chunks[decodeSeq++ % chunks.size()];
+			ch.state = chunk::Decoding;
+			lck.unlock();
+
+			while (ch.items.size() < ch.count) {
+				ch.items.emplace_back(payloadType_, tagsMatcher_);
+				ch.items.back().Unsafe(true);
+			}
+			ch.errors.resize(ch.count);
+			for (size_t i = 0; i < ch.count; i++) {
+				try {
+					ch.errors[i] = ch.items[i].FromCJSON(ch.data[i]);
+				} catch (const Error &err) {
+					ch.errors[i] = err;
+				} catch (const std::exception &err) {
+					ch.errors[i] = Error(errLogic, err.what());
+				}
+			}
+
+			lck.lock();
+			ch.state = chunk::Decoded;
+			cond.notify_all();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.emplace_back(reader);
+	for (int i = 0; i < decoders_; i++) threads.emplace_back(decoder);
+
+	auto stop = [&]() {
+		std::unique_lock<std::mutex> lck(mtx);
+		terminate = true;
+		cond.notify_all();
+		lck.unlock();
+		for (auto &th : threads) th.join();
+	};
+
+	try {
+		for (size_t seq = 0;; seq++) {
+			std::unique_lock<std::mutex> lck(mtx);
+			auto &ch = chunks[seq % chunks.size()];
+			cond.wait(lck, [&]() { return seq == totalChunks || (seq < readSeq && ch.state == chunk::Decoded); });
+			if (seq == totalChunks) break;
+			lck.unlock();
+
+			for (size_t i = 0; i < ch.count; i++) fn(ch.items[i], ch.errors[i], ch.data[i].size());
+
+			lck.lock();
+			ch.state = chunk::Free;
+			cond.notify_all();
+		}
+	} catch (...) {
+		stop();
+		throw;
+	}
+	stop();
+	if (!readErr.ok()) throw readErr;
+}
+
+}  // namespace reindexer
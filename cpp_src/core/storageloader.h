@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include "core/cjson/tagsmatcher.h"
+#include "core/payload/payloadtype.h"
+#include "core/storage/idatastorage.h"
+
+namespace reindexer {
+
+class ItemImpl;
+
+/// Pipelined loader of items from storage. Storage cursor is read by separate thread, CJSON of items is decoded by
+/// several decoder threads, and decoded items are passed to caller's thread in order of storage keys
+class StorageLoader {
+public:
+	/// Function, which is called for each loaded item in caller's thread
+	/// @param item - decoded item. Item is valid only until function returns
+	/// @param err - error of item decoding
+	/// @param dataSize - size of item's data in storage
+	typedef std::function<void(ItemImpl &item, const Error &err, size_t dataSize)> ItemFunc;
+
+	/// Constructs loader
+	/// @param payloadType - payload type of namespace
+	/// @param tagsMatcher - tags matcher of namespace
+	/// @param decoders - number of decoder threads. 0 - choose by number of CPU cores
+	StorageLoader(PayloadType payloadType, const TagsMatcher &tagsMatcher, int decoders = 0);
+
+	/// Load items with keys in range [from, to)
+	/// @param cursor - storage cursor
+	/// @param from - first key
+	/// @param to - key after last key
+	/// @param fn - function, which is called for each loaded item
+	void Load(datastorage::Cursor &cursor, string_view from, string_view to, const ItemFunc &fn);
+
+protected:
+	PayloadType payloadType_;
+	TagsMatcher tagsMatcher_;
+	int decoders_;
+};
+
+}  // namespace reindexer
@@ -45,7 +45,12 @@ typedef enum QueryItemType {
 	QueryAggregation,
 	QuerySelectFilter,
 	QuerySelectFunction,
-	QueryEnd
+	QueryEnd,
+	QueryJoinStrategy,
+	QueryParallelism,
+	QueryAggregationLimit,
+	QueryExplain,
+	QueryUpdateField,
 } QueryItemType;
 
 typedef enum QuerySerializeMode {
@@ -86,12 +91,14 @@ enum ErrorCode {
 
 enum OpType { OpOr = 1, OpAnd = 2, OpNot = 3 };
 
-enum AggType { AggSum, AggAvg };
+enum AggType { AggSum, AggAvg, AggFacet, AggMin, AggMax, AggCountDistinct };
 
 enum { TAG_VARINT, TAG_DOUBLE, TAG_STRING, TAG_ARRAY, TAG_BOOL, TAG_NULL, TAG_OBJECT, TAG_END };
 
 enum JoinType { LeftJoin, InnerJoin, OrInnerJoin, Merge };
 
+enum JoinStrategy { JoinStrategyAuto, JoinStrategyNestedLoop, JoinStrategyHash };
+
 enum CalcTotalMode { ModeNoTotal, ModeCachedTotal, ModeAccurateTotal };
 
 enum DataFormat { FormatJson, FormatCJson };
@@ -112,6 +119,10 @@ enum {
 	kResultsWithCJson = 0x2,
 	kResultsWithJson = 0x3,
 	kResultsWithPayloadTypes = 0x8,
+	// Aggregation results are put as JSON objects. Otherwise only their values are put as doubles, as older clients expect
+	kResultsWithAggJson = 0x10,
+	// Plan of query is put after aggregation results. Clients set it for explained queries and for SQL queries, which may be explained
+	kResultsWithExplain = 0x20,
 };
 
 typedef enum IndexOpt {
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define REINDEX_FLAT_HASH_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace reindexer {
+
+namespace flat_hash_detail {
+
+typedef int8_t ctrl_t;
+// Control byte of slot is kEmpty, kDeleted, or 7 bits of hash of key, which is stored in slot
+const ctrl_t kEmpty = -128;
+const ctrl_t kDeleted = -2;
+
+inline int ctz(uint64_t w) {
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanForward64(&idx, w);
+	return int(idx);
+#else
+	return __builtin_ctzll(w);
+#endif
+}
+
+#ifdef REINDEX_FLAT_HASH_SSE2
+// Group of control bytes, which are matched by single instruction. Bit i of mask is set for matched byte i
+struct Group {
+	static const size_t kWidth = 16;
+	explicit Group(const ctrl_t *pos) : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+	uint64_t Match(ctrl_t h2) const { return uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))); }
+	uint64_t MatchEmpty() const { return Match(kEmpty); }
+	uint64_t MatchNonFull() const { return uint64_t(_mm_movemask_epi8(ctrl_)); }
+	static size_t Index(uint64_t mask) { return size_t(ctz(mask)); }
+
+	__m128i ctrl_;
+};
+#else
+// Portable group of control bytes. The highest bit of each matched byte is set in mask
+struct Group {
+	static const size_t kWidth = 8;
+	explicit Group(const ctrl_t *pos) { memcpy(&ctrl_, pos, sizeof(ctrl_)); }
+	// Can match false positive full slot right after matched one, so keys of matched slots are compared anyway
+	uint64_t Match(ctrl_t h2) const {
+		uint64_t x = ctrl_ ^ (kLsbs * uint8_t(h2));
+		return (x - kLsbs) & ~x & kMsbs;
+	}
+	uint64_t MatchEmpty() const { return ctrl_ & (~ctrl_ << 6) & kMsbs; }
+	uint64_t MatchNonFull() const { return ctrl_ & kMsbs; }
+	static size_t Index(uint64_t mask) { return size_t(ctz(mask)) >> 3; }
+
+	static const uint64_t kLsbs = 0x0101010101010101ULL;
+	static const uint64_t kMsbs = 0x8080808080808080ULL;
+	uint64_t ctrl_;
+};
+#endif
+
+}  // namespace flat_hash_detail
+
+// Open addressing hash map (Swiss table). Keys and values are stored inline in array of slots, and 7 bits of hash of
+// each key are stored in separate array of control bytes, which are probed by groups. So lookup of key usually touches one
+// group of control bytes and one slot, without pointer chasing and without comparison of unmatched keys.
+// Unlike std::unordered_map, slots are moved on rehash, so any insert invalidates iterators, pointers and references to elements.
+// Erase does not move other elements.
+template <typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>>
+class flat_hash_map {
+	typedef flat_hash_detail::ctrl_t ctrl_t;
+	typedef flat_hash_detail::Group Group;
+
+public:
+	typedef K key_type;
+	typedef V mapped_type;
+	// Key is not const, since slots are moved on rehash. It must not be modified by user
+	typedef std::pair<K, V> value_type;
+	typedef H hasher;
+	typedef E key_equal;
+	typedef size_t size_type;
+
+	template <bool Const>
+	class base_iterator {
+		friend class flat_hash_map;
+		template <bool>
+		friend class base_iterator;
+		typedef typename std::conditional<Const, const flat_hash_map, flat_hash_map>::type map_type;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef typename flat_hash_map::value_type value_type;
+		typedef ptrdiff_t difference_type;
+		typedef typename std::conditional<Const, const value_type *, value_type *>::type pointer;
+		typedef typename std::conditional<Const, const value_type &, value_type &>::type reference;
+
+		base_iterator() : m_(nullptr), idx_(0) {}
+		base_iterator(map_type *m, size_t idx) : m_(m), idx_(idx) {}
+		// Conversion of iterator to const_iterator
+		template <bool C = Const, typename std::enable_if<C>::type * = nullptr>
+		base_iterator(const base_iterator<false> &other) : m_(other.m_), idx_(other.idx_) {}
+
+		reference operator*() const { return m_->slots_[idx_]; }
+		pointer operator->() const { return &m_->slots_[idx_]; }
+		base_iterator &operator++() {
+			idx_ = m_->nextFull(idx_ + 1);
+			return *this;
+		}
+		base_iterator operator++(int) {
+			base_iterator ret = *this;
+			++(*this);
+			return ret;
+		}
+		template <bool C>
+		bool operator==(const base_iterator<C> &other) const {
+			return idx_ == other.idx_;
+		}
+		template <bool C>
+		bool operator!=(const base_iterator<C> &other) const {
+			return idx_ != other.idx_;
+		}
+
+	protected:
+		map_type *m_;
+		size_t idx_;
+	};
+	typedef base_iterator<false> iterator;
+	typedef base_iterator<true> const_iterator;
+
+	// Table is preallocated with at least bucket_count slots
+	explicit flat_hash_map(size_t bucket_count = 0, const H &hash = H(), const E &equal = E()) : hash_(hash), equal_(equal) {
+		if (bucket_count) resize(capacityFor(maxLoad(bucket_count)));
+	}
+	flat_hash_map(const flat_hash_map &other) : hash_(other.hash_), equal_(other.equal_) {
+		if (!other.capacity_) return;
+		allocate(other.capacity_);
+		memcpy(ctrl_, other.ctrl_, capacity_);
+		for (size_t i = 0; i < capacity_; i++) {
+			if (isFull(ctrl_[i])) new (slots_ + i) value_type(other.slots_[i]);
+		}
+		size_ = other.size_;
+		growthLeft_ = other.growthLeft_;
+	}
+	flat_hash_map(flat_hash_map &&other) noexcept : hash_(std::move(other.hash_)), equal_(std::move(other.equal_)) { swapData(other); }
+	flat_hash_map &operator=(const flat_hash_map &other) {
+		if (this != &other) {
+			flat_hash_map tmp(other);
+			swap(tmp);
+		}
+		return *this;
+	}
+	flat_hash_map &operator=(flat_hash_map &&other) noexcept {
+		if (this != &other) {
+			destroy();
+			hash_ = std::move(other.hash_);
+			equal_ = std::move(other.equal_);
+			swapData(other);
+		}
+		return *this;
+	}
+	~flat_hash_map() { destroy(); }
+
+	iterator begin() { return iterator(this, nextFull(0)); }
+	iterator end() { return iterator(this, capacity_); }
+	const_iterator begin() const { return const_iterator(this, nextFull(0)); }
+	const_iterator end() const { return const_iterator(this, capacity_); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+	size_t size() const { return size_; }
+	bool empty() const { return !size_; }
+	size_t bucket_count() const { return capacity_; }
+	// Size of memory, allocated by map
+	size_t heap_size() const { return capacity_ * (sizeof(value_type) + sizeof(ctrl_t)); }
+
+	iterator find(const K &key) { return iterator(this, findIndex(key, hashOf(key))); }
+	const_iterator find(const K &key) const { return const_iterator(this, findIndex(key, hashOf(key))); }
+	size_t count(const K &key) const { return findIndex(key, hashOf(key)) != capacity_; }
+
+	std::pair<iterator, bool> insert(value_type &&v) {
+		size_t hash = hashOf(v.first);
+		size_t idx = findIndex(v.first, hash);
+		if (idx != capacity_) return {iterator(this, idx), false};
+		idx = prepareInsert(hash);
+		new (slots_ + idx) value_type(std::move(v));
+		return {iterator(this, idx), true};
+	}
+	std::pair<iterator, bool> insert(const value_type &v) { return insert(value_type(v)); }
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(Args &&... args) {
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+	V &operator[](const K &key) {
+		size_t hash = hashOf(key);
+		size_t idx = findIndex(key, hash);
+		if (idx == capacity_) {
+			idx = prepareInsert(hash);
+			new (slots_ + idx) value_type(key, V());
+		}
+		return slots_[idx].second;
+	}
+
+	size_t erase(const K &key) {
+		size_t idx = findIndex(key, hashOf(key));
+		if (idx == capacity_) return 0;
+		eraseIndex(idx);
+		return 1;
+	}
+	iterator erase(const_iterator it) {
+		eraseIndex(it.idx_);
+		return iterator(this, nextFull(it.idx_ + 1));
+	}
+	iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+	void clear() {
+		for (size_t i = 0; i < capacity_; i++) {
+			if (isFull(ctrl_[i])) slots_[i].~value_type();
+		}
+		if (capacity_) memset(ctrl_, flat_hash_detail::kEmpty, capacity_);
+		size_ = 0;
+		growthLeft_ = maxLoad(capacity_);
+	}
+	void reserve(size_t count) {
+		if (count > size_ + growthLeft_) resize(capacityFor(count));
+	}
+	void swap(flat_hash_map &other) noexcept {
+		std::swap(hash_, other.hash_);
+		std::swap(equal_, other.equal_);
+		swapData(other);
+	}
+
+protected:
+	static bool isFull(ctrl_t c) { return c >= 0; }
+	// Max count of elements in table: at least 1/8 of slots are kept empty, so probing stops fast on missing keys
+	static size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+	static size_t capacityFor(size_t count) {
+		size_t capacity = Group::kWidth;
+		while (maxLoad(capacity) < count) capacity *= 2;
+		return capacity;
+	}
+	size_t hashOf(const K &key) const {
+		// Mix bits of hash, since std::hash of integers is identity
+		uint64_t h = uint64_t(hash_(key)) * 0x9E3779B97F4A7C15ULL;
+		return size_t(h ^ (h >> 32));
+	}
+	static ctrl_t h2(size_t hash) { return ctrl_t(hash & 0x7F); }
+
+	// Groups are probed quadratically: sequence of groups visits all groups of table, since count of groups is power of 2
+	size_t findIndex(const K &key, size_t hash) const {
+		if (!capacity_) return capacity_;
+		size_t mask = capacity_ / Group::kWidth - 1, group = (hash >> 7) & mask;
+		for (size_t step = 1;; group = (group + step++) & mask) {
+			Group g(ctrl_ + group * Group::kWidth);
+			for (uint64_t m = g.Match(h2(hash)); m; m &= m - 1) {
+				size_t idx = group * Group::kWidth + Group::Index(m);
+				if (equal_(slots_[idx].first, key)) return idx;
+			}
+			if (g.MatchEmpty()) return capacity_;
+		}
+	}
+	size_t findNonFull(size_t hash) const {
+		size_t mask = capacity_ / Group::kWidth - 1, group = (hash >> 7) & mask;
+		for (size_t step = 1;; group = (group + step++) & mask) {
+			uint64_t m = Group(ctrl_ + group * Group::kWidth).MatchNonFull();
+			if (m) return group * Group::kWidth + Group::Index(m);
+		}
+	}
+	size_t prepareInsert(size_t hash) {
+		if (!capacity_) resize(Group::kWidth);
+		size_t idx = findNonFull(hash);
+		if (!growthLeft_ && ctrl_[idx] != flat_hash_detail::kDeleted) {
+			// Table is rehashed to the same capacity, if most of non-empty slots are deleted
+			resize(size_ * 2 <= maxLoad(capacity_) ? capacity_ : capacity_ * 2);
+			idx = findNonFull(hash);
+		}
+		if (ctrl_[idx] == flat_hash_detail::kEmpty) growthLeft_--;
+		ctrl_[idx] = h2(hash);
+		size_++;
+		return idx;
+	}
+	void eraseIndex(size_t idx) {
+		slots_[idx].~value_type();
+		size_--;
+		// Probing stops on group with empty slot. If group already has empty slot, then no probe sequence passes through it,
+		// and slot can be marked as empty. Otherwise it's marked as deleted, to keep probe sequences of other keys
+		if (Group(ctrl_ + (idx & ~(Group::kWidth - 1))).MatchEmpty()) {
+			ctrl_[idx] = flat_hash_detail::kEmpty;
+			growthLeft_++;
+		} else {
+			ctrl_[idx] = flat_hash_detail::kDeleted;
+		}
+	}
+	size_t nextFull(size_t idx) const {
+		while (idx < capacity_ && !isFull(ctrl_[idx])) idx++;
+		return idx;
+	}
+
+	void allocate(size_t capacity) {
+		ctrl_ = new ctrl_t[capacity];
+		memset(ctrl_, flat_hash_detail::kEmpty, capacity);
+		slots_ = static_cast<value_type *>(operator new(capacity * sizeof(value_type)));
+		capacity_ = capacity;
+		growthLeft_ = maxLoad(capacity);
+		size_ = 0;
+	}
+	void resize(size_t capacity) {
+		ctrl_t *oldCtrl = ctrl_;
+		value_type *oldSlots = slots_;
+		size_t oldCapacity = capacity_, oldSize = size_;
+		allocate(capacity);
+		for (size_t i = 0; i < oldCapacity; i++) {
+			if (!isFull(oldCtrl[i])) continue;
+			size_t hash = hashOf(oldSlots[i].first);
+			size_t idx = findNonFull(hash);
+			ctrl_[idx] = h2(hash);
+			new (slots_ + idx) value_type(std::move(oldSlots[i]));
+			oldSlots[i].~value_type();
+		}
+		size_ = oldSize;
+		growthLeft_ -= oldSize;
+		delete[] oldCtrl;
+		operator delete(oldSlots);
+	}
+	void destroy() {
+		for (size_t i = 0; i < capacity_; i++) {
+			if (isFull(ctrl_[i])) slots_[i].~value_type();
+		}
+		delete[] ctrl_;
+		operator delete(slots_);
+		ctrl_ = nullptr;
+		slots_ = nullptr;
+		capacity_ = size_ = growthLeft_ = 0;
+	}
+	void swapData(flat_hash_map &other) noexcept {
+		std::swap(ctrl_, other.ctrl_);
+		std::swap(slots_, other.slots_);
+		std::swap(capacity_, other.capacity_);
+		std::swap(size_, other.size_);
+		std::swap(growthLeft_, other.growthLeft_);
+	}
+
+	H hash_;
+	E equal_;
+	ctrl_t *ctrl_ = nullptr;
+	value_type *slots_ = nullptr;
+	// Count of slots. It's power of 2, and multiple of width of group
+	size_t capacity_ = 0;
+	size_t size_ = 0;
+	// Count of elements, which can be inserted into empty slots before rehash
+	size_t growthLeft_ = 0;
+};
+
+}  // namespace reindexer
@@ -38,7 +38,7 @@ token tokenizer::next_token(bool to_lower) {
 		res.type = TokenNumber;
 		do {
 			res.text_.push_back(*cur++);
-		} while (isdigit(*cur));
+		} while (isdigit(*cur) || (*cur == '.' && isdigit(cur[1])));
 	} else if (*cur == '>' || *cur == '<' || *cur == '=') {
 		res.type = TokenOp;
 		do {
@@ -44,6 +44,9 @@ void ApiTvSimple::RegisterAllCases() {
 	Register("Query4CondRange", &ApiTvSimple::Query4CondRange, this);
 	Register("Query4CondRangeTotal", &ApiTvSimple::Query4CondRangeTotal, this);
 	Register("Query4CondRangeCachedTotal", &ApiTvSimple::Query4CondRangeCachedTotal, this);
+	Register("QueryWideSet", &ApiTvSimple::QueryWideSet, this);
+	Register("QueryWideSetTotal", &ApiTvSimple::QueryWideSetTotal, this);
+	Register("QueryWideRangeSortDesc", &ApiTvSimple::QueryWideRangeSortDesc, this);
 }
 
 Error ApiTvSimple::Initialize() {
@@ -589,3 +592,40 @@ void ApiTvSimple::Query4CondRangeCachedTotal(benchmark::State& state) {
 		if (!err.ok()) state.SkipWithError(err.what().c_str());
 	}
 }
+
+void ApiTvSimple::QueryWideSet(benchmark::State& state) {
+	AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		Query q(nsdef_.name);
+		q.Where("start_time", CondSet, toArray<int>(randomNumArray<int>(500, 0, 50000))).Limit(20);
+
+		QueryResults qres;
+		auto err = db_->Select(q, qres);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+	}
+}
+
+void ApiTvSimple::QueryWideSetTotal(benchmark::State& state) {
+	AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		Query q(nsdef_.name);
+		q.Where("start_time", CondSet, toArray<int>(randomNumArray<int>(500, 0, 50000))).Limit(20).ReqTotal();
+
+		QueryResults qres;
+		auto err = db_->Select(q, qres);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+	}
+}
+
+void ApiTvSimple::QueryWideRangeSortDesc(benchmark::State& state) {
+	AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		int startTime = random<int>(0, 50000);
+		Query q(nsdef_.name);
+		q.Where("start_time", CondRange, {startTime, startTime + 40}).Sort("year", true).Limit(20);
+
+		QueryResults qres;
+		auto err = db_->Select(q, qres);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+	}
+}
@@ -64,6 +64,10 @@ protected:
 	void Query4CondRangeTotal(State& state);
 	void Query4CondRangeCachedTotal(State& state);
 
+	void QueryWideSet(State& state);
+	void QueryWideSetTotal(State& state);
+	void QueryWideRangeSortDesc(State& state);
+
 private:
 	vector<string> countries_;
 	vector<string> locations_;
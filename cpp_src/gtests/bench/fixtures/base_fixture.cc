@@ -30,6 +30,8 @@ Error BaseFixture::Initialize() {
 void BaseFixture::RegisterAllCases() {
 	Register("Insert", &BaseFixture::Insert, this)->Iterations(id_seq_->Count());
 	Register("Update", &BaseFixture::Update, this)->Iterations(id_seq_->Count());
+	Register("Upsert", &BaseFixture::Upsert, this)->Iterations(id_seq_->Count());
+	Register("UpsertBatch", &BaseFixture::UpsertBatch, this)->Iterations(id_seq_->Count() / kUpsertBatchSize);
 }
 
 // FIXTURES
@@ -70,3 +72,41 @@ void BaseFixture::Update(benchmark::State& state) {
 	auto err = db_->Commit(nsdef_.name);
 	if (!err.ok()) state.SkipWithError(err.what().c_str());
 }
+
+void BaseFixture::Upsert(benchmark::State& state) {
+	benchmark::AllocsTracker allocsTracker(state);
+	id_seq_->Reset();
+	for (auto _ : state) {
+		auto item = MakeItem();
+		if (!item.Status().ok()) state.SkipWithError(item.Status().what().c_str());
+
+		auto err = db_->Upsert(nsdef_.name, item);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+
+		state.SetItemsProcessed(state.items_processed() + 1);
+	}
+	auto err = db_->Commit(nsdef_.name);
+	if (!err.ok()) state.SkipWithError(err.what().c_str());
+}
+
+// Same items as Upsert, but applied by kUpsertBatchSize items in one call
+void BaseFixture::UpsertBatch(benchmark::State& state) {
+	benchmark::AllocsTracker allocsTracker(state);
+	id_seq_->Reset();
+	std::vector<Item> items;
+	items.reserve(kUpsertBatchSize);
+	for (auto _ : state) {
+		items.clear();
+		for (int i = 0; i < kUpsertBatchSize; i++) {
+			items.push_back(MakeItem());
+			if (!items.back().Status().ok()) state.SkipWithError(items.back().Status().what().c_str());
+		}
+
+		auto err = db_->ModifyItems(nsdef_.name, items, ModeUpsert);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+
+		state.SetItemsProcessed(state.items_processed() + kUpsertBatchSize);
+	}
+	auto err = db_->Commit(nsdef_.name);
+	if (!err.ok()) state.SkipWithError(err.what().c_str());
+}
@@ -61,6 +61,8 @@ public:
 protected:
 	void Insert(State& state);
 	void Update(State& state);
+	void Upsert(State& state);
+	void UpsertBatch(State& state);
 
 	virtual Item MakeItem() = 0;
 
@@ -70,6 +72,8 @@ protected:
 	}
 
 protected:
+	static const int kUpsertBatchSize = 100;
+
 	Reindexer* db_;
 	NamespaceDef nsdef_;
 	shared_ptr<Sequence> id_seq_;
@@ -1,7 +1,13 @@
 #include "join_items.h"
 
+#include "allocs_tracker.h"
 #include "helpers.h"
 
+using benchmark::AllocsTracker;
+
+using reindexer::Query;
+using reindexer::QueryResults;
+
 reindexer::Error JoinItems::Initialize() {
 	assert(db_);
 	auto err = db_->AddNamespace(nsdef_);
@@ -31,7 +37,13 @@ reindexer::Error JoinItems::Initialize() {
 	return 0;
 }
 
-void JoinItems::RegisterAllCases() { BaseFixture::RegisterAllCases(); }
+void JoinItems::RegisterAllCases() {
+	BaseFixture::RegisterAllCases();
+	Register("InnerJoinNestedLoop", &JoinItems::InnerJoinNestedLoop, this);
+	Register("InnerJoinHash", &JoinItems::InnerJoinHash, this);
+	Register("LeftJoinNestedLoop", &JoinItems::LeftJoinNestedLoop, this);
+	Register("LeftJoinHash", &JoinItems::LeftJoinHash, this);
+}
 
 reindexer::Item JoinItems::MakeItem() {
 	Item item = db_->NewItem(nsdef_.name);
@@ -54,3 +66,23 @@ std::string JoinItems::randomString(const std::string& prefix) {
 	result += names_.at(random<size_t>(0, names_.size() - 1));
 	return result;
 }
+
+void JoinItems::InnerJoinNestedLoop(State& state) { join(state, JoinType::InnerJoin, JoinStrategyNestedLoop); }
+void JoinItems::InnerJoinHash(State& state) { join(state, JoinType::InnerJoin, JoinStrategyHash); }
+void JoinItems::LeftJoinNestedLoop(State& state) { join(state, JoinType::LeftJoin, JoinStrategyNestedLoop); }
+void JoinItems::LeftJoinHash(State& state) { join(state, JoinType::LeftJoin, JoinStrategyHash); }
+
+void JoinItems::join(State& state, JoinType joinType, JoinStrategy strategy) {
+	AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		Query q4join(nsdef_.name);
+		Query q(nsdef_.name);
+
+		q4join.Where("location", CondSet, {"mos", "dv", "sib"}).ForceJoinStrategy(strategy);
+		q.Where("device", CondSet, {"ottstb", "smarttv"}).Join(joinType, "id", "id", CondEq, OpAnd, q4join).ReqTotal();
+
+		QueryResults qres;
+		auto err = db_->Select(q, qres);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+	}
+}
@@ -21,6 +21,13 @@ protected:
 
 	string randomString(const string& prefix);
 
+	void InnerJoinNestedLoop(State& state);
+	void InnerJoinHash(State& state);
+	void LeftJoinNestedLoop(State& state);
+	void LeftJoinHash(State& state);
+
+	void join(State& state, JoinType joinType, JoinStrategy strategy);
+
 private:
 	vector<string> adjectives_;
 	vector<string> devices_;
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <set>
 #include <unordered_set>
 #include "ft_api.h"
 #include "tools/stringstools.h"
@@ -55,3 +56,66 @@ TEST_F(FTApi, NumberToWordsSelect) {
 		EXPECT_TRUE(result == val);
 	}
 }
+
+TEST_F(FTApi, SelectAfterUpdates) {
+	auto upsert = [&](int id, const string& ft1) {
+		Item item = NewItem("nm1");
+		item["id"] = id;
+		item["ft1"] = ft1;
+		Upsert("nm1", item);
+		Commit("nm1");
+	};
+	auto selectIds = [&](const string& index, const string& word) {
+		QueryResults res;
+		auto err = reindexer->Select(Query("nm1").Where(index, CondEq, word), res);
+		EXPECT_TRUE(err.ok()) << err.what();
+		std::set<int> ids;
+		for (auto it : res) ids.insert(it.GetItem()["id"].Get<int>());
+		return ids;
+	};
+	auto check = [&](const string& word, const std::set<int>& expected) {
+		EXPECT_EQ(selectIds("ft1", word), expected) << word;
+		EXPECT_EQ(selectIds("ft3", word), expected) << word;
+	};
+
+	// First select builds all documents, documents of next commits are added incrementally
+	upsert(0, "alpha beta");
+	upsert(1, "beta gamma");
+	upsert(2, "gamma delta");
+	check("beta", {0, 1});
+
+	upsert(3, "delta epsilon");
+	upsert(4, "beta epsilon");
+	check("beta", {0, 1, 4});
+	check("epsilon", {3, 4});
+	check("delta", {2, 3});
+	check("epsilo*", {3, 4});
+
+	// Change text of documents and delete documents
+	upsert(1, "zeta omega");
+	upsert(3, "alpha zeta");
+	Item item = NewItem("nm1");
+	item["id"] = 0;
+	auto err = reindexer->Delete("nm1", item);
+	ASSERT_TRUE(err.ok()) << err.what();
+	Commit("nm1");
+
+	check("beta", {4});
+	check("zeta", {1, 3});
+	check("alpha", {3});
+	check("delta", {2});
+	check("omega gamma", {1, 2});
+
+	// Same text in new document
+	upsert(5, "zeta omega");
+	check("omega", {1, 5});
+
+	for (int i = 6; i < 2000; i++) {
+		upsert(i, "word" + std::to_string(i) + " beta");
+		if (i % 100 == 0) {
+			EXPECT_EQ(selectIds("ft1", "word" + std::to_string(i)), std::set<int>{i});
+		}
+	}
+	check("word1999", {1999});
+	EXPECT_EQ(selectIds("ft1", "beta").size(), 1995);
+}
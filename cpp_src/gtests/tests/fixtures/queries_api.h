@@ -742,8 +742,8 @@ protected:
 			yearSum += item[kFieldNameYear].Get<int>();
 		}
 
-		EXPECT_DOUBLE_EQ(testQr.aggregationResults[1], yearSum) << "Aggregation Sum result is incorrect!";
-		EXPECT_DOUBLE_EQ(testQr.aggregationResults[0], yearSum / checkQr.Count()) << "Aggregation Sum result is incorrect!";
+		EXPECT_DOUBLE_EQ(testQr.aggregationResults[1].value, yearSum) << "Aggregation Sum result is incorrect!";
+		EXPECT_DOUBLE_EQ(testQr.aggregationResults[0].value, yearSum / checkQr.Count()) << "Aggregation Sum result is incorrect!";
 	}
 
 	void CheckSqlQueries() {
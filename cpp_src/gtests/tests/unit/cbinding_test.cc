@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "core/cbinding/reindexer_c.h"
+#include "core/cbinding/resultserializer.h"
+#include "core/query/queryresults.h"
+#include "tools/serializer.h"
+
+using std::string;
+using reindexer::Serializer;
+using reindexer::WrResultSerializer;
+
+struct ResultsChunk {
+	uint64_t resultsPtr;
+	int totalCount, queryCount, count;
+};
+
+static ResultsChunk readChunk(const reindexer_resbuffer &buf) {
+	Serializer ser(reinterpret_cast<const void *>(buf.data), buf.len);
+	ResultsChunk chunk;
+	chunk.resultsPtr = ser.GetUInt64();
+	chunk.totalCount = ser.GetVarUint();
+	chunk.queryCount = ser.GetVarUint();
+	chunk.count = ser.GetVarUint();
+	return chunk;
+}
+
+// Skip params of query without payload types, which are followed by aggregation results
+static void skipQueryParams(Serializer &ser) {
+	ser.GetUInt64();
+	for (int i = 0; i < 7; i++) ser.GetVarUint();
+}
+
+TEST(CBinding, FetchResultsByChunks) {
+	const int fetchCount = 2;
+
+	init_reindexer();
+	reindexer_error err = reindexer_init_system_namespaces();
+	ASSERT_EQ(err.code, 0);
+
+	string sql = "SELECT * FROM #namespaces";
+	reindexer_string query{&sql[0], int(sql.size())};
+	reindexer_ret ret = reindexer_select(query, 0, nullptr, 0, fetchCount);
+	ASSERT_EQ(ret.err.code, 0);
+	ASSERT_NE(ret.out.results_ptr, 0);
+
+	ResultsChunk chunk = readChunk(ret.out);
+	const int queryCount = chunk.queryCount;
+	EXPECT_NE(chunk.resultsPtr, 0);
+	EXPECT_GT(queryCount, fetchCount);
+	EXPECT_EQ(chunk.count, fetchCount);
+
+	// Remaining results are served from the same pinned query results
+	reindexer_resbuffer buf = ret.out;
+	int fetched = chunk.count;
+	while (fetched < queryCount) {
+		ret = reindexer_fetch_results(buf, fetched, fetchCount, 0);
+		ASSERT_EQ(ret.err.code, 0);
+		EXPECT_EQ(ret.out.results_ptr, buf.results_ptr);
+		buf = ret.out;
+
+		chunk = readChunk(buf);
+		EXPECT_EQ(chunk.queryCount, queryCount);
+		EXPECT_EQ(chunk.count, std::min(fetchCount, queryCount - fetched));
+		ASSERT_GT(chunk.count, 0);
+		fetched += chunk.count;
+	}
+	EXPECT_EQ(fetched, queryCount);
+	reindexer_free_buffer(buf);
+
+	// Buffer, returned to pool, is reused by next query
+	ret = reindexer_select(query, 1, nullptr, 0, -1);
+	ASSERT_EQ(ret.err.code, 0);
+	EXPECT_EQ(ret.out.results_ptr, buf.results_ptr);
+	chunk = readChunk(ret.out);
+	EXPECT_EQ(chunk.queryCount, queryCount);
+	EXPECT_EQ(chunk.count, queryCount);
+	reindexer_free_buffer(ret.out);
+
+	destroy_reindexer();
+}
+
+TEST(CBinding, AggregationResultsFormat) {
+	reindexer::QueryResults qr;
+	reindexer::AggregationResult ar;
+	ar.field = "year";
+	ar.type = AggMax;
+	ar.value = 2018;
+	qr.aggregationResults.push_back(ar);
+
+	// Clients, which don't request JSON, get only values of aggregations
+	WrResultSerializer wrser(false, {kResultsWithCJson, nullptr, 0, 0, 0, 0});
+	wrser.PutResults(&qr);
+	Serializer ser(wrser.Slice());
+	skipQueryParams(ser);
+	ASSERT_EQ(ser.GetVarUint(), 1);
+	EXPECT_EQ(ser.GetDouble(), 2018);
+	EXPECT_TRUE(ser.Eof());
+
+	wrser.Reset();
+	wrser.SetOpts({kResultsWithCJson | kResultsWithAggJson, nullptr, 0, 0, 0, 0});
+	wrser.PutResults(&qr);
+	Serializer jser(wrser.Slice());
+	skipQueryParams(jser);
+	ASSERT_EQ(jser.GetVarUint(), 1);
+	EXPECT_EQ(jser.GetSlice().ToString(), "{\"field\":\"year\",\"type\":\"max\",\"value\":2018}");
+	EXPECT_TRUE(jser.Eof());
+}
+
+TEST(CBinding, ExplainResultsFormat) {
+	reindexer::QueryResults qr;
+	qr.explainResults = "{\"total_us\":1}";
+
+	// Plan of query is put only for clients, which request it
+	WrResultSerializer wrser(false, {kResultsWithCJson | kResultsWithAggJson, nullptr, 0, 0, 0, 0});
+	wrser.PutResults(&qr);
+	Serializer ser(wrser.Slice());
+	skipQueryParams(ser);
+	ASSERT_EQ(ser.GetVarUint(), 0);
+	EXPECT_TRUE(ser.Eof());
+
+	wrser.Reset();
+	wrser.SetOpts({kResultsWithCJson | kResultsWithAggJson | kResultsWithExplain, nullptr, 0, 0, 0, 0});
+	wrser.PutResults(&qr);
+	Serializer eser(wrser.Slice());
+	skipQueryParams(eser);
+	ASSERT_EQ(eser.GetVarUint(), 0);
+	EXPECT_EQ(eser.GetSlice().ToString(), qr.explainResults);
+	EXPECT_TRUE(eser.Eof());
+}
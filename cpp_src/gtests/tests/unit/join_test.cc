@@ -169,3 +169,35 @@ TEST_F(JoinSelectsApi, OrInnerJoinTest) {
 		}
 	}
 }
+
+TEST_F(JoinSelectsApi, JoinStrategiesTest) {
+	auto selectJoined = [this](JoinType joinType, JoinStrategy strategy, std::map<int, std::vector<int>>& joinedIds) {
+		Query queryBooks = Query(books_namespace).Where(price, CondGe, 500).ForceJoinStrategy(strategy);
+		Query joinQuery = Query(authors_namespace).Where(age, CondGe, 50);
+		joinQuery.Join(joinType, authorid, authorid_fk, CondEq, OpAnd, queryBooks);
+
+		reindexer::QueryResults qr;
+		Error err = reindexer->Select(joinQuery, qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+
+		for (auto rowIt : qr) {
+			Item item(rowIt.GetItem());
+			std::vector<int>& ids = joinedIds[item[authorid].Get<int>()];
+			auto it = qr.joined_->find(rowIt.GetItemRef().id);
+			if (it == qr.joined_->end() || it->second.empty()) continue;
+			for (auto jit : it->second[0]) {
+				Item bookItem(jit.GetItem());
+				ids.push_back(bookItem[bookid].Get<int>());
+			}
+			std::sort(ids.begin(), ids.end());
+		}
+	};
+
+	for (JoinType joinType : {JoinType::InnerJoin, JoinType::LeftJoin}) {
+		std::map<int, std::vector<int>> nestedLoopIds, hashIds;
+		selectJoined(joinType, JoinStrategyNestedLoop, nestedLoopIds);
+		selectJoined(joinType, JoinStrategyHash, hashIds);
+		EXPECT_FALSE(nestedLoopIds.empty());
+		EXPECT_TRUE(nestedLoopIds == hashIds) << "Join type " << Query::JoinTypeName(joinType);
+	}
+}
@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <thread>
+#include "gason/gason.h"
 #include "ns_api.h"
 
 TEST_F(NsApi, UpsertWithPrecepts) {
@@ -55,3 +61,1138 @@ TEST_F(NsApi, UpsertWithPrecepts) {
 		}
 	}
 }
+
+TEST_F(NsApi, SortOrdersAfterUpdates) {
+	CreateNamespace(default_namespace);
+
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"name", "tree", "string", IndexOpts()},
+											   IndexDeclaration{"genre", "hash", "int", IndexOpts()}});
+
+	const int itemsCount = 1000;
+	std::map<int, std::tuple<int, string, int>> items;
+	auto upsertItem = [&](int id, int year, const string &name, int genre) {
+		Item item = NewItem(default_namespace);
+		item["id"] = id;
+		item["year"] = year;
+		item["name"] = name;
+		item["genre"] = genre;
+		Upsert(default_namespace, item);
+		items[id] = std::make_tuple(year, name, genre);
+	};
+	auto checkSorted = [&](const string &sortIdx, int genre) {
+		QueryResults qr;
+		auto err = reindexer->Select(Query(default_namespace).Where("genre", CondEq, genre).Sort(sortIdx, false), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+
+		size_t expectedCount = 0;
+		for (auto &it : items) expectedCount += (std::get<2>(it.second) == genre);
+		ASSERT_EQ(qr.Count(), expectedCount);
+
+		std::tuple<int, string> prev;
+		bool first = true;
+		for (auto it : qr) {
+			Item item = it.GetItem();
+			int id = item["id"].Get<int>();
+			auto expected = items.find(id);
+			ASSERT_TRUE(expected != items.end()) << "Unexpected item id=" << id;
+			ASSERT_EQ(item["year"].Get<int>(), std::get<0>(expected->second));
+			ASSERT_EQ(item["name"].As<string>(), std::get<1>(expected->second));
+			ASSERT_EQ(item["genre"].Get<int>(), genre);
+			std::tuple<int, string> cur(std::get<0>(expected->second), std::get<1>(expected->second));
+			if (!first) {
+				if (sortIdx == "year")
+					ASSERT_LE(std::get<0>(prev), std::get<0>(cur));
+				else
+					ASSERT_LE(std::get<1>(prev), std::get<1>(cur));
+			}
+			prev = cur;
+			first = false;
+		}
+	};
+	auto checkAll = [&]() {
+		// Repeat queries to make namespace build sort orders
+		for (int i = 0; i < 10; i++) {
+			for (int genre = 0; genre < 5; genre++) {
+				checkSorted("year", genre);
+				checkSorted("name", genre);
+			}
+		}
+	};
+
+	for (int i = 0; i < itemsCount; i++) upsertItem(i, 2000 + rand() % 50, "name" + to_string(rand() % 500), rand() % 5);
+	checkAll();
+
+	// Update only sort fields, only filter field, and remove some of items
+	for (int i = 0; i < 50; i++) {
+		int id = rand() % itemsCount;
+		if (items.count(id)) {
+			auto vals = items[id];
+			upsertItem(id, 2000 + rand() % 50, std::get<1>(vals), std::get<2>(vals));
+			checkAll();
+		}
+
+		id = rand() % itemsCount;
+		if (items.count(id)) {
+			auto vals = items[id];
+			upsertItem(id, std::get<0>(vals), std::get<1>(vals), rand() % 5);
+			checkAll();
+		}
+
+		id = rand() % itemsCount;
+		Item item = NewItem(default_namespace);
+		item["id"] = id;
+		auto err = reindexer->Delete(default_namespace, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+		items.erase(id);
+		checkAll();
+
+		upsertItem(itemsCount + i, 2000 + rand() % 50, "name" + to_string(rand() % 500), rand() % 5);
+	}
+	checkAll();
+}
+
+TEST_F(NsApi, ConcurrentSelectsWithUpdates) {
+	CreateNamespace(default_namespace);
+
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"name", "hash", "string", IndexOpts()},
+											   IndexDeclaration{"genre", "hash", "int", IndexOpts()}});
+
+	const int itemsCount = 2000;
+	auto upsertItem = [&](int id) {
+		Item item = NewItem(default_namespace);
+		item["id"] = id;
+		item["year"] = 2000 + rand() % 50;
+		item["name"] = "name" + to_string(rand() % 100);
+		item["genre"] = rand() % 5;
+		Upsert(default_namespace, item);
+	};
+	for (int i = 0; i < itemsCount; i++) upsertItem(i);
+
+	std::atomic<bool> done(false);
+	std::atomic<int> errors(0);
+	// Each reader is using it's own index, so selects are commiting different indexes concurrently
+	auto reader = [&](int n) {
+		while (!done) {
+			QueryResults qr;
+			Query q(default_namespace);
+			switch (n) {
+				case 0:
+					q.Where("year", CondRange, {2010, 2020});
+					break;
+				case 1:
+					q.Where("name", CondEq, "name" + to_string(rand() % 100));
+					break;
+				default:
+					q.Where("genre", CondEq, rand() % 5);
+			}
+			auto err = reindexer->Select(q, qr);
+			if (!err.ok()) {
+				errors++;
+				continue;
+			}
+			for (auto it : qr) {
+				Item item = it.GetItem();
+				bool match = true;
+				switch (n) {
+					case 0:
+						match = item["year"].Get<int>() >= 2010 && item["year"].Get<int>() <= 2020;
+						break;
+					case 1:
+						match = item["name"].As<string>() == q.entries[0].values[0].As<string>();
+						break;
+					default:
+						match = item["genre"].Get<int>() == q.entries[0].values[0].As<int>();
+				}
+				if (!match) errors++;
+			}
+		}
+	};
+
+	std::vector<std::thread> readers;
+	for (int n = 0; n < 3; n++) readers.emplace_back(reader, n);
+	for (int i = 0; i < 2000; i++) upsertItem(rand() % itemsCount);
+	done = true;
+	for (auto &th : readers) th.join();
+
+	ASSERT_EQ(errors.load(), 0);
+}
+
+TEST_F(NsApi, SelectSetOfLowCardinalityKeys) {
+	CreateNamespace(default_namespace);
+
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"genre", "hash", "int", IndexOpts()}});
+
+	const int itemsCount = 3000;
+	std::map<int, int> genres;
+	for (int i = 0; i < itemsCount; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["year"] = 2000 + rand() % 50;
+		item["genre"] = genres[i] = rand() % 20;
+		Upsert(default_namespace, item);
+	}
+
+	const std::vector<int> keys = {1, 3, 4, 7, 8, 11, 15, 19};
+	int expected = 0;
+	for (auto &g : genres) expected += std::count(keys.begin(), keys.end(), g.second);
+
+	// Unlimited select and select with total count are iterating merged union of idsets
+	for (auto q : {Query(default_namespace), Query(default_namespace).Sort("year", false),
+				   Query(default_namespace, 0, 10, ModeAccurateTotal)}) {
+		q.Where("genre", CondSet, keys);
+		QueryResults qr;
+		auto err = reindexer->Select(q, qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+
+		std::set<int> ids;
+		int prevYear = 0;
+		for (auto it : qr) {
+			Item item = it.GetItem();
+			int id = item["id"].Get<int>();
+			ASSERT_TRUE(std::count(keys.begin(), keys.end(), genres[id])) << id;
+			ASSERT_TRUE(ids.insert(id).second) << id;
+			if (!q.sortBy.empty()) {
+				ASSERT_GE(item["year"].Get<int>(), prevYear);
+				prevYear = item["year"].Get<int>();
+			}
+		}
+		if (q.count == UINT_MAX) {
+			ASSERT_EQ(int(qr.Count()), expected);
+		} else {
+			ASSERT_EQ(qr.totalCount, expected);
+		}
+	}
+}
+
+TEST_F(NsApi, ParallelScanWithComparators) {
+	auto err = reindexer->InitSystemNamespaces();
+	ASSERT_TRUE(err.ok()) << err.what();
+	Item cfg = NewItem("#config");
+	err = cfg.FromJSON(R"json({"type":"select","select":{"parallelism":4,"parallel_scan_threshold":1000}})json");
+	ASSERT_TRUE(err.ok()) << err.what();
+	Upsert("#config", cfg);
+
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"value", "-", "int", IndexOpts()}});
+	for (int i = 0; i < 20000; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["year"] = 2000 + rand() % 50;
+		item["value"] = rand() % 1000;
+		Upsert(default_namespace, item);
+	}
+	// Create some holes in items
+	for (int i = 0; i < 20000; i += 7) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		auto err = reindexer->Delete(default_namespace, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+
+	auto getIds = [&](const Query &q, QueryResults &qr) {
+		auto err = reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		vector<int> ids;
+		for (auto it : qr) ids.push_back(it.GetItem()["id"].Get<int>());
+		return ids;
+	};
+
+	// Result of parallel scan must be the same, as result of sequential scan
+	for (auto q : {Query(default_namespace).Where("value", CondLt, 300),
+				   Query(default_namespace).Where("value", CondGe, 100).Not().Where("value", CondSet, {150, 250, 350}),
+				   Query(default_namespace, 100, 50, ModeAccurateTotal).Where("value", CondRange, {200, 400}),
+				   Query(default_namespace, 10, 20, ModeAccurateTotal).Where("value", CondGt, 500).Sort("year", true),
+				   Query(default_namespace).Where("value", CondLt, 500).Aggregate("value", AggSum).Aggregate("year", AggAvg)}) {
+		QueryResults qrParallel, qrSeq;
+		auto parallelIds = getIds(q, qrParallel);
+		auto seqIds = getIds(Query(q).Parallel(1), qrSeq);
+		ASSERT_EQ(parallelIds, seqIds);
+		ASSERT_EQ(qrParallel.totalCount, qrSeq.totalCount);
+		ASSERT_EQ(qrParallel.aggregationResults.size(), qrSeq.aggregationResults.size());
+		for (size_t i = 0; i < qrSeq.aggregationResults.size(); i++) {
+			ASSERT_DOUBLE_EQ(qrParallel.aggregationResults[i].value, qrSeq.aggregationResults[i].value);
+		}
+	}
+}
+
+TEST_F(NsApi, ScanColumnIndexesConditions) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"int_col", "-", "int", IndexOpts()},
+											   IndexDeclaration{"int64_col", "-", "int64", IndexOpts()},
+											   IndexDeclaration{"double_col", "-", "double", IndexOpts()}});
+
+	const int itemsCount = 1003;
+	vector<std::tuple<int, int64_t, double>> values(itemsCount);
+	for (int i = 0; i < itemsCount; i++) {
+		values[i] = std::make_tuple(rand() % 100 - 50, int64_t(rand() % 100 - 50) << 33, double(rand() % 100 - 50) / 4);
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["int_col"] = std::get<0>(values[i]);
+		item["int64_col"] = std::get<1>(values[i]);
+		item["double_col"] = std::get<2>(values[i]);
+		Upsert(default_namespace, item);
+	}
+
+	auto match = [](CondType cond, double v, double rhs1, double rhs2) {
+		switch (cond) {
+			case CondEq:
+				return v == rhs1;
+			case CondLt:
+				return v < rhs1;
+			case CondLe:
+				return v <= rhs1;
+			case CondGt:
+				return v > rhs1;
+			case CondGe:
+				return v >= rhs1;
+			default:
+				return v >= rhs1 && v <= rhs2;
+		}
+	};
+
+	// Scan of column indexes is done by blocks of rows, result must be the same, as result of row by row comparison
+	for (auto cond : {CondEq, CondLt, CondLe, CondGt, CondGe, CondRange}) {
+		for (int rhs : {-10, 0, 7}) {
+			int rhs2 = rhs + 13;
+			QueryResults qrInt, qrInt64, qrDouble;
+			auto err = reindexer->Select(Query(default_namespace).Where("int_col", cond, {rhs, rhs2}), qrInt);
+			ASSERT_TRUE(err.ok()) << err.what();
+			err = reindexer->Select(Query(default_namespace).Where("int64_col", cond, {int64_t(rhs) << 33, int64_t(rhs2) << 33}), qrInt64);
+			ASSERT_TRUE(err.ok()) << err.what();
+			err = reindexer->Select(Query(default_namespace).Where("double_col", cond, {double(rhs) / 4, double(rhs2) / 4}), qrDouble);
+			ASSERT_TRUE(err.ok()) << err.what();
+
+			vector<int> expectInt, expectInt64, expectDouble, gotInt, gotInt64, gotDouble;
+			for (int i = 0; i < itemsCount; i++) {
+				if (match(cond, std::get<0>(values[i]), rhs, rhs2)) expectInt.push_back(i);
+				if (match(cond, std::get<1>(values[i]) >> 33, rhs, rhs2)) expectInt64.push_back(i);
+				if (match(cond, std::get<2>(values[i]) * 4, rhs, rhs2)) expectDouble.push_back(i);
+			}
+			for (auto it : qrInt) gotInt.push_back(it.GetItem()["id"].Get<int>());
+			for (auto it : qrInt64) gotInt64.push_back(it.GetItem()["id"].Get<int>());
+			for (auto it : qrDouble) gotDouble.push_back(it.GetItem()["id"].Get<int>());
+			ASSERT_EQ(gotInt, expectInt) << cond << " " << rhs;
+			ASSERT_EQ(gotInt64, expectInt64) << cond << " " << rhs;
+			ASSERT_EQ(gotDouble, expectDouble) << cond << " " << rhs;
+		}
+	}
+}
+
+TEST_F(NsApi, SelectSetOfManyKeys) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"price", "tree", "int", IndexOpts()}});
+
+	const int itemsCount = 5000;
+	std::map<int, std::pair<int, int>> items;
+	for (int i = 0; i < itemsCount; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["year"] = items[i].first = 2000 + rand() % 50;
+		item["price"] = items[i].second = rand() % 2000;
+		Upsert(default_namespace, item);
+	}
+
+
+	// Union of hundreds of idsets is iterated by heap in both directions, and intersected with other condition
+	for (auto q : {Query(default_namespace, 0, 100), Query(default_namespace, 0, 50).Sort("year", true),
+				   Query(default_namespace, 0, 50).Sort("year", false).Where("year", CondGe, 2030),
+				   Query(default_namespace, 0, 50, ModeAccurateTotal).Sort("year", true)}) {
+		// Different keys in each query, otherwise idsets of keys are taken merged from cache
+		std::vector<int> keys;
+		for (int i = 0; i < 200; i++) keys.push_back(rand() % 2000);
+		q.Where("price", CondSet, keys);
+		bool byYear = q.entries.size() > 1;
+		int expected = 0;
+		for (auto &it : items) {
+			if (std::count(keys.begin(), keys.end(), it.second.second) && (!byYear || it.second.first >= 2030)) expected++;
+		}
+
+		QueryResults qr;
+		auto err = reindexer->Select(q, qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+
+		std::set<int> ids;
+		int prevYear = 0;
+		for (auto it : qr) {
+			Item item = it.GetItem();
+			int id = item["id"].Get<int>();
+			ASSERT_TRUE(std::count(keys.begin(), keys.end(), items[id].second)) << id;
+			ASSERT_TRUE(!byYear || items[id].first >= 2030) << id;
+			ASSERT_TRUE(ids.insert(id).second) << id;
+			if (!q.sortBy.empty()) {
+				if (prevYear) {
+					if (q.sortDirDesc) {
+						ASSERT_LE(items[id].first, prevYear);
+					} else {
+						ASSERT_GE(items[id].first, prevYear);
+					}
+				}
+				prevYear = items[id].first;
+			}
+		}
+		ASSERT_EQ(int(qr.Count()), std::min(expected, int(q.count)));
+		if (q.calcTotal == ModeAccurateTotal) {
+			ASSERT_EQ(qr.totalCount, expected);
+		}
+	}
+}
+
+TEST_F(NsApi, CachedTotalAfterUpdates) {
+	auto err = reindexer->InitSystemNamespaces();
+	ASSERT_TRUE(err.ok()) << err.what();
+
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"genre", "hash", "int", IndexOpts()}});
+
+	auto upsert = [&](int id, int year, int genre) {
+		Item item = NewItem(default_namespace);
+		item["id"] = id;
+		item["year"] = year;
+		item["genre"] = genre;
+		Upsert(default_namespace, item);
+	};
+	for (int i = 0; i < 100; i++) upsert(i, 2000 + i % 20, i % 10);
+
+	auto checkTotal = [&](int expected) {
+		for (int i = 0; i < 3; i++) {
+			QueryResults qr;
+			auto err = reindexer->Select(Query(default_namespace, 0, 1, ModeCachedTotal).Where("genre", CondEq, 3), qr);
+			ASSERT_TRUE(err.ok()) << err.what();
+			ASSERT_EQ(qr.totalCount, expected);
+		}
+	};
+	auto queryCacheItems = [&]() {
+		QueryResults qr;
+		auto err = reindexer->Select(Query("#memstats").Where("name", CondEq, default_namespace), qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), 1);
+		string json = qr.begin().GetItem().GetJSON().ToString();
+		auto pos = json.find("\"items_count\":", json.find("\"query_cache\":"));
+		return pos == string::npos ? -1 : atoi(json.c_str() + pos + strlen("\"items_count\":"));
+	};
+
+	checkTotal(10);
+	ASSERT_EQ(queryCacheItems(), 1);
+
+	// Update of index, which is not used by query, keeps cached total
+	upsert(3, 2030, 3);
+	checkTotal(10);
+	ASSERT_EQ(queryCacheItems(), 1);
+
+	// Update of index from query, insert and delete are changing cached total
+	upsert(13, 2013, 4);
+	checkTotal(9);
+	upsert(100, 2000, 3);
+	checkTotal(10);
+	Item item = NewItem(default_namespace);
+	item["id"] = 23;
+	err = reindexer->Delete(default_namespace, item);
+	ASSERT_TRUE(err.ok()) << err.what();
+	checkTotal(9);
+}
+
+TEST_F(NsApi, ModifyItemsBatch) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace,
+						   {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()}, IndexDeclaration{"year", "tree", "int", IndexOpts()}});
+
+	auto makeItems = [&](int from, int to, int year) {
+		vector<Item> items;
+		for (int i = from; i < to; i++) {
+			items.push_back(NewItem(default_namespace));
+			auto err = items.back().FromJSON("{\"id\":" + std::to_string(i) + ",\"year\":" + std::to_string(year) + ",\"tag" +
+											 std::to_string(i % 5) + "\":\"val\"}");
+			EXPECT_TRUE(err.ok()) << err.what();
+		}
+		return items;
+	};
+	auto count = [&](const Query &q) {
+		QueryResults qr;
+		auto err = reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		return qr.Count();
+	};
+
+	auto items = makeItems(0, 100, 2000);
+	auto err = reindexer->ModifyItems(default_namespace, items, ModeUpsert);
+	ASSERT_TRUE(err.ok()) << err.what();
+	for (auto &item : items) ASSERT_NE(item.GetID(), -1);
+	ASSERT_EQ(count(Query(default_namespace)), 100);
+
+	// Update of existing and unexisting items
+	items = makeItems(50, 150, 2010);
+	err = reindexer->ModifyItems(default_namespace, items, ModeUpdate);
+	ASSERT_TRUE(err.ok()) << err.what();
+	for (size_t i = 0; i < items.size(); i++) ASSERT_EQ(items[i].GetID() != -1, i < 50);
+	ASSERT_EQ(count(Query(default_namespace).Where("year", CondEq, 2010)), 50);
+	ASSERT_EQ(count(Query(default_namespace)), 100);
+
+	// Insert does not replace existing items
+	items = makeItems(90, 110, 2020);
+	err = reindexer->ModifyItems(default_namespace, items, ModeInsert);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(count(Query(default_namespace).Where("year", CondEq, 2020)), 10);
+	ASSERT_EQ(count(Query(default_namespace)), 110);
+
+	items = makeItems(0, 30, 0);
+	err = reindexer->ModifyItems(default_namespace, items, ModeDelete);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(count(Query(default_namespace)), 80);
+
+	// Non indexed fields of all items are restored with namespace's tags
+	QueryResults qr;
+	err = reindexer->Select(Query(default_namespace).Where("id", CondEq, 34), qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr.Count(), 1);
+	ASSERT_EQ(qr.begin().GetItem().GetJSON().ToString(), "{\"id\":34,\"year\":2000,\"tag4\":\"val\"}");
+}
+
+TEST_F(NsApi, SelectStreamed) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"genre", "hash", "int", IndexOpts()}});
+	const int kItemsCount = 5 * reindexer::kStreamResultsBatchSize;
+	for (int i = 0; i < kItemsCount; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["year"] = 2000 + i % 50;
+		item["genre"] = i % 3;
+		Upsert(default_namespace, item);
+	}
+
+	struct StreamResult {
+		vector<int> ids;
+		int batches = 0;
+		size_t maxBatchSize = 0;
+		int totalCount = 0;
+	};
+	auto selectStreamed = [&](const Query &q) {
+		StreamResult res;
+		auto err = reindexer->Select(q, [&](QueryResults &batch, bool isLast) {
+			res.maxBatchSize = std::max(res.maxBatchSize, batch.Count());
+			for (auto it : batch) res.ids.push_back(it.GetItem()["id"].As<int>());
+			res.batches++;
+			if (isLast) res.totalCount = batch.totalCount;
+			return Error();
+		});
+		EXPECT_TRUE(err.ok()) << err.what();
+		return res;
+	};
+	auto selectIds = [&](const Query &q) {
+		QueryResults qr;
+		auto err = reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		vector<int> ids;
+		for (auto it : qr) ids.push_back(it.GetItem()["id"].As<int>());
+		return ids;
+	};
+
+	Query q = Query(default_namespace).Where("genre", CondEq, 1).Where("year", CondGe, 2010);
+	q.calcTotal = ModeAccurateTotal;
+	auto res = selectStreamed(q);
+	ASSERT_GT(res.batches, 1);
+	ASSERT_LE(res.maxBatchSize, size_t(reindexer::kStreamResultsBatchSize));
+	ASSERT_EQ(res.ids, selectIds(q));
+	ASSERT_EQ(res.totalCount, int(res.ids.size()));
+
+	// Order of tree index is kept by stream
+	q = Query(default_namespace).Sort("year", true).Limit(3000).Offset(100);
+	res = selectStreamed(q);
+	ASSERT_GT(res.batches, 1);
+	ASSERT_LE(res.maxBatchSize, size_t(reindexer::kStreamResultsBatchSize));
+	ASSERT_EQ(res.ids.size(), 3000);
+	ASSERT_EQ(res.ids, selectIds(q));
+
+	// Results, sorted by hash index, are passed by single batch
+	q = Query(default_namespace).Sort("genre", false);
+	res = selectStreamed(q);
+	ASSERT_EQ(res.batches, 1);
+	ASSERT_EQ(res.ids.size(), kItemsCount);
+
+	// Error of consumer stops stream
+	int batches = 0;
+	auto err = reindexer->Select(Query(default_namespace), [&](QueryResults &, bool) {
+		batches++;
+		return Error(errLogic, "Stop");
+	});
+	ASSERT_EQ(err.code(), errLogic);
+	ASSERT_EQ(batches, 1);
+}
+
+TEST_F(NsApi, AggregationsByIndexes) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"genre", "hash", "int", IndexOpts()},
+											   IndexDeclaration{"name", "hash", "string", IndexOpts()},
+											   IndexDeclaration{"rate", "-", "double", IndexOpts()}});
+	const int kItemsCount = 3000;
+	for (int i = 0; i < kItemsCount; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["year"] = 1900 + (i * 7) % 113;
+		item["genre"] = i % 17;
+		item["name"] = "name" + std::to_string(i % 5);
+		item["rate"] = double(i % 101) / 4;
+		Upsert(default_namespace, item);
+	}
+
+	// Whole namespace and large share of items are aggregated by keys of indexes, small share - by payloads of items
+	for (auto q : {Query(default_namespace), Query(default_namespace).Where("id", CondGe, 1000).Where("genre", CondLt, 9),
+				   Query(default_namespace).Where("year", CondLt, 1920)}) {
+		// Expected results are calculated from items of the same query
+		QueryResults checkQr;
+		auto err = reindexer->Select(q, checkQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_GT(checkQr.Count(), 0);
+		std::map<int, int> genres;
+		std::map<string, int> names;
+		int minYear = INT_MAX, maxYear = INT_MIN;
+		double minRate = 1e9, maxRate = -1e9;
+		for (auto it : checkQr) {
+			Item item(it.GetItem());
+			int year = item["year"].As<int>();
+			double rate = item["rate"].As<double>();
+			genres[item["genre"].As<int>()]++;
+			names[item["name"].As<string>()]++;
+			minYear = std::min(minYear, year), maxYear = std::max(maxYear, year);
+			minRate = std::min(minRate, rate), maxRate = std::max(maxRate, rate);
+		}
+
+		QueryResults qr;
+		err = reindexer->Select(Query(q)
+									.Aggregate("genre", AggFacet, 3)
+									.Aggregate("name", AggFacet)
+									.Aggregate("year", AggMin)
+									.Aggregate("year", AggMax)
+									.Aggregate("rate", AggMin)
+									.Aggregate("rate", AggMax)
+									.Aggregate("genre", AggCountDistinct),
+								qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.aggregationResults.size(), 7);
+
+		// Facets are sorted by count in descending order, then by value
+		vector<std::pair<int, string>> expectedGenres;
+		for (auto &g : genres) expectedGenres.push_back({-g.second, std::to_string(g.first)});
+		std::sort(expectedGenres.begin(), expectedGenres.end());
+		auto &genreFacets = qr.aggregationResults[0].facets;
+		ASSERT_EQ(genreFacets.size(), 3);
+		for (size_t i = 0; i < genreFacets.size(); i++) {
+			EXPECT_EQ(genreFacets[i].value, expectedGenres[i].second);
+			EXPECT_EQ(genreFacets[i].count, -expectedGenres[i].first);
+		}
+		auto &nameFacets = qr.aggregationResults[1].facets;
+		ASSERT_EQ(nameFacets.size(), names.size());
+		for (auto &f : nameFacets) EXPECT_EQ(f.count, names[f.value]) << f.value;
+
+		EXPECT_DOUBLE_EQ(qr.aggregationResults[2].value, minYear);
+		EXPECT_DOUBLE_EQ(qr.aggregationResults[3].value, maxYear);
+		EXPECT_DOUBLE_EQ(qr.aggregationResults[4].value, minRate);
+		EXPECT_DOUBLE_EQ(qr.aggregationResults[5].value, maxRate);
+		EXPECT_DOUBLE_EQ(qr.aggregationResults[6].value, genres.size());
+	}
+
+	// Aggregations of SQL query
+	QueryResults qr;
+	auto err = reindexer->Select("SELECT FACET(name LIMIT 2), MAX(year), COUNT(DISTINCT genre) FROM " + default_namespace +
+									 " WHERE genre = 3",
+								 qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr.aggregationResults.size(), 3);
+	EXPECT_EQ(qr.aggregationResults[0].facets.size(), 2);
+	EXPECT_DOUBLE_EQ(qr.aggregationResults[2].value, 1);
+
+	// Sum of composite or string index is not allowed
+	err = reindexer->Select(Query(default_namespace).Aggregate("name", AggSum), qr);
+	EXPECT_FALSE(err.ok());
+}
+
+TEST_F(NsApi, QueryPlanExplain) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"year", "tree", "int", IndexOpts()},
+											   IndexDeclaration{"genre", "hash", "int", IndexOpts()},
+											   IndexDeclaration{"name", "hash", "string", IndexOpts()}});
+	const int kItemsCount = 3000;
+	for (int i = 0; i < kItemsCount; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["year"] = 1900 + (i * 7) % 113;
+		item["genre"] = i % 17;
+		item["name"] = "name" + std::to_string(i % 5);
+		Upsert(default_namespace, item);
+	}
+
+	auto selectIds = [&](const Query &q, QueryResults &qr) {
+		auto err = reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		std::set<int> ids;
+		for (auto it : qr) ids.insert(Item(it.GetItem())["id"].As<int>());
+		return ids;
+	};
+	struct ExplainedCondition {
+		string condition, method;
+		double estimated;
+		bool driver;
+	};
+
+	// Items of genre are much less, than items of set of names, so names are checked by comparator
+	Query q = Query(default_namespace).Where("genre", CondEq, 3).Where("name", CondSet, {"name0", "name1", "name2"});
+	QueryResults checkQr, qr;
+	auto expectedIds = selectIds(q, checkQr);
+	EXPECT_TRUE(checkQr.explainResults.empty());
+	ASSERT_GT(expectedIds.size(), 0);
+	EXPECT_EQ(selectIds(Query(q).Explain(), qr), expectedIds);
+	ASSERT_FALSE(qr.explainResults.empty());
+
+	string json = qr.explainResults;
+	char *endptr = nullptr;
+	JsonValue root;
+	JsonAllocator allocator;
+	ASSERT_EQ(jsonParse(&json[0], &endptr, &root, allocator), JSON_OK) << qr.explainResults;
+	vector<ExplainedCondition> conditions;
+	int selectors = -1;
+	string sortIndex = "-";
+	for (auto field : root) {
+		string name = field->key;
+		if (name == "sort_index") {
+			sortIndex = field->value.toString();
+		} else if (name == "selectors") {
+			selectors = 0;
+			for (auto s : field->value) (void)s, selectors++;
+		} else if (name == "conditions") {
+			for (auto c : field->value) {
+				ExplainedCondition cond;
+				for (auto v : c->value) {
+					string key = v->key;
+					if (key == "condition") cond.condition = v->value.toString();
+					if (key == "method") cond.method = v->value.toString();
+					if (key == "estimated") cond.estimated = v->value.toNumber();
+					if (key == "driver") cond.driver = v->value.getTag() == JSON_TRUE;
+				}
+				conditions.push_back(cond);
+			}
+		}
+	}
+	EXPECT_EQ(sortIndex, "");
+	EXPECT_GT(selectors, 0);
+	ASSERT_EQ(conditions.size(), 2) << qr.explainResults;
+	EXPECT_NE(conditions[0].condition.find("genre"), string::npos);
+	EXPECT_TRUE(conditions[0].driver);
+	EXPECT_EQ(conditions[0].method, "index");
+	EXPECT_NEAR(conditions[0].estimated, kItemsCount / 17, 2);
+	EXPECT_FALSE(conditions[1].driver);
+	EXPECT_EQ(conditions[1].method, "comparator");
+	EXPECT_NEAR(conditions[1].estimated, kItemsCount * 3 / 5, kItemsCount / 20);
+
+	// Range of tree index is iterated by sort orders
+	QueryResults rangeCheckQr, rangeQr;
+	q = Query(default_namespace).Where("year", CondGe, 2010).Where("genre", CondSet, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+	expectedIds = selectIds(q, rangeCheckQr);
+	EXPECT_EQ(selectIds(Query(q).Explain(), rangeQr), expectedIds);
+	EXPECT_NE(rangeQr.explainResults.find("\"sort_index\":\"year\""), string::npos) << rangeQr.explainResults;
+	EXPECT_NE(rangeQr.explainResults.find("\"method\":\"comparator\",\"driver\":false"), string::npos) << rangeQr.explainResults;
+
+	// Explained SQL query
+	QueryResults sqlQr;
+	auto err = reindexer->Select("EXPLAIN SELECT * FROM " + default_namespace + " WHERE genre = 3", sqlQr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	EXPECT_EQ(sqlQr.Count(), kItemsCount / 17 + 1);
+	EXPECT_NE(sqlQr.explainResults.find("\"driver\":true"), string::npos) << sqlQr.explainResults;
+}
+
+TEST_F(NsApi, SortByUnorderedIndexWithLimit) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"rate", "-", "double", IndexOpts()},
+											   IndexDeclaration{"name", "hash", "string", IndexOpts().SetCollateMode(CollateASCII)},
+											   IndexDeclaration{"code", "hash", "string", IndexOpts()}});
+	const int kItemsCount = 2000;
+	for (int i = 0; i < kItemsCount; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["rate"] = double((i * 37) % 211 - 100) / 8;
+		// Names have common prefixes longer than normalized prefix, and differ by case
+		item["name"] = string(i % 2 ? "Common_prefix_" : "common_PREFIX_") + std::to_string((i * 13) % 97);
+		item["code"] = std::to_string((i * 7) % 1000) + (i % 3 ? "\xD0\xAF" : "z");
+		Upsert(default_namespace, item);
+	}
+
+	auto sortValues = [&](const Query &q, const string &field, QueryResults &qr) {
+		auto err = reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		vector<string> values;
+		for (auto it : qr) {
+			string value = Item(it.GetItem())[field].As<string>();
+			if (field == "name") std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+			values.push_back(value);
+		}
+		return values;
+	};
+
+	for (const char *field : {"rate", "name", "code", "id"}) {
+		for (bool desc : {false, true}) {
+			// Query without limit is sorted after materialization of all matched items
+			Query q = Query(default_namespace).Where("id", CondGe, 100).Sort(field, desc);
+			QueryResults allQr;
+			auto all = sortValues(q, field, allQr);
+			ASSERT_EQ(all.size(), kItemsCount - 100);
+
+			QueryResults qr;
+			auto top = sortValues(Query(q).Limit(20).Offset(15).ReqTotal(), field, qr);
+			ASSERT_EQ(top.size(), 20);
+			EXPECT_EQ(qr.totalCount, kItemsCount - 100);
+			EXPECT_TRUE(std::equal(top.begin(), top.end(), all.begin() + 15)) << field << (desc ? " desc" : "");
+		}
+	}
+}
+
+TEST_F(NsApi, HashIndexesUpdatesAndDeletes) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()},
+											   IndexDeclaration{"code", "hash", "int64", IndexOpts()},
+											   IndexDeclaration{"name", "hash", "string", IndexOpts().SetCollateMode(CollateASCII)}});
+	const int kItemsCount = 5000;
+	// Expected values of fields by id
+	std::map<int, std::pair<int64_t, string>> items;
+	auto upsert = [&](int id, int64_t code, const string &name) {
+		Item item = NewItem(default_namespace);
+		item["id"] = id;
+		item["code"] = code;
+		item["name"] = name;
+		Upsert(default_namespace, item);
+		items[id] = {code, name};
+	};
+	for (int i = 0; i < kItemsCount; i++) upsert(i, (int64_t(i % 700) << 32) + 1, (i % 2 ? "Name_" : "NAME_") + std::to_string(i % 900));
+	auto err = Commit(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+
+	// Deletes leave keys without ids, which are erased from index maps, and updates move ids to new keys
+	for (int i = 0; i < kItemsCount; i += 3) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		err = reindexer->Delete(default_namespace, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+		items.erase(i);
+	}
+	for (int i = 1; i < kItemsCount; i += 3) upsert(i, int64_t(i % 1300) - 650, "name_" + std::to_string(i % 1100));
+	for (int i = kItemsCount; i < kItemsCount + 1000; i++) upsert(i, int64_t(i), "upd_" + std::to_string(i % 10));
+	err = Commit(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+
+	std::map<int64_t, int> codes;
+	std::map<string, int> names;
+	for (auto &it : items) {
+		codes[it.second.first]++;
+		string name = it.second.second;
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+		names[name]++;
+	}
+
+	for (auto &code : codes) {
+		QueryResults qr;
+		err = reindexer->Select(Query(default_namespace).Where("code", CondEq, code.first), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.Count(), code.second) << code.first;
+	}
+	for (auto &name : names) {
+		QueryResults qr;
+		err = reindexer->Select(Query(default_namespace).Where("name", CondEq, name.first), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.Count(), name.second) << name.first;
+	}
+
+	// Items are sorted by values of hash index after selection
+	QueryResults qr;
+	err = reindexer->Select(Query(default_namespace).Sort("code", false), qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr.Count(), items.size());
+	int64_t prevCode = std::numeric_limits<int64_t>::min();
+	for (auto it : qr) {
+		Item item(it.GetItem());
+		int64_t code = item["code"].As<int64_t>();
+		EXPECT_LE(prevCode, code);
+		EXPECT_EQ(items[item["id"].As<int>()].first, code);
+		prevCode = code;
+	}
+}
+
+TEST_F(NsApi, PerfStatsLatencyPercentiles) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace,
+						   {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()}, IndexDeclaration{"value", "tree", "int", IndexOpts()}});
+
+	auto err = reindexer->InitSystemNamespaces();
+	ASSERT_TRUE(err.ok()) << err.what();
+	Item config = NewItem("#config");
+	err = config.FromJSON(
+		R"json({"type":"profiling","profiling":{"perfstats":true,"queriesperfstats":true,"queries_threshold_us":0,"memstats":true}})json");
+	ASSERT_TRUE(err.ok()) << err.what();
+	Upsert("#config", config);
+
+	for (int i = 0; i < 1000; i++) {
+		Item item = NewItem(default_namespace);
+		item["id"] = i;
+		item["value"] = i % 100;
+		Upsert(default_namespace, item);
+	}
+	const int kSelectsCount = 200;
+	for (int i = 0; i < kSelectsCount; i++) {
+		QueryResults qr;
+		err = reindexer->Select(Query(default_namespace).Where("value", CondLt, i % 100), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+
+	// Returns object by path of keys in JSON of the first item of results
+	auto getStat = [&](const Query &q, const vector<string> &path, string &json, JsonAllocator &allocator) {
+		QueryResults qr;
+		err = reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		EXPECT_GT(qr.Count(), 0);
+		JsonValue node;
+		if (!qr.Count()) return node;
+		json = qr.begin().GetItem().GetJSON().ToString();
+		char *endptr = nullptr;
+		EXPECT_EQ(jsonParse(&json[0], &endptr, &node, allocator), JSON_OK) << json;
+		for (auto &key : path) {
+			JsonValue next;
+			for (auto field : node) {
+				if (key == field->key) next = field->value;
+			}
+			node = next;
+		}
+		return node;
+	};
+	auto checkLatency = [](const JsonValue &latency) {
+		std::map<string, double> values;
+		for (auto field : latency) values[field->key] = field->value.toNumber();
+		ASSERT_EQ(values.size(), 5);
+		EXPECT_LE(values["p50_us"], values["p90_us"]);
+		EXPECT_LE(values["p90_us"], values["p99_us"]);
+		EXPECT_LE(values["p99_us"], values["p999_us"]);
+		EXPECT_LE(values["p999_us"], values["max_us"]);
+	};
+
+	string json;
+	JsonAllocator allocator;
+	Query nsStat = Query("#perfstats").Where("name", CondEq, default_namespace);
+	auto selects = getStat(nsStat, {"selects"}, json, allocator);
+	ASSERT_EQ(selects.getTag(), JSON_OBJECT) << json;
+	for (auto field : selects) {
+		string key = field->key;
+		if (key == "total_queries_count") {
+			EXPECT_GE(field->value.toNumber(), kSelectsCount);
+		}
+		if (key == "latency" || key == "lock_time") checkLatency(field->value);
+	}
+	checkLatency(getStat(nsStat, {"updates", "latency"}, json, allocator));
+	for (const char *phase : {"prepare", "indexes", "postprocess", "loop"}) {
+		checkLatency(getStat(nsStat, {"select_phases", phase}, json, allocator));
+	}
+
+	checkLatency(getStat(Query("#queriesperfstats"), {"latency"}, json, allocator));
+}
+
+TEST_F(NsApi, TuplesCompression) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()}});
+
+	auto err = reindexer->InitSystemNamespaces();
+	ASSERT_TRUE(err.ok()) << err.what();
+
+	const vector<string> brands = {"Brand of apples", "Brand of pears", "Brand of plums"};
+	const vector<string> currencies = {"dollars", "rubles"};
+	auto itemJson = [&](int id, const string &brand) {
+		return "{\"id\":" + std::to_string(id) + ",\"brand\":\"" + brand + "\",\"price\":{\"value\":" + std::to_string(id * 10) +
+			   ",\"currency\":\"" + currencies[id % currencies.size()] + "\"},\"tags\":[\"" + brand + "\",\"tag" + std::to_string(id) +
+			   "\"],\"description\":\"Item number " + std::to_string(id) + "\"}";
+	};
+	auto upsert = [&](int id, const string &brand) {
+		Item item = NewItem(default_namespace);
+		err = item.FromJSON(itemJson(id, brand));
+		ASSERT_TRUE(err.ok()) << err.what();
+		Upsert(default_namespace, item);
+	};
+	auto checkItems = [&](const vector<string> &expected) {
+		QueryResults qr;
+		err = reindexer->Select(Query(default_namespace).Sort("id", false), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.Count(), expected.size());
+		size_t i = 0;
+		for (auto it : qr) {
+			Item item = it.GetItem();
+			EXPECT_EQ(item.GetJSON().ToString(), expected[i]);
+			// CJSON of item is expanded and can be decoded by other namespace's item
+			Item copy = NewItem(default_namespace);
+			err = copy.FromCJSON(item.GetCJSON());
+			ASSERT_TRUE(err.ok()) << err.what();
+			EXPECT_EQ(copy.GetJSON().ToString(), expected[i]);
+			i++;
+		}
+	};
+	auto checkCount = [&](const Query &q, size_t expected) {
+		QueryResults qr;
+		err = reindexer->Select(q, qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), expected);
+	};
+	auto tuplesStat = [&](const string &key) {
+		QueryResults qr;
+		err = reindexer->Select(Query("#memstats").Where("name", CondEq, default_namespace), qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), 1);
+		string json = qr.begin().GetItem().GetJSON().ToString();
+		auto pos = json.find("\"" + key + "\":", json.find("\"tuples\":"));
+		EXPECT_NE(pos, string::npos) << json;
+		return pos == string::npos ? string() : json.substr(pos + key.size() + 3, json.find_first_of(",}", pos) - pos - key.size() - 3);
+	};
+
+	const int kItemsCount = 300;
+	vector<string> expected;
+	// Items, which are inserted before compression is enabled, are compressed on enable
+	for (int i = 0; i < kItemsCount; i++) {
+		if (i == kItemsCount / 2) {
+			EXPECT_EQ(tuplesStat("compressed"), "false");
+			EXPECT_EQ(tuplesStat("dict_strings_count"), "0");
+			Item config = NewItem("#config");
+			err = config.FromJSON(R"json({"type":"namespaces","namespaces":[{"namespace":"*","compress_tuples":true}]})json");
+			ASSERT_TRUE(err.ok()) << err.what();
+			Upsert("#config", config);
+		}
+		upsert(i, brands[i % brands.size()]);
+		expected.push_back(itemJson(i, brands[i % brands.size()]));
+	}
+
+	EXPECT_EQ(tuplesStat("compressed"), "true");
+	// Brands and currencies are interned, unique descriptions are not
+	EXPECT_EQ(tuplesStat("dict_strings_count"), std::to_string(brands.size() + currencies.size()));
+	EXPECT_LT(stoll(tuplesStat("tuples_size")), stoll(tuplesStat("uncompressed_tuples_size")));
+	checkItems(expected);
+
+	// Conditions by non indexed fields are using strings from dictionary
+	checkCount(Query(default_namespace).Where("brand", CondEq, brands[1]), kItemsCount / brands.size());
+	checkCount(Query(default_namespace).Where("price.currency", CondEq, currencies[0]), kItemsCount / currencies.size());
+	checkCount(Query(default_namespace).Where("tags", CondSet, {KeyValue(brands[2]), KeyValue(string("tag1"))}), kItemsCount / brands.size() + 1);
+
+	// Updates and deletes of compressed items
+	upsert(0, "Brand of cherries");
+	expected[0] = itemJson(0, "Brand of cherries");
+	Item item = NewItem(default_namespace);
+	err = item.FromJSON(expected[1]);
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = reindexer->Delete(default_namespace, item);
+	ASSERT_TRUE(err.ok()) << err.what();
+	expected.erase(expected.begin() + 1);
+	checkItems(expected);
+
+	// Indexes can be added to compressed namespace
+	err = reindexer->AddIndex(default_namespace, {"brand", "brand", "hash", "string", IndexOpts()});
+	ASSERT_TRUE(err.ok()) << err.what();
+	checkItems(expected);
+	checkCount(Query(default_namespace).Where("brand", CondEq, brands[1]), kItemsCount / brands.size() - 1);
+}
+
+TEST_F(NsApi, UpdateQuery) {
+	CreateNamespace(default_namespace);
+	DefineNamespaceDataset(default_namespace,
+						   {IndexDeclaration{"id", "hash", "int", IndexOpts().PK()}, IndexDeclaration{"category", "hash", "string", IndexOpts()},
+							IndexDeclaration{"price", "tree", "double", IndexOpts()},
+							IndexDeclaration{"category+price", "tree", "composite", IndexOpts()}});
+
+	const int kItemsCount = 100;
+	const int kCategories = 4;
+	for (int i = 0; i < kItemsCount; i++) {
+		Item item = NewItem(default_namespace);
+		auto err = item.FromJSON("{\"id\":" + std::to_string(i) + ",\"category\":\"cat" + std::to_string(i % kCategories) +
+								 "\",\"price\":" + std::to_string(i) + ",\"name\":\"item" + std::to_string(i) + "\"}");
+		ASSERT_TRUE(err.ok()) << err.what();
+		Upsert(default_namespace, item);
+	}
+	auto checkCount = [&](const Query &q, size_t expected) {
+		QueryResults qr;
+		auto err = reindexer->Select(q, qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), expected);
+	};
+
+	// Update by SQL
+	QueryResults qr;
+	auto err = reindexer->Select("UPDATE " + default_namespace + " SET price = 10.5, category = 'sale' WHERE category = 'cat1' AND id < 50", qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	const size_t updatedCount = (50 + kCategories - 2) / kCategories;
+	ASSERT_EQ(qr.Count(), updatedCount);
+	// Results contain updated items. Not indexed fields are kept
+	for (auto it : qr) {
+		Item item = it.GetItem();
+		EXPECT_EQ(item["price"].As<double>(), 10.5);
+		EXPECT_EQ(item["category"].As<string>(), "sale");
+		EXPECT_NE(item.GetJSON().ToString().find("\"name\":\"item" + std::to_string(item["id"].As<int>()) + "\""), string::npos);
+	}
+
+	checkCount(Query(default_namespace).Where("category", CondEq, "sale"), updatedCount);
+	checkCount(Query(default_namespace).Where("category", CondEq, "cat1"), kItemsCount / kCategories - updatedCount);
+	checkCount(Query(default_namespace).Where("price", CondEq, 10.5), updatedCount);
+	checkCount(Query(default_namespace).WhereComposite("category+price", CondEq, {{KeyValue(string("sale")), KeyValue(10.5)}}),
+			   updatedCount);
+
+	// Update by Query. Value is converted to type of field
+	Query q = Query(default_namespace).Where("id", CondEq, 2).Set("price", 1000);
+	QueryResults qr2;
+	err = reindexer->Update(q, qr2);
+	ASSERT_TRUE(err.ok()) << err.what();
+	EXPECT_EQ(qr2.Count(), 1);
+	QueryResults qr3;
+	err = reindexer->Select(Query(default_namespace).Sort("price", true).Limit(1), qr3);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr3.Count(), 1);
+	EXPECT_EQ(qr3.begin().GetItem()["id"].As<int>(), 2);
+
+	// Updated field, which is missing in JSON of item, is added to its JSON and CJSON, so it's restored on load from storage
+	Item noPrice = NewItem(default_namespace);
+	err = noPrice.FromJSON("{\"id\":" + std::to_string(kItemsCount) + ",\"category\":\"cat0\"}");
+	ASSERT_TRUE(err.ok()) << err.what();
+	Upsert(default_namespace, noPrice);
+	QueryResults qr5;
+	err = reindexer->Update(Query(default_namespace).Where("id", CondEq, kItemsCount).Set("price", 7.5), qr5);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr5.Count(), 1);
+	Item updated = qr5.begin().GetItem();
+	EXPECT_NE(updated.GetJSON().ToString().find("\"price\":7.5"), string::npos) << updated.GetJSON().ToString();
+	Item restored = NewItem(default_namespace);
+	err = restored.FromCJSON(updated.GetCJSON());
+	ASSERT_TRUE(err.ok()) << err.what();
+	EXPECT_EQ(restored["price"].As<double>(), 7.5);
+	err = reindexer->Delete(default_namespace, noPrice);
+	ASSERT_TRUE(err.ok()) << err.what();
+
+	// Update query is serialized with set fields
+	reindexer::WrSerializer ser;
+	q.Serialize(ser);
+	reindexer::Serializer rdser(ser.Slice());
+	Query deserialized;
+	deserialized.Deserialize(rdser);
+	EXPECT_TRUE(deserialized == q);
+
+	// Only scalar not PK indexed fields can be updated
+	QueryResults qr4;
+	err = reindexer->Update(Query(default_namespace).Set("name", "new"), qr4);
+	EXPECT_FALSE(err.ok());
+	err = reindexer->Update(Query(default_namespace).Set("id", 1), qr4);
+	EXPECT_FALSE(err.ok());
+	checkCount(Query(default_namespace).Where("price", CondEq, 10.5), updatedCount);
+}
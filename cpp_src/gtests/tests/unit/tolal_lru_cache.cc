@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include "core/query/query.h"
@@ -50,3 +52,44 @@ TEST(LruCache, SimpleTest) {
 		}
 	}
 }
+
+TEST(LruCache, ConcurrentAccessWithEviction) {
+	const int queriesCount = 500;
+	const int threadsCount = 8;
+	const size_t sizeLimit = 128 * 1024;
+
+	vector<Query> qs;
+	for (int i = 0; i < queriesCount; i++) qs.emplace_back(Query("namespace").Where("id", CondEq, i));
+
+	reindexer::LRUCache<QueryCacheKey, QueryCacheVal, reindexer::HashQueryCacheKey, EqQueryCacheKey> cache(sizeLimit);
+	std::atomic<int> hits(0);
+
+	// Cache is accessed from many threads, cached values must match their keys, and size of cache must not exceed limit
+	vector<std::thread> threads;
+	for (int t = 0; t < threadsCount; t++) {
+		threads.emplace_back([&, t]() {
+			for (int i = 0; i < 5000; i++) {
+				// Half of requests are made for small set of hot queries
+				int idx = (i % 2) ? (i + t) % 10 : rand() % queriesCount;
+				auto cached = cache.Get({qs[idx]});
+				if (!cached.key) continue;
+				if (cached.val.total_count >= 0) {
+					ASSERT_EQ(cached.val.total_count, idx);
+					hits++;
+				} else {
+					cache.Put({qs[idx]}, QueryCacheVal{size_t(idx)});
+				}
+			}
+		});
+	}
+	for (auto &th : threads) th.join();
+
+	auto stat = cache.GetMemStat();
+	ASSERT_LE(stat.totalSize, sizeLimit);
+	ASSERT_GT(stat.itemsCount, 0);
+	ASSERT_GT(hits.load(), 0);
+
+	cache.Invalidate();
+	ASSERT_TRUE(cache.Empty());
+	ASSERT_EQ(cache.GetMemStat().totalSize, 0);
+}
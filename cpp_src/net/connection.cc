@@ -80,6 +80,7 @@ void Connection<Mutex>::callback(ev::io & /*watcher*/, int revents) {
 	if (revents & ev::WRITE) {
 		canWrite_ = true;
 		write_cb();
+		if (sock_.valid()) onWrite();
 	}
 
 	wrBufLock_.lock();
@@ -26,6 +26,8 @@ public:
 protected:
 	virtual void onRead() = 0;
 	virtual void onClose() = 0;
+	// Socket is writable, and data of write buffer was sent to it
+	virtual void onWrite() {}
 
 	// Generic callback
 	void callback(ev::io &watcher, int revents);
@@ -10,12 +10,15 @@ namespace cproto {
 
 ClientConnection::ClientConnection(ev::dynamic_loop &loop) : ConnectionMT(-1, loop), state_(ConnInit) {}
 
-bool ClientConnection::Connect(string_view addr, string_view username, string_view password, string_view dbName) {
+bool ClientConnection::Connect(string_view addr, string_view username, string_view password, string_view dbName,
+								bool enableCompression) {
 	assert(!sock_.valid());
 	assert(wrBuf_.size() == 0);
 
 	std::unique_lock<mutex> lck(wrBufLock_);
 	state_ = ConnConnecting;
+	enableCompression_ = enableCompression;
+	compressionEnabled_ = false;
 	sock_.connect(addr.data());
 	if (!sock_.valid()) {
 		state_ = ConnFailed;
@@ -25,6 +28,9 @@ bool ClientConnection::Connect(string_view addr, string_view username, string_vi
 	io_.start(sock_.fd(), ev::READ | ev::WRITE);
 	async_.start();
 	Args args{Arg(p_string(&username)), Arg(p_string(&password)), Arg(p_string(&dbName))};
+	if (enableCompression_) {
+		args.push_back(Arg(p_string(kCprotoCompressionSnappy)));
+	}
 	callRPC(kCmdLogin, seq_, args);
 	return true;
 }
@@ -50,6 +56,10 @@ void ClientConnection::onRead() {
 			closeConn_ = true;
 			return;
 		}
+		if (hdr.len > kCprotoMaxFrameSize) {
+			closeConn_ = true;
+			return;
+		}
 
 		if (hdr.len + sizeof(hdr) > rdBuf_.capacity()) {
 			rdBuf_.reserve(hdr.len + sizeof(hdr) + 0x1000);
@@ -70,17 +80,29 @@ void ClientConnection::onRead() {
 		ans.cmd = CmdCode(hdr.cmd);
 		ans.seq = hdr.seq;
 
-		Serializer ser(it.data, hdr.len);
+		string_view data(it.data, hdr.len);
+		if (hdr.flags & kCprotoCompressedFlag) {
+			if (!UncompressFrame(data, uncompressed_)) {
+				closeConn_ = true;
+				return;
+			}
+			data = uncompressed_;
+		}
+
+		Serializer ser(data.data(), data.size());
 		int errCode = ser.GetVarUint();
 		string errMsg = ser.GetVString().ToString();
 		ans.ans.status_ = Error(errCode, errMsg);
-		assert(ser.Pos() <= hdr.len);
-		ans.ans.data_.assign(reinterpret_cast<uint8_t *>(it.data) + ser.Pos(), reinterpret_cast<uint8_t *>(it.data) + hdr.len);
+		assert(ser.Pos() <= data.size());
+		ans.ans.data_.assign(reinterpret_cast<const uint8_t *>(data.data()) + ser.Pos(),
+							 reinterpret_cast<const uint8_t *>(data.data()) + data.size());
 
 		wrBufLock_.lock();
 		if (ans.cmd == cproto::kCmdLogin) {
 			if (errCode == errOK) {
 				state_ = ConnConnected;
+				// Old servers do not set support flag, so frames to them are never compressed
+				compressionEnabled_ = enableCompression_ && (hdr.flags & kCprotoCompressionSupportFlag);
 			}
 		} else {
 			answers_.push_back(std::move(ans));
@@ -128,15 +150,22 @@ void ClientConnection::callRPC(CmdCode cmd, uint32_t seq, const Args &args) {
 
 	args.Pack(ser);
 
+	string_view data(reinterpret_cast<char *>(ser.Buf()), ser.Len());
+	std::string compressed;
 	CProtoHeader hdr;
-	hdr.len = ser.Len();
 	hdr.magic = kCprotoMagic;
 	hdr.version = kCprotoVersion;
+	hdr.flags = 0;
 	hdr.cmd = cmd;
 	hdr.seq = seq;
+	if (compressionEnabled_ && data.size() >= kCprotoMinCompressSize && CompressFrame(data, compressed)) {
+		data = compressed;
+		hdr.flags |= kCprotoCompressedFlag;
+	}
+	hdr.len = data.size();
 
 	wrBuf_.write(reinterpret_cast<char *>(&hdr), sizeof(hdr));
-	wrBuf_.write(reinterpret_cast<char *>(ser.Buf()), ser.Len());
+	wrBuf_.write(data.data(), data.size());
 }
 
 RPCAnswer ClientConnection::call(CmdCode cmd, const Args &args) {
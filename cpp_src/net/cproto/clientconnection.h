@@ -38,7 +38,9 @@ public:
 		return call(cmd, args, argss...);
 	}
 
-	bool Connect(string_view addr, string_view username, string_view password, string_view dbName);
+	/// Connects to server and sends login
+	/// @param enableCompression - request snappy compression at login. Frames are compressed only if server confirms support
+	bool Connect(string_view addr, string_view username, string_view password, string_view dbName, bool enableCompression = false);
 	// bool IsValid() { return sock_.valid(); }
 
 	bool IsValid() {
@@ -79,6 +81,11 @@ protected:
 
 	State state_;
 	vector<RPCRawAnswer> answers_;
+	bool enableCompression_ = false;
+	// Server has confirmed compression support in login responce. Guarded by wrBufLock_
+	bool compressionEnabled_ = false;
+	// Buffer for uncompressed payload of incoming frame
+	std::string uncompressed_;
 
 	std::atomic<uint32_t> seq_;
 	std::condition_variable answersCond_;
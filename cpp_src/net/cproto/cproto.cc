@@ -1,3 +1,4 @@
+#include <snappy.h>
 #include <unordered_map>
 
 #include "cproto.h"
@@ -20,6 +21,7 @@ std::unordered_map<int, const char *> kRPCCodes = {
 	{kCmdDropIndex, "DropIndex"},
 	{kCmdCommit, "Commit"},
 	{kCmdModifyItem, "ModifyItem"},
+	{kCmdModifyItems, "ModifyItems"},
 	{kCmdDeleteQuery, "DeleteQuery"},
 	{kCmdSelect, "Select"},
 	{kCmdSelectSQL, "SelectSQL"},
@@ -38,6 +40,22 @@ const char *CmdName(CmdCode cmd) {
 	return "Unknown";
 }
 
+bool CompressFrame(string_view data, std::string &out) {
+	out.clear();
+	snappy::Compress(data.data(), data.size(), &out);
+	return out.size() < data.size();
+}
+
+bool UncompressFrame(string_view data, std::string &out) {
+	out.clear();
+	size_t len = 0;
+	if (!snappy::GetUncompressedLength(data.data(), data.size(), &len) || len > kCprotoMaxFrameSize) {
+		return false;
+	}
+	out.resize(len);
+	return snappy::RawUncompress(data.data(), data.size(), &out[0]);
+}
+
 }  // namespace cproto
 }  // namespace net
 }  // namespace reindexer
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <string>
+#include "estl/string_view.h"
 
 namespace reindexer {
 namespace net {
@@ -22,6 +24,7 @@ enum CmdCode {
 	kCmdCommit = 32,
 	kCmdModifyItem = 33,
 	kCmdDeleteQuery = 34,
+	kCmdModifyItems = 35,
 
 	kCmdSelect = 48,
 	kCmdSelectSQL = 49,
@@ -41,18 +44,35 @@ const char *CmdName(CmdCode code);
 const uint32_t kMaxConcurentQueries = 256;
 
 const uint32_t kCprotoMagic = 0xEEDD1132;
-const uint32_t kCprotoVersion = 0x100;
+const uint16_t kCprotoVersion = 0x100;
+
+// Payload of frame is compressed by snappy. Peers send compressed frames only after compression is negotiated at login
+const uint16_t kCprotoCompressedFlag = 0x1;
+// Set by server in login responce, if client has requested compression and server supports it
+const uint16_t kCprotoCompressionSupportFlag = 0x2;
+// Client requests compression by passing this value as extra login argument. Old servers ignore extra arguments
+const char kCprotoCompressionSnappy[] = "snappy";
+// Frames (and uncompressed payloads) larger than this are treated as corrupted
+const uint32_t kCprotoMaxFrameSize = 0x10000000;
+// Payloads smaller than this are not worth to compress
+const uint32_t kCprotoMinCompressSize = 1024;
 
 #pragma pack(push, 1)
 struct CProtoHeader {
 	uint32_t magic;
-	uint32_t version;
+	uint16_t version;
+	uint16_t flags;
 	uint32_t len;
 	uint32_t cmd;
 	uint32_t seq;
 };
 #pragma pack(pop)
 
+// Compress payload of frame. Returns false, if compressed payload is not smaller than source
+bool CompressFrame(string_view data, std::string &out);
+// Uncompress payload of frame. Returns false, if compressed data is corrupted or uncompressed size exceeds kCprotoMaxFrameSize
+bool UncompressFrame(string_view data, std::string &out);
+
 }  // namespace cproto
 }  // namespace net
 }  // namespace reindexer
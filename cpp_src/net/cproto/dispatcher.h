@@ -46,6 +46,7 @@ struct Context {
 	RPCCall *call;
 	Writer *writer;
 	Stat stat;
+	bool respSent = false;
 };
 
 class ServerConnection;
@@ -55,7 +56,7 @@ class Dispatcher {
 	friend class ServerConnection;
 
 public:
-	Dispatcher() : handlers_(kCmdCodeMax, {nullptr, nullptr}) {}
+	Dispatcher() : handlers_(kCmdCodeMax, {nullptr, nullptr, false}) {}
 
 	/// Add handler for command.
 	/// @param cmd - Command code
@@ -69,16 +70,22 @@ public:
 							 int(ctx.call->args.size()));
 			return func_wrapper(obj, func, ctx);
 		};
-		handlers_[cmd] = {wrapper, object};
+		handlers_[cmd] = {wrapper, object, handlers_[cmd].concurrent_};
 	}
 
+	/// Allow concurrent execution of command.
+	/// Commands of one connection are executed one by one in order of arrival, but concurrent commands
+	/// may be executed in parallel with each other, if connection is served by worker pool
+	/// @param cmd - Command code
+	void Concurrent(CmdCode cmd) { handlers_[cmd].concurrent_ = true; }
+
 	/// Add middleware for commands
 	/// @param object - handler class object
 	/// @param func - handler
 	template <class K>
 	void Middleware(K *object, Error (K::*func)(Context &)) {
 		auto wrapper = [func](void *obj, Context &ctx) { return func_wrapper(obj, func, ctx); };
-		middlewares_.push_back({wrapper, object});
+		middlewares_.push_back({wrapper, object, false});
 	}
 
 	/// Set logger for commands
@@ -99,6 +106,7 @@ public:
 
 protected:
 	Error handle(Context &ctx);
+	bool isConcurrent(CmdCode cmd) const { return uint32_t(cmd) < uint32_t(handlers_.size()) && handlers_[cmd].concurrent_; }
 
 	template <class K>
 	static Error func_wrapper(void *obj, Error (K::*func)(Context &ctx), Context &ctx) {
@@ -130,6 +138,7 @@ protected:
 	struct Handler {
 		std::function<Error(void *obj, Context &ctx)> func_;
 		void *object_;
+		bool concurrent_;
 	};
 
 	std::vector<Handler> handlers_;
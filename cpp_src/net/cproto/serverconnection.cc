@@ -1,5 +1,3 @@
-
-
 #include "serverconnection.h"
 #include <errno.h>
 #include "tools/serializer.h"
@@ -10,15 +8,33 @@ namespace cproto {
 
 const auto kCProtoTimeoutSec = 300.;
 
-ServerConnection::ServerConnection(int fd, ev::dynamic_loop &loop, Dispatcher &dispatcher)
-	: net::ConnectionST(fd, loop), dispatcher_(dispatcher) {
+ServerConnection::ServerConnection(int fd, ev::dynamic_loop &loop, Dispatcher &dispatcher, WorkerPool *workers)
+	: net::ConnectionMT(fd, loop), dispatcher_(dispatcher), workers_(workers) {
+	if (workers_) async_.start();
 	timeout_.start(kCProtoTimeoutSec);
 	callback(io_, ev::READ);
 }
 
+ServerConnection::~ServerConnection() {
+	// Wait for calls, which are still executing by workers
+	std::unique_lock<std::mutex> lck(callsLock_);
+	calls_.clear();
+	closed_ = true;
+	callsCond_.wait(lck, [this]() { return !running_; });
+}
+
+bool ServerConnection::IsFinished() {
+	std::lock_guard<std::mutex> lck(callsLock_);
+	return !sock_.valid() && !running_;
+}
+
 bool ServerConnection::Restart(int fd) {
 	restart(fd);
-	respSent_ = false;
+	callsLock_.lock();
+	closed_ = false;
+	callsLock_.unlock();
+	enableCompression_ = false;
+	if (workers_) async_.start();
 	callback(io_, ev::READ);
 	timeout_.start(kCProtoTimeoutSec);
 	return true;
@@ -26,13 +42,32 @@ bool ServerConnection::Restart(int fd) {
 
 void ServerConnection::Attach(ev::dynamic_loop &loop) {
 	if (!attached_) {
+		std::lock_guard<std::mutex> lck(callsLock_);
 		attach(loop);
+		if (workers_ && sock_.valid()) {
+			async_.start();
+			// Responces of workers could be written, while connection was detached
+			async_.send();
+		}
 		timeout_.start(kCProtoTimeoutSec);
 	}
 }
 
 void ServerConnection::Detach() {
-	if (attached_) detach();
+	if (attached_) {
+		std::lock_guard<std::mutex> lck(callsLock_);
+		detach();
+	}
+}
+
+void ServerConnection::SetClientData(ClientData::Ptr data) {
+	std::lock_guard<std::mutex> lck(callsLock_);
+	clientData_ = data;
+}
+
+ClientData::Ptr ServerConnection::GetClientData() {
+	std::lock_guard<std::mutex> lck(callsLock_);
+	return clientData_;
 }
 
 void ServerConnection::onClose() {
@@ -45,17 +80,73 @@ void ServerConnection::onClose() {
 
 		dispatcher_.onClose_(ctx, errOK);
 	}
-	clientData_.reset();
+	std::lock_guard<std::mutex> lck(callsLock_);
+	calls_.clear();
+	closed_ = true;
+	// Client data is still used by running calls, it will be released by the last of them
+	if (!running_) clientData_.reset();
 }
 
 void ServerConnection::handleRPC(Context &ctx) {
 	Error err = dispatcher_.handle(ctx);
 
-	if (!respSent_) {
+	if (!ctx.respSent) {
 		responceRPC(ctx, err, Args());
 	}
 }
 
+void ServerConnection::enqueueRPC(const CProtoHeader &hdr, string_view data) {
+	std::unique_ptr<PendingCall> pc(new PendingCall);
+	pc->call.cmd = CmdCode(hdr.cmd);
+	pc->call.seq = hdr.seq;
+	pc->data.reset(new char[data.size()]);
+	memcpy(pc->data.get(), data.data(), data.size());
+	Serializer ser(pc->data.get(), data.size());
+	pc->call.args.Unpack(ser);
+
+	std::lock_guard<std::mutex> lck(callsLock_);
+	calls_.push_back(std::move(pc));
+	scheduleRPC();
+}
+
+// Must be called with locked callsLock_
+void ServerConnection::scheduleRPC() {
+	while (!calls_.empty() && !runningExclusive_) {
+		bool concurrent = dispatcher_.isConcurrent(calls_.front()->call.cmd);
+		if (!concurrent && running_) break;
+
+		std::shared_ptr<PendingCall> pc(std::move(calls_.front()));
+		calls_.pop_front();
+		running_++;
+		runningExclusive_ = !concurrent;
+		workers_->Post([this, pc]() { execRPC(*pc); });
+	}
+}
+
+void ServerConnection::execRPC(PendingCall &pc) {
+	Context ctx;
+	ctx.call = &pc.call;
+	ctx.writer = this;
+	ctx.stat = pc.stat;
+	ctx.stat.SetWaitTime((Stat() - pc.stat).GetTimeElapsed());
+
+	try {
+		handleRPC(ctx);
+	} catch (const Error &err) {
+		if (!ctx.respSent) responceRPC(ctx, err, Args());
+	}
+
+	std::lock_guard<std::mutex> lck(callsLock_);
+	running_--;
+	runningExclusive_ = false;
+	if (!closed_) {
+		scheduleRPC();
+	} else if (!running_) {
+		clientData_.reset();
+	}
+	callsCond_.notify_all();
+}
+
 void ServerConnection::onRead() {
 	CProtoHeader hdr;
 
@@ -70,7 +161,12 @@ void ServerConnection::onRead() {
 
 		if (len < sizeof(hdr)) return;
 		if (hdr.magic != kCprotoMagic || hdr.version != kCprotoVersion) {
-			responceRPC(ctx, Error(errParams, "Invalid cproto header: magic=%08x or version=%08x", hdr.magic, hdr.version), Args());
+			responceRPC(ctx, Error(errParams, "Invalid cproto header: magic=%08x or version=%04x", hdr.magic, hdr.version), Args());
+			closeConn_ = true;
+			return;
+		}
+		if (hdr.len > kCprotoMaxFrameSize) {
+			responceRPC(ctx, Error(errParams, "Too large cproto frame: len=%u", hdr.len), Args());
 			closeConn_ = true;
 			return;
 		}
@@ -95,9 +191,23 @@ void ServerConnection::onRead() {
 		try {
 			call.cmd = CmdCode(hdr.cmd);
 			call.seq = hdr.seq;
-			Serializer ser(it.data, hdr.len);
-			call.args.Unpack(ser);
-			handleRPC(ctx);
+			string_view data(it.data, hdr.len);
+			if (hdr.flags & kCprotoCompressedFlag) {
+				if (!enableCompression_) {
+					throw Error(errParams, "Compressed cproto frame before compression was negotiated at login");
+				}
+				if (!UncompressFrame(data, uncompressed_)) {
+					throw Error(errParams, "Invalid compressed cproto frame");
+				}
+				data = uncompressed_;
+			}
+			if (workers_) {
+				enqueueRPC(hdr, data);
+			} else {
+				Serializer ser(data.data(), data.size());
+				call.args.Unpack(ser);
+				handleRPC(ctx);
+			}
 		} catch (const Error &err) {
 			// Execption occurs on unrecoverble error. Send responce, and drop connection
 			fprintf(stderr, "drop connect, reason: %s\n", err.what().c_str());
@@ -105,14 +215,17 @@ void ServerConnection::onRead() {
 			closeConn_ = true;
 		}
 
-		respSent_ = false;
 		rdBuf_.erase(hdr.len);
 		timeout_.start(kCProtoTimeoutSec);
 	}
 }
 
+static bool loginRequestsCompression(const Args &args) {
+	return args.size() > 3 && args[3].Type() == KeyValueString && string_view(args[3]) == string_view(kCprotoCompressionSnappy);
+}
+
 void ServerConnection::responceRPC(Context &ctx, const Error &status, const Args &args) {
-	if (respSent_) {
+	if (ctx.respSent) {
 		fprintf(stderr, "Warning - RPC responce already sent\n");
 		return;
 	}
@@ -126,20 +239,45 @@ void ServerConnection::responceRPC(Context &ctx, const Error &status, const Args
 
 	args.Pack(ser);
 
+	string_view data(reinterpret_cast<char *>(ser.Buf()), ser.Len());
+	std::string compressed;
 	CProtoHeader hdr;
-	hdr.len = ser.Len();
 	hdr.magic = kCprotoMagic;
 	hdr.version = kCprotoVersion;
+	hdr.flags = 0;
+	if (enableCompression_ && data.size() >= kCprotoMinCompressSize && CompressFrame(data, compressed)) {
+		data = compressed;
+		hdr.flags |= kCprotoCompressedFlag;
+	}
+	hdr.len = data.size();
 	if (ctx.call != nullptr) {
 		hdr.cmd = ctx.call->cmd;
 		hdr.seq = ctx.call->seq;
+		if (ctx.call->cmd == kCmdLogin && status.ok() && loginRequestsCompression(ctx.call->args)) {
+			// Login responce itself is not compressed. Client compresses it's frames after it has seen support flag
+			hdr.flags |= kCprotoCompressionSupportFlag;
+			enableCompression_ = true;
+		}
 	} else {
 		hdr.cmd = 0;
 		hdr.seq = 0;
 	}
+	ctx.respSent = true;
+
+	if (workers_) {
+		std::lock_guard<std::mutex> lck(callsLock_);
+		if (closed_) return;
+		wrBufLock_.lock();
+		wrBuf_.write(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+		wrBuf_.write(data.data(), data.size());
+		wrBufLock_.unlock();
+		// Responce is written by worker thread, so wake up connection's loop to send it
+		async_.send();
+		return;
+	}
+
 	wrBuf_.write(reinterpret_cast<char *>(&hdr), sizeof(hdr));
-	wrBuf_.write(reinterpret_cast<char *>(ser.Buf()), ser.Len());
-	respSent_ = true;
+	wrBuf_.write(data.data(), data.size());
 	if (canWrite_) {
 		write_cb();
 	}
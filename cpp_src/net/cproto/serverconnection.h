@@ -1,9 +1,14 @@
 #pragma once
 
 #include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include "dispatcher.h"
 #include "net/connection.h"
 #include "net/iserverconnection.h"
+#include "tools/workerpool.h"
 
 namespace reindexer {
 namespace net {
@@ -11,35 +16,64 @@ namespace cproto {
 
 using reindexer::h_vector;
 
-class ServerConnection : public ConnectionST, public IServerConnection, public Writer {
+class ServerConnection : public ConnectionMT, public IServerConnection, public Writer {
 public:
-	ServerConnection(int fd, ev::dynamic_loop &loop, Dispatcher &dispatcher);
+	/// Constructs connection
+	/// @param fd - file descriptor of accepted connection
+	/// @param loop - loop of listener's thread
+	/// @param dispatcher - RPC dispatcher
+	/// @param workers - pool for execution of RPC calls. If nullptr, calls will be executed in loop's thread
+	ServerConnection(int fd, ev::dynamic_loop &loop, Dispatcher &dispatcher, WorkerPool *workers = nullptr);
+	~ServerConnection();
 
 	// IServerConnection interface implementation
-	static ConnectionFactory NewFactory(Dispatcher &dispatcher) {
-		return [&dispatcher](ev::dynamic_loop &loop, int fd) { return new ServerConnection(fd, loop, dispatcher); };
+	static ConnectionFactory NewFactory(Dispatcher &dispatcher, WorkerPool *workers = nullptr) {
+		return [&dispatcher, workers](ev::dynamic_loop &loop, int fd) { return new ServerConnection(fd, loop, dispatcher, workers); };
 	};
 
-	bool IsFinished() override final { return !sock_.valid(); }
+	bool IsFinished() override final;
 	bool Restart(int fd) override final;
 	void Detach() override final;
 	void Attach(ev::dynamic_loop &loop) override final;
 
 	// Writer iterface implementation
 	void WriteRPCReturn(Context &ctx, const Args &args) override final { responceRPC(ctx, errOK, args); }
-	void SetClientData(ClientData::Ptr data) override final { clientData_ = data; }
-	ClientData::Ptr GetClientData() override final { return clientData_; }
+	void SetClientData(ClientData::Ptr data) override final;
+	ClientData::Ptr GetClientData() override final;
 
 protected:
+	// RPC call, waiting for execution on worker pool
+	struct PendingCall {
+		RPCCall call;
+		// Args of call are referencing this buffer
+		std::unique_ptr<char[]> data;
+		Stat stat;
+	};
+
 	void onRead() override;
 	void onClose() override;
 	void handleRPC(Context &ctx);
 	void responceRPC(Context &ctx, const Error &error, const Args &args);
-
-	bool respSent_ = false;
+	void enqueueRPC(const CProtoHeader &hdr, string_view data);
+	void scheduleRPC();
+	void execRPC(PendingCall &pc);
 
 	Dispatcher &dispatcher_;
 	ClientData::Ptr clientData_;
+
+	WorkerPool *workers_;
+	// Protects calls queue, client data and state of connection, shared with workers
+	std::mutex callsLock_;
+	std::condition_variable callsCond_;
+	std::deque<std::unique_ptr<PendingCall>> calls_;
+	int running_ = 0;
+	bool runningExclusive_ = false;
+	bool closed_ = false;
+
+	// Buffer for uncompressed payload of incoming frame
+	std::string uncompressed_;
+	// Compression was negotiated at login, so frames may be compressed in both directions. Responces are written by workers
+	std::atomic<bool> enableCompression_{false};
 };
 }  // namespace cproto
 }  // namespace net
@@ -123,6 +123,10 @@ public:
 	virtual bool SetRespCode(int code) = 0;
 	virtual bool SetContentLength(size_t len) = 0;
 	virtual bool SetConnectionClose() = 0;
+	// Function, which writes next part of response body. Returns false, when whole body is written
+	typedef std::function<bool(Writer &writer)> StreamFunc;
+	// Rest of response body is written by stream after return of handler, when previously written data was sent to client
+	virtual bool SetStream(StreamFunc stream) = 0;
 
 	virtual int RespCode() = 0;
 	virtual int Written() = 0;
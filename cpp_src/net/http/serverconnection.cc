@@ -23,6 +23,7 @@ bool ServerConnection::Restart(int fd) {
 	formData_ = false;
 	enableHttp11_ = false;
 	expectContinue_ = false;
+	streamWriter_.reset();
 	callback(io_, ev::READ);
 	return true;
 }
@@ -34,7 +35,7 @@ void ServerConnection::Detach() {
 	if (attached_) detach();
 }
 
-void ServerConnection::onClose() {}
+void ServerConnection::onClose() { streamWriter_.reset(); }
 
 void ServerConnection::handleRequest(Request &req) {
 	ResponseWriter writer(this);
@@ -49,19 +50,47 @@ void ServerConnection::handleRequest(Request &req) {
 	try {
 		router_.handle(ctx);
 	} catch (const HttpStatus &status) {
+		writer.stream_ = nullptr;
 		if (!writer.IsRespSent()) {
 			ctx.String(status.code, status.what);
 		}
 	} catch (const Error &status) {
+		writer.stream_ = nullptr;
 		if (!writer.IsRespSent()) {
 			ctx.String(StatusInternalServerError, status.what());
 		}
 	}
 	router_.log(ctx);
 
+	if (writer.stream_) {
+		// Rest of response will be written by onWrite, when loop sends already written data to client
+		streamWriter_.reset(new ResponseWriter(std::move(writer)));
+		return;
+	}
 	ctx.writer->Write(0, 0);
 }
 
+// Continue streamed response, until write buffer is filled. Handler is not waiting for client, so loop's thread is never blocked
+void ServerConnection::onWrite() {
+	while (streamWriter_ && wrBuf_.size() < kHttpMaxPendingWrite) {
+		bool more = false;
+		try {
+			more = streamWriter_->stream_(*streamWriter_);
+		} catch (const Error &) {
+			// Response is already started, so error can be reported only by broken response
+			streamWriter_.reset();
+			closeConn();
+			return;
+		}
+		if (!more) {
+			streamWriter_->Write(0, 0);
+			streamWriter_.reset();
+			// Handle requests, which were received while response was streamed
+			if (rdBuf_.size()) onRead();
+		}
+	}
+}
+
 void ServerConnection::badRequest(int code, const char *msg) {
 	ResponseWriter writer(this);
 	Stat stat;
@@ -126,7 +155,7 @@ void ServerConnection::onRead() {
 	int minor_version = 0;
 	struct phr_header headers[kHttpMaxHeaders];
 
-	while (rdBuf_.size()) {
+	while (rdBuf_.size() && !streamWriter_) {
 		if (!bodyLeft_) {
 			auto it = rdBuf_.tail();
 
@@ -276,26 +305,42 @@ ssize_t ServerConnection::ResponseWriter::Write(const void *buf, size_t size) {
 	}
 
 	if (isChunkedResponse()) {
-		int n = u32toax(size, tmpBuf) - tmpBuf;
-		conn_->wrBuf_.write(tmpBuf, n);
-		conn_->wrBuf_.write(kStrEOL, sizeof(kStrEOL) - 1);
+		// Empty write is the end of response
+		const char *data = reinterpret_cast<const char *>(buf);
+		chunk_.insert(chunk_.end(), data, data + size);
+		if (chunk_.size() >= kHttpChunkSize || (!size && chunk_.size())) {
+			writeChunk(chunk_.data(), chunk_.size());
+			chunk_.clear();
+		}
+		if (!size) writeChunk(nullptr, 0);
+	} else {
+		conn_->wrBuf_.write(reinterpret_cast<const char *>(buf), size);
 	}
-
-	conn_->wrBuf_.write(reinterpret_cast<const char *>(buf), size);
 	written_ += size;
-	if (isChunkedResponse()) {
-		conn_->wrBuf_.write(kStrEOL, sizeof(kStrEOL) - 1);
-	}
 	if (!size && !conn_->enableHttp11_) {
 		conn_->closeConn_ = true;
 	}
 	return size;
 }
+
+void ServerConnection::ResponseWriter::writeChunk(const char *data, size_t size) {
+	char tmpBuf[32];
+	int n = u32toax(size, tmpBuf) - tmpBuf;
+	conn_->wrBuf_.write(tmpBuf, n);
+	conn_->wrBuf_.write(kStrEOL, sizeof(kStrEOL) - 1);
+	conn_->wrBuf_.write(data, size);
+	conn_->wrBuf_.write(kStrEOL, sizeof(kStrEOL) - 1);
+}
 bool ServerConnection::ResponseWriter::SetConnectionClose() {
 	conn_->closeConn_ = true;
 	return true;
 }
 
+bool ServerConnection::ResponseWriter::SetStream(StreamFunc stream) {
+	stream_ = std::move(stream);
+	return true;
+}
+
 ssize_t ServerConnection::BodyReader::Read(void *buf, size_t size) {
 	size_t readed = conn_->rdBuf_.read(reinterpret_cast<char *>(buf), std::min(ssize_t(size), conn_->bodyLeft_));
 	conn_->bodyLeft_ -= readed;
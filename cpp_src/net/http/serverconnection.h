@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string.h>
+#include <memory>
 #include "estl/h_vector.h"
 #include "net/connection.h"
 #include "net/iserverconnection.h"
@@ -16,6 +17,11 @@ using reindexer::h_vector;
 
 const ssize_t kHttpMaxHeaders = 128;
 const ssize_t kHttpMaxBodySize = 2 * 1024 * 1024LL;
+// Small writes of chunked response are collected to chunks of this size
+const size_t kHttpChunkSize = 0x4000;
+// Stream of response is called, while size of unsent response data is less than this size
+const size_t kHttpMaxPendingWrite = 0x40000;
+
 class ServerConnection : public IServerConnection, public ConnectionST {
 public:
 	ServerConnection(int fd, ev::dynamic_loop &loop, Router &router);
@@ -47,6 +53,7 @@ protected:
 		virtual bool SetRespCode(int code) override final;
 		virtual bool SetContentLength(size_t len) override final;
 		virtual bool SetConnectionClose() override final;
+		virtual bool SetStream(StreamFunc stream) override final;
 		ssize_t Write(const void *buf, size_t size) override final;
 		template <int N>
 		ssize_t Write(const char (&str)[N]) {
@@ -58,18 +65,23 @@ protected:
 
 	protected:
 		bool isChunkedResponse() { return contentLength_ == -1; }
+		void writeChunk(const char *data, size_t size);
 
 		int code_ = StatusOK;
 		h_vector<char, 0x200> headers_;
+		h_vector<char, 0x100> chunk_;
 		bool respSend_ = false;
 		ssize_t contentLength_ = -1, written_ = 0;
 		ServerConnection *conn_;
+		StreamFunc stream_;
+		friend class ServerConnection;
 	};
 
 	void handleRequest(Request &req);
 	void badRequest(int code, const char *msg);
 	void onRead() override;
 	void onClose() override;
+	void onWrite() override;
 
 	void parseParams(const string_view &str);
 	void writeHttpResponse(int code);
@@ -81,6 +93,8 @@ protected:
 	bool enableHttp11_ = false;
 	bool expectContinue_ = false;
 	phr_chunked_decoder chunked_decoder_;
+	// Writer of streamed response. Next requests are not handled, until stream is done
+	std::unique_ptr<ResponseWriter> streamWriter_;
 	// cbuf<char> tmpBuf_;
 };
 }  // namespace http
@@ -7,6 +7,7 @@ namespace reindexer {
 Stat::Stat() {
 	tmpoint_ = std::chrono::high_resolution_clock::now();
 	time_us_ = 0;
+	wait_us_ = 0;
 	allocs_cnt_ = get_alloc_cnt_total();
 	allocs_bytes_ = get_alloc_size_total();
 }
@@ -16,12 +16,17 @@ public:
 	uint64_t GetTimeElapsed() { return time_us_; }
 	size_t GetAllocsCnt() { return allocs_cnt_; }
 	size_t GetAllocsBytes() { return allocs_bytes_; }
+	// Time, which call has been waiting in queue before execution
+	uint64_t GetWaitTime() { return wait_us_; }
+	void SetWaitTime(uint64_t us) { wait_us_ = us; }
 
 private:
 	std::chrono::high_resolution_clock::time_point tmpoint_;
 
 	uint64_t time_us_;
+	uint64_t wait_us_;
 	size_t allocs_cnt_;
 	size_t allocs_bytes_;
 };
+
 }  // namespace reindexer
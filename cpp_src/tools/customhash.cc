@@ -61,7 +61,8 @@ uint32_t _Hash_bytes_collate_ascii(const void* ptr, uint32_t len) {
 	// Mix 4 bytes at a time into the hash.
 	while (len >= 4) {
 		uint32_t k = unaligned_load(buf);
-		k |= 0x40404040;
+		// Set case bit of letters, so strings, which are equal by ASCII collation, have equal hashes
+		k |= 0x20202020;
 
 		k *= m;
 		k ^= k >> 24;
@@ -74,13 +75,13 @@ uint32_t _Hash_bytes_collate_ascii(const void* ptr, uint32_t len) {
 
 	// Handle the last few bytes of the input array.
 	if (len >= 3) {
-		hash ^= static_cast<unsigned char>(buf[2] | 0x40) << 16;
+		hash ^= static_cast<unsigned char>(buf[2] | 0x20) << 16;
 	}
 	if (len >= 2) {
-		hash ^= static_cast<unsigned char>(buf[1] | 0x40) << 8;
+		hash ^= static_cast<unsigned char>(buf[1] | 0x20) << 8;
 	}
 	if (len >= 1) {
-		hash ^= static_cast<unsigned char>(buf[0] | 0x40);
+		hash ^= static_cast<unsigned char>(buf[0] | 0x20);
 		hash *= m;
 	}
 
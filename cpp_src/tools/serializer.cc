@@ -133,6 +133,12 @@ void WrSerializer::PutValue(const KeyValue &kv) {
 	}
 }
 
+void WrSerializer::Write(const string_view &slice) {
+	grow(slice.size());
+	memcpy(&buf_[len_], slice.data(), slice.size());
+	len_ += slice.size();
+}
+
 void WrSerializer::PutSlice(const string_view &slice) {
 	PutUInt32(slice.size());
 	grow(slice.size());
@@ -79,6 +79,7 @@ public:
 	void PutSlice(const string_view &slice);
 
 	// Put raw data
+	void Write(const string_view &slice);
 	void PutUInt32(uint32_t);
 
 	void PutUInt64(uint64_t);
@@ -110,6 +111,7 @@ public:
 	// Buffer manipulation functions
 	uint8_t *DetachBuffer();
 	uint8_t *Buf() const;
+	size_t Cap() const { return cap_; }
 	void Reset() { len_ = 0; }
 	size_t Len() const { return len_; }
 	void Reserve(size_t cap);
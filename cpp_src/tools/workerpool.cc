@@ -0,0 +1,57 @@
+#include "workerpool.h"
+#include <algorithm>
+
+namespace reindexer {
+
+WorkerPool::WorkerPool(int threads) {
+	if (threads <= 0) threads = std::max(int(std::thread::hardware_concurrency()), 1);
+	for (int i = 0; i < threads; i++) threads_.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool() { Stop(); }
+
+void WorkerPool::Post(Task task) {
+	std::unique_lock<std::mutex> lck(mtx_);
+	queue_.push_back({std::move(task), std::chrono::steady_clock::now()});
+	stat_.queueDepth = queue_.size();
+	if (stat_.queueDepth > stat_.maxQueueDepth) stat_.maxQueueDepth = stat_.queueDepth;
+	lck.unlock();
+	cond_.notify_one();
+}
+
+void WorkerPool::Stop() {
+	std::unique_lock<std::mutex> lck(mtx_);
+	terminating_ = true;
+	lck.unlock();
+	cond_.notify_all();
+	for (auto &th : threads_) th.join();
+	threads_.clear();
+}
+
+QueueStat WorkerPool::GetStat() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	return stat_;
+}
+
+void WorkerPool::run() {
+	std::unique_lock<std::mutex> lck(mtx_);
+	for (;;) {
+		cond_.wait(lck, [this]() { return terminating_ || !queue_.empty(); });
+		if (queue_.empty()) return;
+
+		queuedTask qt = std::move(queue_.front());
+		queue_.pop_front();
+
+		uint64_t waitUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - qt.ts).count();
+		stat_.queueDepth = queue_.size();
+		stat_.tasksCount++;
+		stat_.waitTimeUs += waitUs;
+		if (waitUs > stat_.maxWaitTimeUs) stat_.maxWaitTimeUs = waitUs;
+
+		lck.unlock();
+		qt.task();
+		lck.lock();
+	}
+}
+
+}  // namespace reindexer
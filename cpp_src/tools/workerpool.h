@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reindexer {
+
+// Statistics of worker's tasks queue
+struct QueueStat {
+	// Current number of tasks in queue
+	size_t queueDepth = 0;
+	// Max number of tasks in queue
+	size_t maxQueueDepth = 0;
+	// Total number of executed tasks
+	size_t tasksCount = 0;
+	// Total and max time, spent by tasks in queue
+	uint64_t waitTimeUs = 0;
+	uint64_t maxWaitTimeUs = 0;
+};
+
+/// Fixed size pool of threads, which executes posted tasks
+class WorkerPool {
+public:
+	typedef std::function<void()> Task;
+
+	/// Constructs pool and starts worker threads
+	/// @param threads - Number of worker threads. std::thread::hardware_concurrency() by default
+	WorkerPool(int threads = 0);
+	~WorkerPool();
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	/// Post task to queue. Task will be executed by one of worker threads
+	/// @param task - task to execute
+	void Post(Task task);
+	/// Stop synchroniusly waits for all posted tasks and stops worker threads
+	void Stop();
+	/// Get statistics of tasks queue
+	QueueStat GetStat();
+
+protected:
+	void run();
+
+	struct queuedTask {
+		Task task;
+		std::chrono::steady_clock::time_point ts;
+	};
+
+	std::deque<queuedTask> queue_;
+	std::vector<std::thread> threads_;
+	std::mutex mtx_;
+	std::condition_variable cond_;
+	bool terminating_ = false;
+	QueueStat stat_;
+};
+
+}  // namespace reindexer
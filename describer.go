@@ -78,6 +78,18 @@ type NamespaceMemStat struct {
 		IndexesSize int `json:"indexes_size"`
 		CacheSize   int `json:"cache_size"`
 	}
+	// Memory usage of tuples of non indexed fields
+	Tuples TuplesMemStat `json:"tuples"`
+}
+
+// TuplesMemStat - memory usage of tuples of non indexed fields, which can be compressed by dictionary of frequent strings
+type TuplesMemStat struct {
+	Compressed       bool  `json:"compressed"`
+	DictStringsCount int64 `json:"dict_strings_count"`
+	DictSize         int64 `json:"dict_size"`
+	// Total size of tuples, and their size without compression
+	TuplesSize             int64 `json:"tuples_size"`
+	UncompressedTuplesSize int64 `json:"uncompressed_tuples_size"`
 }
 type PerfStat struct {
 	TotalQueriesCount    int64 `json:"total_queries_count"`
@@ -86,12 +98,43 @@ type PerfStat struct {
 	LastSecQPS           int64 `json:"last_sec_qps"`
 	LastSecAvgLatencyUs  int64 `json:"last_sec_avg_latency_us"`
 	LastSecAvgLockTimeUs int64 `json:"last_sec_avg_lock_time_us"`
+	// Percentiles of latency
+	Latency LatencyStat `json:"latency"`
+	// Percentiles of time of waiting for namespace locks
+	LockTime LatencyStat `json:"lock_time"`
+}
+
+// LatencyStat - percentiles of latency, measured by histogram with relative error below 12.5%
+type LatencyStat struct {
+	P50Us  int64 `json:"p50_us"`
+	P90Us  int64 `json:"p90_us"`
+	P99Us  int64 `json:"p99_us"`
+	P999Us int64 `json:"p999_us"`
+	MaxUs  int64 `json:"max_us"`
+}
+
+// SelectPhasesPerfStat - latencies of phases of selects
+type SelectPhasesPerfStat struct {
+	// Preparation of query and evaluation of query plan
+	Prepare LatencyStat `json:"prepare"`
+	// Selection of idsets from indexes
+	Indexes LatencyStat `json:"indexes"`
+	// Postprocessing of idsets and preparation of joins
+	Postprocess LatencyStat `json:"postprocess"`
+	// Iteration over ids and check of conditions
+	Loop LatencyStat `json:"loop"`
 }
 
 type NamespacePerfStat struct {
 	Name    string   `json:"name"`
 	Updates PerfStat `json:"updates"`
 	Selects PerfStat `json:"selects"`
+	// Storage flushes stats. Lock time is time of holding namespace lock by flush
+	StorageFlushes PerfStat `json:"storage_flushes"`
+	// Latencies of phases of selects
+	SelectPhases SelectPhasesPerfStat `json:"select_phases"`
+	// Count of updates, which are not written to storage yet
+	StorageBacklog int64 `json:"storage_backlog"`
 }
 
 type QueryPerfStat struct {
@@ -103,6 +146,7 @@ type DBConfigItem struct {
 	Type       string                `json:"type"`
 	Profiling  *DBProfilingConfig    `json:"profiling,omitempty"`
 	LogQueries *[]DBLogQueriesConfig `json:"log_queries,omitempty"`
+	Namespaces *[]DBNamespacesConfig `json:"namespaces,omitempty"`
 }
 
 type DBProfilingConfig struct {
@@ -117,6 +161,13 @@ type DBLogQueriesConfig struct {
 	LogLevel  string `json:"log_level"`
 }
 
+// DBNamespacesConfig - options of namespace. Namespace "*" sets defaults for all namespaces
+type DBNamespacesConfig struct {
+	Namespace string `json:"namespace"`
+	// Compress tuples of non indexed fields by dictionary of frequent strings
+	CompressTuples bool `json:"compress_tuples"`
+}
+
 // DescribeNamespaces makes a 'SELECT * FROM #namespaces' query to database.
 // Return NamespaceDescription results, error
 func (db *Reindexer) DescribeNamespaces() ([]*NamespaceDescription, error) {
@@ -1,6 +1,7 @@
 package reindexer
 
 import (
+	"encoding/json"
 	"fmt"
 	"reflect"
 
@@ -83,7 +84,9 @@ type Iterator struct {
 func (it *Iterator) setBuffer(result bindings.RawBuffer) {
 	it.ser = newSerializer(result.GetBuf())
 	it.result = result
-	it.rawQueryParams = it.ser.readRawQueryParams(func(nsid int) {
+	// Plan of query is returned for explained queries and for SQL queries, which may be explained
+	withExplain := it.query == nil || it.query.explain
+	it.rawQueryParams = it.ser.readRawQueryParams(withExplain, func(nsid int) {
 		it.nsArray[nsid].localCjsonState = it.nsArray[nsid].cjsonState.ReadPayloadType(&it.ser.Serializer)
 	})
 }
@@ -300,17 +303,87 @@ func (it *Iterator) HasRank() bool {
 	return it.rawQueryParams.haveProcent
 }
 
+// AggregationFacet is value of field with count of items, which have this value
+type AggregationFacet struct {
+	Value string `json:"value"`
+	Count int    `json:"count"`
+}
+
+// AggregationResult is result of aggregation of field. Facets are set for AggFacet, and Value for other aggregations
+type AggregationResult struct {
+	Field  string             `json:"field"`
+	Type   string             `json:"type"`
+	Value  float64            `json:"value"`
+	Facets []AggregationFacet `json:"facets"`
+}
+
 // AggResults returns aggregation results (if present)
-func (it *Iterator) AggResults() []float64 {
+func (it *Iterator) AggResults() []AggregationResult {
 	return it.rawQueryParams.aggResults
 }
 
-// GetAggreatedValue - Return aggregation sum of field
+// GetAggreatedValue - Return aggregation value of field
 func (it *Iterator) GetAggreatedValue(idx int) float64 {
 	if idx < 0 || idx >= len(it.rawQueryParams.aggResults) {
 		return 0
 	}
-	return it.rawQueryParams.aggResults[idx]
+	return it.rawQueryParams.aggResults[idx].Value
+}
+
+// ExplainCondition is condition of query with estimated count of matched items
+type ExplainCondition struct {
+	Condition string  `json:"condition"`
+	Estimated float64 `json:"estimated"`
+	Method    string  `json:"method"`
+	Driver    bool    `json:"driver"`
+}
+
+// ExplainSelector is iterator of items, which was used by select loop
+type ExplainSelector struct {
+	Name          string  `json:"name"`
+	Idsets        int     `json:"idsets"`
+	Comparators   int     `json:"comparators"`
+	MaxIterations int     `json:"max_iterations"`
+	Cost          float64 `json:"cost"`
+	Matched       int     `json:"matched"`
+}
+
+// ExplainJoin is joined query in order of execution
+type ExplainJoin struct {
+	Namespace string  `json:"namespace"`
+	Type      string  `json:"type"`
+	Cost      float64 `json:"cost"`
+	Called    int     `json:"called"`
+	Matched   int     `json:"matched"`
+}
+
+// ExplainResults is plan of query execution with timings of select stages
+type ExplainResults struct {
+	PrepareUs      int                `json:"prepare_us"`
+	IndexesUs      int                `json:"indexes_us"`
+	PostprocessUs  int                `json:"postprocess_us"`
+	LoopUs         int                `json:"loop_us"`
+	SortIndex      string             `json:"sort_index"`
+	SortByIndex    bool               `json:"sort_by_index"`
+	EstimatedItems float64            `json:"estimated_items"`
+	Conditions     []ExplainCondition `json:"conditions"`
+	Selectors      []ExplainSelector  `json:"selectors"`
+	Joins          []ExplainJoin      `json:"joins"`
+}
+
+// GetExplainResults returns plan of query execution, if query was called with Explain
+func (it *Iterator) GetExplainResults() (*ExplainResults, error) {
+	if it.err != nil {
+		return nil, it.err
+	}
+	if len(it.rawQueryParams.explainResults) == 0 {
+		return nil, nil
+	}
+	explain := &ExplainResults{}
+	if err := json.Unmarshal(it.rawQueryParams.explainResults, explain); err != nil {
+		return nil, err
+	}
+	return explain, nil
 }
 
 // Error returns query error if it's present.
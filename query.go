@@ -12,18 +12,21 @@ import (
 
 // Constants for query serialization
 const (
-	queryCondition      = bindings.QueryCondition
-	queryDistinct       = bindings.QueryDistinct
-	querySortIndex      = bindings.QuerySortIndex
-	queryJoinOn         = bindings.QueryJoinOn
-	queryLimit          = bindings.QueryLimit
-	queryOffset         = bindings.QueryOffset
-	queryReqTotal       = bindings.QueryReqTotal
-	queryDebugLevel     = bindings.QueryDebugLevel
-	queryAggregation    = bindings.QueryAggregation
-	querySelectFilter   = bindings.QuerySelectFilter
-	QuerySelectFunction = bindings.QuerySelectFunction
-	queryEnd            = bindings.QueryEnd
+	queryCondition        = bindings.QueryCondition
+	queryDistinct         = bindings.QueryDistinct
+	querySortIndex        = bindings.QuerySortIndex
+	queryJoinOn           = bindings.QueryJoinOn
+	queryLimit            = bindings.QueryLimit
+	queryOffset           = bindings.QueryOffset
+	queryReqTotal         = bindings.QueryReqTotal
+	queryDebugLevel       = bindings.QueryDebugLevel
+	queryAggregation      = bindings.QueryAggregation
+	querySelectFilter     = bindings.QuerySelectFilter
+	QuerySelectFunction   = bindings.QuerySelectFunction
+	queryEnd              = bindings.QueryEnd
+	queryParallelism      = bindings.QueryParallelism
+	queryAggregationLimit = bindings.QueryAggregationLimit
+	queryExplain          = bindings.QueryExplain
 )
 
 // Constants for calc total
@@ -90,6 +93,7 @@ type Query struct {
 	totalName     string
 	executed      bool
 	fetchCount    int
+	explain       bool
 }
 
 var queryPool sync.Pool
@@ -117,6 +121,7 @@ func newQuery(db *Reindexer, namespace string) *Query {
 		q.closed = false
 		q.totalName = ""
 		q.executed = false
+		q.explain = false
 		q.nsArray = q.nsArray[:0]
 	}
 
@@ -282,12 +287,21 @@ func (q *Query) WhereDouble(index string, condition int, keys ...float64) *Query
 }
 
 // Aggregate - Return aggregation of field
+// Facet, min, max and count distinct aggregations are calculated from keys of index
 func (q *Query) Aggregate(index string, aggType int) *Query {
 
 	q.ser.PutVarCUInt(queryAggregation).PutVString(index).PutVarCUInt(aggType)
 	return q
 }
 
+// AggregateFacet - Return limit most frequent values of field with their counts
+func (q *Query) AggregateFacet(index string, limit int) *Query {
+
+	q.Aggregate(index, AggFacet)
+	q.ser.PutVarCUInt(queryAggregationLimit).PutVarCUInt(limit)
+	return q
+}
+
 // Sort - Apply sort order to returned from query items
 // If values argument specified, then items equal to values, if found will be placed in the top positions
 // For composite indexes values must be []interface{}, with value of each subindex
@@ -372,6 +386,19 @@ func (q *Query) Debug(level int) *Query {
 	return q
 }
 
+// Explain - Request plan of query execution. Plan is returned by Iterator.GetExplainResults
+func (q *Query) Explain() *Query {
+	q.ser.PutVarCUInt(queryExplain)
+	q.explain = true
+	return q
+}
+
+// Parallel - Set max number of threads to execute query. 0 - use default from config, 1 - disable parallel execution
+func (q *Query) Parallel(threads int) *Query {
+	q.ser.PutVarCUInt(queryParallelism).PutVarCUInt(threads)
+	return q
+}
+
 // SetContext set interface, which will be passed to Joined interface
 func (q *Query) SetContext(ctx interface{}) *Query {
 	q.context = ctx
@@ -55,8 +55,12 @@ const (
 )
 
 const (
-	AggAvg = bindings.AggAvg
-	AggSum = bindings.AggSum
+	AggAvg           = bindings.AggAvg
+	AggSum           = bindings.AggSum
+	AggFacet         = bindings.AggFacet
+	AggMin           = bindings.AggMin
+	AggMax           = bindings.AggMax
+	AggCountDistinct = bindings.AggCountDistinct
 )
 
 var logger Logger = &nullLogger{}
@@ -445,7 +449,7 @@ func (db *Reindexer) Query(namespace string) *Query {
 	return newQuery(db, namespace)
 }
 
-// ExecSQL make query to database. Query is SQL statement
+// ExecSQL make query to database. Query is SQL statement: SELECT, or UPDATE of indexed fields
 // Return Iterator
 func (db *Reindexer) ExecSQL(query string) *Iterator {
 	// TODO: do not parse query string twice in go and cpp
@@ -453,7 +457,7 @@ func (db *Reindexer) ExecSQL(query string) *Iterator {
 	querySlice := strings.Fields(strings.ToLower(query))
 
 	for i := range querySlice {
-		if querySlice[i] == "from" && i+1 < len(querySlice) {
+		if (querySlice[i] == "from" || (i == 0 && querySlice[i] == "update")) && i+1 < len(querySlice) {
 			namespace = querySlice[i+1]
 			break
 		}
@@ -468,7 +472,7 @@ func (db *Reindexer) ExecSQLToJSON(query string) *JSONIterator {
 	querySlice := strings.Fields(strings.ToLower(query))
 
 	for i := range querySlice {
-		if querySlice[i] == "from" && i+1 < len(querySlice) {
+		if (querySlice[i] == "from" || (i == 0 && querySlice[i] == "update")) && i+1 < len(querySlice) {
 			namespace = querySlice[i+1]
 			break
 		}
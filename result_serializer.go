@@ -1,6 +1,7 @@
 package reindexer
 
 import (
+	"encoding/json"
 	"fmt"
 
 	"github.com/restream/reindexer/bindings"
@@ -23,7 +24,8 @@ type rawResultQueryParams struct {
 	haveProcent      bool
 	nonCacheableData bool
 	nsCount          int
-	aggResults       []float64
+	aggResults       []AggregationResult
+	explainResults   []byte
 }
 
 type resultSerializer struct {
@@ -60,7 +62,7 @@ func (s *resultSerializer) readSimpleRawItemParams() (v rawResultItemParams) {
 	v.version = int(s.GetVarUInt())
 	return v
 }
-func (s *resultSerializer) readRawQueryParams(updatePayloadType ...updatePayloadTypeFunc) (v rawResultQueryParams) {
+func (s *resultSerializer) readRawQueryParams(withExplain bool, updatePayloadType ...updatePayloadTypeFunc) (v rawResultQueryParams) {
 	s.haveCPtr = s.GetUInt64() != 0
 	v.totalcount = int(s.GetVarUInt())
 	v.qcount = int(s.GetVarUInt())
@@ -79,20 +81,27 @@ func (s *resultSerializer) readRawQueryParams(updatePayloadType ...updatePayload
 	}
 
 	v.aggResults = s.readAggregationResults()
+	if withExplain {
+		if explain := s.GetBytes(); len(explain) != 0 {
+			v.explainResults = append([]byte(nil), explain...)
+		}
+	}
 
 	return v
 }
 
-func (s *resultSerializer) readAggregationResults() (aggResults []float64) {
+func (s *resultSerializer) readAggregationResults() (aggResults []AggregationResult) {
 	aggResCount := int(s.GetVarUInt())
 	if aggResCount == 0 {
 		return nil
 	}
 
-	aggResults = make([]float64, aggResCount)
+	aggResults = make([]AggregationResult, aggResCount)
 
 	for i := 0; i < aggResCount; i++ {
-		aggResults[i] = s.GetDouble()
+		if err := json.Unmarshal(s.GetBytes(), &aggResults[i]); err != nil {
+			panic(fmt.Errorf("Internal error: can't parse aggregation result: %s", err.Error()))
+		}
 	}
 	return
 }